@@ -14,37 +14,44 @@ void MultiPageTableModel::setTestDatas(const QVector<Data>& datas)
     beginResetModel();
     m_impl->datas = datas;
     endResetModel();
+    invalidateSortFilter();
 }
 
 int MultiPageTableModel::rowCount(const QModelIndex& parent /* = QModelIndex() */) const
 {
-    return std::min<int>(m_impl->datas.size() - offset(), pageRowCount());
+    return std::min<int>(visibleRowCount() - offset(), pageRowCount());
 }
 
 int MultiPageTableModel::columnCount(const QModelIndex& parent /* = QModelIndex() */) const { return 3; }
 
 QVariant MultiPageTableModel::data(const QModelIndex& index, int role /* = Qt::DisplayRole */) const
 {
-    auto row = offset() + index.row();
-    if (row < 0 || row >= m_impl->datas.size())
-        return {};
     if (role == Qt::DisplayRole)
-    {
-        const auto& d = m_impl->datas[row];
-        switch (index.column())
-        {
-        case 0:
-            return d.col1;
-        case 1:
-            return d.col2;
-        case 2:
-            return d.col3;
-        }
-    }
+        return dataRowValue(mapToDataRow(index.row()), index.column());
     return {};
 }
 
 int MultiPageTableModel::pageCount() const
 {
-    return m_impl->datas.size() / pageRowCount() + static_cast<bool>(m_impl->datas.size() % pageRowCount());
+    const auto rows = visibleRowCount();
+    return rows / pageRowCount() + static_cast<bool>(rows % pageRowCount());
+}
+
+int MultiPageTableModel::dataRowCount() const { return m_impl->datas.size(); }
+
+QVariant MultiPageTableModel::dataRowValue(int dataRow, int column) const
+{
+    if (dataRow < 0 || dataRow >= m_impl->datas.size())
+        return {};
+    const auto& d = m_impl->datas[dataRow];
+    switch (column)
+    {
+    case 0:
+        return d.col1;
+    case 1:
+        return d.col2;
+    case 2:
+        return d.col3;
+    }
+    return {};
 }
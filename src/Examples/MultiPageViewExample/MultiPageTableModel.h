@@ -24,6 +24,10 @@ public:
     QVariant data(const QModelIndex& index, int role /* = Qt::DisplayRole */) const override;
     int pageCount() const override;
 
+protected:
+    int dataRowCount() const override;
+    QVariant dataRowValue(int dataRow, int column) const override;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> m_impl;
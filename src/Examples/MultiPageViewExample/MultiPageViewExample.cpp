@@ -18,6 +18,7 @@ MultiPageViewExample::MultiPageViewExample()
 
     auto tableModel = new MultiPageTableModel(this);
     ui.tableView->setModel(tableModel);
+    ui.tableView->setSortingEnabled(true); // 点击表头对全部页面排序
     ui.btnBox_2->setModel(tableModel);
     QVector<Data> datas;
     for (int i = 0; i < 999; ++i)
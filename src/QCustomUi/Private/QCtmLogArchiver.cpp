@@ -0,0 +1,285 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#include "QCtmLogArchiver_p.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QThread>
+#include <QtEndian>
+
+#include <algorithm>
+
+namespace
+{
+constexpr char Magic[]          = "QCLZ";
+constexpr qint64 ChunkSize      = 1024 * 1024;
+constexpr quint32 MaxChunkBytes = 64 * 1024 * 1024; // 损坏文件保护
+} // namespace
+
+QCtmLogArchiver::QCtmLogArchiver() {}
+
+QCtmLogArchiver::~QCtmLogArchiver() { stop(); }
+
+void QCtmLogArchiver::setCompressionEnabled(bool enable)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_mutex);
+#endif
+    m_compress = enable;
+}
+
+bool QCtmLogArchiver::compressionEnabled() const
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_mutex);
+#endif
+    return m_compress;
+}
+
+void QCtmLogArchiver::setRetention(const Retention& retention)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_mutex);
+#endif
+    m_retention = retention;
+}
+
+QCtmLogArchiver::Retention QCtmLogArchiver::retention() const
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_mutex);
+#endif
+    return m_retention;
+}
+
+void QCtmLogArchiver::schedule(const QString& activeFile)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_mutex);
+#endif
+    if (m_stop.load(std::memory_order_relaxed))
+        return;
+    m_activeFile = QFileInfo(activeFile).absoluteFilePath();
+    m_pending    = true;
+    if (!m_thread)
+    {
+        m_thread = QThread::create([this] { run(); });
+        m_thread->setObjectName("QCtmLogArchiver");
+        m_thread->start(QThread::LowestPriority);
+    }
+    m_condition.wakeOne();
+}
+
+void QCtmLogArchiver::stop()
+{
+    QThread* thread;
+    {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        QMutexLocker locker(&m_mutex);
+#else
+        QMutexLocker<QMutex> locker(&m_mutex);
+#endif
+        m_stop = true;
+        thread = m_thread;
+        m_thread = nullptr;
+        m_condition.wakeOne();
+    }
+    if (thread)
+    {
+        thread->wait();
+        delete thread;
+    }
+}
+
+void QCtmLogArchiver::run()
+{
+    for (;;)
+    {
+        QString activeFile;
+        {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+            QMutexLocker locker(&m_mutex);
+#else
+            QMutexLocker<QMutex> locker(&m_mutex);
+#endif
+            while (!m_pending && !m_stop.load(std::memory_order_relaxed))
+                m_condition.wait(&m_mutex);
+            if (m_stop.load(std::memory_order_relaxed))
+                return;
+            m_pending  = false;
+            activeFile = m_activeFile;
+        }
+        sweep(activeFile);
+    }
+}
+
+void QCtmLogArchiver::sweep(const QString& activeFile)
+{
+    bool compress;
+    Retention retention;
+    {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        QMutexLocker locker(&m_mutex);
+#else
+        QMutexLocker<QMutex> locker(&m_mutex);
+#endif
+        compress  = m_compress;
+        retention = m_retention;
+    }
+
+    // 目录中按命名规则命名的日志文件, 包括之前运行时留下的文件, 文件名即创建时间, 按名称由新到旧排列
+    const QFileInfo active(activeFile);
+    const QString suffix(Suffix);
+    QFileInfoList files;
+    for (const auto& info : active.absoluteDir().entryInfoList({ "*.log", QString("*.log") + suffix }, QDir::Files))
+    {
+        if (isLogFileName(info.fileName()) && info.absoluteFilePath() != active.absoluteFilePath())
+            files.push_back(info);
+    }
+    auto baseName = [&](const QFileInfo& info)
+    {
+        const auto name = info.fileName();
+        return name.endsWith(suffix) ? name.left(name.size() - suffix.size()) : name;
+    };
+    std::sort(files.begin(), files.end(), [&](const QFileInfo& a, const QFileInfo& b) { return baseName(a) > baseName(b); });
+
+    if (compress)
+    {
+        for (auto& info : files)
+        {
+            if (m_stop.load(std::memory_order_relaxed))
+                return;
+            const auto source = info.absoluteFilePath();
+            if (source.endsWith(suffix))
+                continue;
+            const auto target = source + suffix;
+            const auto part   = target + ".part";
+            if (!compressFile(source, part, &m_stop))
+            {
+                QFile::remove(part);
+                continue;
+            }
+            QFile::remove(target);
+            if (QFile::rename(part, target))
+            {
+                QFile archive(target);
+                if (archive.open(QFile::Append)) // 保留原修改时间, 按天清理依赖该时间
+                    archive.setFileTime(info.lastModified(), QFileDevice::FileModificationTime);
+                archive.close();
+                QFile::remove(source);
+                info = QFileInfo(target);
+            }
+            else
+            {
+                QFile::remove(part);
+            }
+        }
+    }
+
+    if (!retention.maxFiles && !retention.maxBytes && !retention.maxDays)
+        return;
+    // 当前写入的文件始终保留并计入数量与大小
+    const auto now = QDateTime::currentDateTime();
+    int count      = active.exists() ? 1 : 0;
+    qint64 bytes   = active.exists() ? active.size() : 0;
+    for (const auto& info : files)
+    {
+        if (!info.exists())
+            continue;
+        ++count;
+        bytes += info.size();
+        if ((retention.maxFiles > 0 && count > retention.maxFiles) || (retention.maxBytes > 0 && bytes > retention.maxBytes) ||
+            (retention.maxDays > 0 && info.lastModified().daysTo(now) >= retention.maxDays))
+        {
+            if (QFile::remove(info.absoluteFilePath()))
+            {
+                --count;
+                bytes -= info.size();
+            }
+        }
+    }
+}
+
+// 日志管理器的命名规则: yyyy-MM-dd hh.mm.ss[.zzz].log[.qz]
+bool QCtmLogArchiver::isLogFileName(const QString& fileName)
+{
+    static const QRegularExpression pattern(QStringLiteral("^\\d{4}-\\d{2}-\\d{2} \\d{2}\\.\\d{2}\\.\\d{2}(\\.\\d{3})?\\.log(\\.qz)?$"));
+    return pattern.match(fileName).hasMatch();
+}
+
+bool QCtmLogArchiver::compressFile(const QString& source, const QString& target, const std::atomic_bool* cancel)
+{
+    QFile in(source);
+    QFile out(target);
+    if (!in.open(QFile::ReadOnly) || !out.open(QFile::WriteOnly | QFile::Truncate))
+        return false;
+    if (out.write(Magic, 4) != 4)
+        return false;
+    while (!in.atEnd())
+    {
+        if (cancel && cancel->load(std::memory_order_relaxed))
+            return false;
+        const auto chunk = qCompress(in.read(ChunkSize), 6);
+        uchar size[4];
+        qToBigEndian<quint32>(static_cast<quint32>(chunk.size()), size);
+        if (out.write(reinterpret_cast<const char*>(size), 4) != 4 || out.write(chunk) != chunk.size())
+            return false;
+    }
+    return in.error() == QFile::NoError && out.flush();
+}
+
+bool QCtmLogArchiver::decompressFile(const QString& source, const QString& target)
+{
+    QFile in(source);
+    QFile out(target);
+    if (!in.open(QFile::ReadOnly) || in.read(4) != QByteArray(Magic, 4) || !out.open(QFile::WriteOnly | QFile::Truncate))
+        return false;
+    while (!in.atEnd())
+    {
+        const auto header = in.read(4);
+        if (header.size() != 4)
+            return false;
+        const auto size = qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(header.constData()));
+        if (size > MaxChunkBytes)
+            return false;
+        const auto chunk = in.read(size);
+        if (chunk.size() != static_cast<int>(size))
+            return false;
+        const auto data = qUncompress(chunk);
+        if (data.isEmpty()) // 写入时不会产生空块
+            return false;
+        if (out.write(data) != data.size())
+            return false;
+    }
+    return out.flush();
+}
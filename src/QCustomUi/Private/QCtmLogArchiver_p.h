@@ -0,0 +1,76 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+
+#include <atomic>
+
+class QThread;
+
+/*
+    轮转后日志文件的后台处理: 低优先级线程压缩已关闭的日志文件并按数量/总大小/时间清理旧文件.
+    schedule 只记录请求并唤醒线程, 不会阻塞日志写入.
+    处理当前写入文件所在目录中按日志管理器命名规则 (yyyy-MM-dd hh.mm.ss[.zzz].log[.qz]) 命名的文件, 包括之前运行时留下的文件,
+    当前写入的文件与目录中的其他文件不会被压缩或删除.
+    压缩文件格式: 4字节标识 "QCLZ", 之后为若干块 [4字节大端压缩长度][qCompress 数据].
+*/
+class QCtmLogArchiver
+{
+public:
+    struct Retention
+    {
+        int maxFiles { 0 };
+        qint64 maxBytes { 0 };
+        int maxDays { 0 };
+    };
+
+    QCtmLogArchiver();
+    ~QCtmLogArchiver();
+
+    void setCompressionEnabled(bool enable);
+    bool compressionEnabled() const;
+    void setRetention(const Retention& retention);
+    Retention retention() const;
+    void schedule(const QString& activeFile);
+    void stop();
+
+    static bool isLogFileName(const QString& fileName);
+    static bool compressFile(const QString& source, const QString& target, const std::atomic_bool* cancel = nullptr);
+    static bool decompressFile(const QString& source, const QString& target);
+
+    static constexpr char Suffix[] = ".qz";
+
+private:
+    void run();
+    void sweep(const QString& activeFile);
+
+private:
+    mutable QMutex m_mutex;
+    QWaitCondition m_condition;
+    QThread* m_thread { nullptr };
+    bool m_pending { false };
+    std::atomic_bool m_stop { false };
+    QString m_activeFile;
+    bool m_compress { false };
+    Retention m_retention;
+};
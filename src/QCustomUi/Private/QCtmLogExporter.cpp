@@ -0,0 +1,336 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#include "QCtmLogExporter_p.h"
+#include "QCtmAbstractLogModel.h"
+#include "QCtmLogData.h"
+#include "QCtmLogFormatter_p.h"
+
+#include <QAbstractProxyModel>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QThread>
+#include <QTimer>
+
+namespace
+{
+constexpr int ChunkRows        = 4096;
+constexpr size_t MaxChunks     = 4;
+constexpr int SliceMsecs       = 8;
+constexpr int WriteBufferBytes = 1024 * 1024;
+
+// RFC 4180: 包含分隔符、引号或换行的字段加引号, 引号转义为两个引号
+void appendCsvField(QByteArray& out, const QString& field)
+{
+    bool quote = false;
+    for (auto c : field)
+    {
+        if (c == QLatin1Char(',') || c == QLatin1Char('"') || c == QLatin1Char('\n') || c == QLatin1Char('\r'))
+        {
+            quote = true;
+            break;
+        }
+    }
+    if (!quote)
+    {
+        QCtmLogFormatter::appendUtf8(out, field);
+        return;
+    }
+    out.append('"');
+    QString escaped = field;
+    escaped.replace(QLatin1Char('"'), QLatin1String("\"\""));
+    QCtmLogFormatter::appendUtf8(out, escaped);
+    out.append('"');
+}
+} // namespace
+
+QCtmLogExporter::QCtmLogExporter(QObject* parent /* = nullptr */) : QObject(parent), m_linePattern(QCtmLogFormatter().pattern()) {}
+
+QCtmLogExporter::~QCtmLogExporter()
+{
+    cancel();
+    if (m_thread)
+    {
+        m_thread->wait();
+        delete m_thread;
+    }
+    if (m_file.isOpen())
+        m_file.remove();
+}
+
+// 导出过程中不能修改, 工作线程启动后只读
+bool QCtmLogExporter::setLinePattern(const QString& pattern)
+{
+    if (isRunning() || !QCtmLogFormatter().setPattern(pattern))
+        return false;
+    m_linePattern = pattern;
+    return true;
+}
+
+const QString& QCtmLogExporter::linePattern() const { return m_linePattern; }
+
+bool QCtmLogExporter::start(QAbstractProxyModel* proxy, const QString& fileName, Format format)
+{
+    if (isRunning() || !proxy || !proxy->sourceModel())
+        return false;
+    m_file.setFileName(fileName);
+    if (!m_file.open(QFile::WriteOnly | QFile::Truncate))
+        return false;
+
+    m_source = proxy->sourceModel();
+    m_format = format;
+    m_rows.clear();
+    m_rows.reserve(proxy->rowCount());
+    for (int row = 0; row < proxy->rowCount(); row++)
+    {
+        m_rows.push_back(proxy->mapToSource(proxy->index(row, 0)).row());
+    }
+    m_next         = 0;
+    m_shift        = 0;
+    m_producerDone = false;
+    m_cancel       = false;
+    m_chunks.clear();
+
+    // 日志 model 只在首部插入 (逆序) 或在首部淘汰 (顺序), 尾部的变化不影响未导出的行号
+    m_connections << connect(m_source,
+                             &QAbstractItemModel::rowsInserted,
+                             this,
+                             [this](const QModelIndex&, int first, int last)
+                             {
+                                 if (first == 0)
+                                     m_shift += last - first + 1;
+                             });
+    m_connections << connect(m_source,
+                             &QAbstractItemModel::rowsRemoved,
+                             this,
+                             [this](const QModelIndex&, int first, int last)
+                             {
+                                 if (first == 0)
+                                     m_shift -= last - first + 1;
+                             });
+    m_connections << connect(m_source, &QAbstractItemModel::modelReset, this, &QCtmLogExporter::cancel);
+    m_connections << connect(m_source, &QAbstractItemModel::layoutChanged, this, &QCtmLogExporter::cancel);
+
+    m_thread = QThread::create([this] { run(); });
+    m_thread->setObjectName("QCtmLogExporter");
+    m_thread->start(QThread::LowPriority);
+    m_produceScheduled = false;
+    scheduleProduce(0);
+    return true;
+}
+
+void QCtmLogExporter::cancel()
+{
+    if (!m_thread)
+        return;
+    disconnectSource();
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_mutex);
+#endif
+    m_cancel = true;
+    m_condition.wakeAll();
+}
+
+bool QCtmLogExporter::isRunning() const
+{
+    return m_thread != nullptr;
+}
+
+// 同一时刻最多只有一个等待执行的 produce
+void QCtmLogExporter::scheduleProduce(int msec)
+{
+    if (m_produceScheduled)
+        return;
+    m_produceScheduled = true;
+    QTimer::singleShot(msec, this, &QCtmLogExporter::produce);
+}
+
+void QCtmLogExporter::produce()
+{
+    m_produceScheduled = false;
+    if (!m_thread || m_cancel)
+        return;
+    if (!m_source)
+    {
+        cancel();
+        return;
+    }
+    QElapsedTimer slice;
+    slice.start();
+    while (m_next < m_rows.size() && !slice.hasExpired(SliceMsecs))
+    {
+        {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+            QMutexLocker locker(&m_mutex);
+#else
+            QMutexLocker<QMutex> locker(&m_mutex);
+#endif
+            if (m_chunks.size() >= MaxChunks)
+                return; // 等待工作线程写出, 工作线程取走一块后重新调度
+        }
+
+        Chunk chunk;
+        chunk.reserve(ChunkRows);
+        const int rowCount = m_source->rowCount();
+        const int end      = std::min<int>(m_next + ChunkRows, m_rows.size());
+        for (; m_next < end; m_next++)
+        {
+            const int row = m_rows[m_next] + m_shift;
+            if (row < 0 || row >= rowCount)
+                continue; // 已被淘汰
+            const auto index = m_source->index(row, 0);
+            chunk.push_back({ index.data(QCtmAbstractLogModel::TimeRole).toLongLong(),
+                              index.data(QCtmAbstractLogModel::TypeRole).toInt(),
+                              index.siblingAtColumn(2).data(QCtmAbstractLogModel::CopyMessageRole).toString() });
+        }
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        QMutexLocker locker(&m_mutex);
+#else
+        QMutexLocker<QMutex> locker(&m_mutex);
+#endif
+        m_chunks.push_back(std::move(chunk));
+        m_condition.wakeOne();
+    }
+
+    if (m_next < m_rows.size())
+    {
+        scheduleProduce(1); // 时间片用完, 让出 GUI 线程
+        return;
+    }
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_mutex);
+#endif
+    m_producerDone = true;
+    m_condition.wakeOne();
+}
+
+void QCtmLogExporter::run()
+{
+    QCtmLogFormatter formatter;
+    QByteArray buffer;
+    buffer.reserve(WriteBufferBytes + 64 * 1024);
+    if (m_format == Csv)
+    {
+        formatter.setPattern("{time:%Y-%m-%d %H:%M:%S.%e},{level},");
+        buffer.append("Time,Level,Message\n");
+    }
+    else
+        formatter.setPattern(m_linePattern);
+
+    const qint64 total = m_rows.size();
+    qint64 written     = 0;
+    bool success       = true;
+    for (;;)
+    {
+        Chunk chunk;
+        {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+            QMutexLocker locker(&m_mutex);
+#else
+            QMutexLocker<QMutex> locker(&m_mutex);
+#endif
+            while (m_chunks.empty() && !m_producerDone && !m_cancel)
+                m_condition.wait(&m_mutex);
+            if (m_cancel)
+            {
+                success = false;
+                break;
+            }
+            if (m_chunks.empty())
+                break; // 全部完成
+            chunk = std::move(m_chunks.front());
+            m_chunks.pop_front();
+        }
+        QMetaObject::invokeMethod(
+            this,
+            [this]()
+            {
+                scheduleProduce(0);
+            },
+            Qt::QueuedConnection); // 队列有空位, 继续读取
+
+        for (const auto& record : chunk)
+        {
+            const QCtmLogData data(static_cast<QtMsgType>(record.type), 0, m_format == Csv ? QString() : record.msg, record.msecs);
+            formatter.format(data, buffer);
+            if (m_format == Csv)
+            {
+                buffer.chop(1); // 格式化器在行尾附加的换行
+                appendCsvField(buffer, record.msg);
+                buffer.append('\n');
+            }
+            if (buffer.size() >= WriteBufferBytes)
+            {
+                if (m_file.write(buffer) != buffer.size())
+                {
+                    success = false;
+                    break;
+                }
+                buffer.resize(0);
+            }
+        }
+        if (!success)
+            break;
+        written += chunk.size();
+        QMetaObject::invokeMethod(
+            this,
+            [this, written, total]()
+            {
+                emit progress(written, total);
+            },
+            Qt::QueuedConnection);
+    }
+    if (success && !buffer.isEmpty())
+        success = m_file.write(buffer) == buffer.size();
+    QMetaObject::invokeMethod(
+        this,
+        [this, success]()
+        {
+            finish(success);
+        },
+        Qt::QueuedConnection);
+}
+
+void QCtmLogExporter::finish(bool success)
+{
+    disconnectSource();
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+    m_file.close();
+    if (!success)
+        m_file.remove(); // 取消或写入失败时不保留不完整的文件
+    m_rows      = QVector<int>();
+    m_chunks.clear();
+    emit finished(success);
+}
+
+void QCtmLogExporter::disconnectSource()
+{
+    for (const auto& connection : m_connections)
+    {
+        disconnect(connection);
+    }
+    m_connections.clear();
+}
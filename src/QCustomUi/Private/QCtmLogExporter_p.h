@@ -0,0 +1,95 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include <QFile>
+#include <QMutex>
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <deque>
+
+class QAbstractItemModel;
+class QAbstractProxyModel;
+class QThread;
+
+/*
+    将代理 model 当前的筛选结果流式导出到文件.
+    开始时只记录筛选结果对应的源行号, GUI 线程按时间片每次读取一块日志交给工作线程格式化并写入,
+    在途的块数量有上限, 内存占用与导出的行数无关. 源 model 在导出过程中追加或淘汰日志时按行号偏移修正, 重置时取消导出.
+*/
+class QCtmLogExporter : public QObject
+{
+    Q_OBJECT
+public:
+    enum Format
+    {
+        Csv,
+        LogLine
+    };
+
+    explicit QCtmLogExporter(QObject* parent = nullptr);
+    ~QCtmLogExporter();
+
+    bool setLinePattern(const QString& pattern);
+    const QString& linePattern() const;
+    bool start(QAbstractProxyModel* proxy, const QString& fileName, Format format);
+    void cancel();
+    bool isRunning() const;
+signals:
+    void progress(qint64 written, qint64 total);
+    void finished(bool success);
+
+private:
+    struct Record
+    {
+        qint64 msecs;
+        int type;
+        QString msg;
+    };
+    using Chunk = QVector<Record>;
+
+    void scheduleProduce(int msec);
+    void produce();
+    void run();
+    void finish(bool success);
+    void disconnectSource();
+
+private:
+    QPointer<QAbstractItemModel> m_source;
+    QVector<QMetaObject::Connection> m_connections;
+    QVector<int> m_rows;
+    int m_next { 0 };
+    int m_shift { 0 };
+    bool m_produceScheduled { false };
+    Format m_format { LogLine };
+    QString m_linePattern; // LogLine 格式的行格式, 记录不含代码位置, 位置字段输出为空
+    QFile m_file;
+    QThread* m_thread { nullptr };
+
+    QMutex m_mutex;
+    QWaitCondition m_condition;
+    std::deque<Chunk> m_chunks;
+    bool m_producerDone { false };
+    std::atomic_bool m_cancel { false };
+};
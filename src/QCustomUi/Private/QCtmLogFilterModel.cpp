@@ -19,11 +19,99 @@
 
 #include "QCtmLogFilterModel.h"
 #include "QCtmLogModel.h"
+#include "QCtmLogTrigramIndex_p.h"
+
+#include <QDateTime>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace
+{
+constexpr int MessageColumn   = 2;
+constexpr int SyncSearchLimit = 8192; // 行数较少时直接在当前线程中查询
+constexpr int SearchChunk     = 16384;
+
+enum State : quint8
+{
+    Rejected,
+    Accepted,
+    Unknown
+};
+} // namespace
 
 struct QCtmLogFilterModel::Impl
 {
+    // 后台查询任务, 各分块只写入自己范围内的结果
+    struct Job
+    {
+        quint64 generation { 0 };
+        QString keyword;
+        QStringList terms;
+        int sourceRows { 0 };
+        std::vector<int> rows; // 参与查询的源行
+        QCtmAbstractLogModel::MessageReader reader; // 源支持时在工作线程中读取消息, 否则使用 texts 快照
+        QVector<QString> texts;
+        std::vector<quint8> result;
+        std::vector<std::pair<int, int>> ops; // 查询期间源的行变化, 正数为插入, 负数为移除
+        std::atomic_int remaining { 0 };
+        std::atomic_bool cancel { false };
+    };
+
     bool showLogs[QtMsgType::QtInfoMsg + 1];
-    QString keyword;
+    QString keyword;                     // 当前生效的关键字
+    QStringList terms;
+    mutable std::vector<quint8> states; // 每个源行对当前关键字的匹配结果
+    std::shared_ptr<Job> job;
+    quint64 generation { 0 };
+    QCtmLogModel* logModel { nullptr };
+    QCtmAbstractLogModel* abstractLogModel { nullptr };
+
+    bool timeFilter { false };
+    qint64 from { 0 };
+    qint64 to { 0 };
+    mutable QPair<int, int> timeRows { -1, -1 }; // 源为 QCtmLogModel 时时间范围对应的行
+    mutable bool timeRowsDirty { true };
+    QThreadPool pool;
+    QList<QMetaObject::Connection> connections;
+
+    inline QString text(const QAbstractItemModel* model, int row) const
+    {
+        if (abstractLogModel)
+            return abstractLogModel->messageAt(row);
+        return model->index(row, MessageColumn).data(QCtmAbstractLogModel::CopyMessageRole).toString();
+    }
+
+    // 以空白分隔的关键字需要全部包含
+    static inline bool matches(const QString& text, const QStringList& terms)
+    {
+        return std::all_of(terms.begin(), terms.end(), [&](const QString& term) { return text.contains(term, Qt::CaseInsensitive); });
+    }
+
+    // 旧关键字都被新关键字包含时, 新的结果是旧结果的子集
+    static inline bool narrows(const QStringList& terms, const QStringList& previous)
+    {
+        return std::all_of(previous.begin(),
+                           previous.end(),
+                           [&](const QString& old)
+                           {
+                               return std::any_of(
+                                   terms.begin(), terms.end(), [&](const QString& term) { return term.contains(old, Qt::CaseInsensitive); });
+                           });
+    }
+
+    static void run(Job& job, int begin, int end)
+    {
+        for (int i = begin; i < end; i++)
+        {
+            if ((i & 1023) == 0 && job.cancel.load(std::memory_order_relaxed))
+                return;
+            const auto text = job.reader ? job.reader(job.rows[i]) : job.texts[i];
+            job.result[i]   = matches(text, job.terms) ? Accepted : Rejected;
+        }
+    }
 };
 
 /*!
@@ -35,6 +123,11 @@ struct QCtmLogFilterModel::Impl
     \inheaderfile QCtmLogFilterModel.h
 */
 
+/*!
+    \fn         void QCtmLogFilterModel::searchFinished()
+    \brief      查询结果生效时发送该信号.
+*/
+
 /*!
     \brief      构造函数 \a parent.
 */
@@ -43,15 +136,148 @@ QCtmLogFilterModel::QCtmLogFilterModel(QObject* parent) : QSortFilterProxyModel(
 /*!
     \brief      析构函数.
 */
-QCtmLogFilterModel::~QCtmLogFilterModel() {}
+QCtmLogFilterModel::~QCtmLogFilterModel()
+{
+    cancelSearch();
+    m_impl->pool.waitForDone();
+}
 
 /*!
-    \brief      查询关键字 \a keyword.
+    \brief      查询关键字 \a keyword, 以空白分隔的多个关键字需要全部包含, 不区分大小写.
+                源为开启全文索引的 QCtmLogModel 且至少有一个关键字不短于3个字符时直接使用索引查询.
+                否则在线程池中查询, 源提供 messageReader 时 (如 QCtmLogFileModel) 消息在工作线程中读取,
+                其余情况在当前线程中取出消息文本的快照. 结果以行位图的形式返回后一次性生效,
+                新关键字包含上一次的关键字时 (如继续输入), 只在上一次匹配的行中查询.
+    \sa         isSearching, searchFinished
 */
 void QCtmLogFilterModel::search(const QString& keyword)
 {
-    m_impl->keyword = keyword;
-    this->invalidate();
+    cancelSearch();
+    auto source = sourceModel();
+    const auto terms = QCtmLogTrigramIndex::terms(keyword);
+    if (terms.isEmpty() || !source)
+    {
+        m_impl->keyword = terms.isEmpty() ? QString() : keyword;
+        m_impl->terms   = terms;
+        resetStates();
+        invalidateFilter();
+        emit searchFinished();
+        return;
+    }
+
+    const int rows = source->rowCount();
+    // 关键字都短于3个字符时索引无法缩小范围, findRows 会在当前线程中逐行查询, 改为在线程池中查询
+    if (auto model = m_impl->logModel; model && model->fullTextIndexEnabled() && QCtmLogTrigramIndex::indexable(terms))
+    {
+        m_impl->keyword = keyword;
+        m_impl->terms   = terms;
+        m_impl->states.assign(rows, Rejected);
+        for (auto row : model->findRows(keyword))
+        {
+            m_impl->states[row] = Accepted;
+        }
+        invalidateFilter();
+        emit searchFinished();
+        return;
+    }
+
+    const bool narrow = !m_impl->keyword.isEmpty() && m_impl->states.size() == static_cast<size_t>(rows) &&
+                        Impl::narrows(terms, m_impl->terms);
+    auto job          = std::make_shared<Impl::Job>();
+    job->generation   = ++m_impl->generation;
+    job->keyword      = keyword;
+    job->terms        = terms;
+    job->sourceRows   = rows;
+    if (m_impl->abstractLogModel)
+        job->reader = m_impl->abstractLogModel->messageReader();
+    for (int row = 0; row < rows; row++)
+    {
+        if (narrow && m_impl->states[row] == Rejected)
+            continue;
+        job->rows.push_back(row);
+        if (!job->reader)
+            job->texts.push_back(m_impl->text(source, row));
+    }
+    const int count = static_cast<int>(job->rows.size());
+    job->result.resize(count, Rejected);
+    m_impl->job = job;
+
+    if (count <= SyncSearchLimit)
+    {
+        Impl::run(*job, 0, count);
+        finishSearch(job->generation);
+        return;
+    }
+
+    const int chunks = (count + SearchChunk - 1) / SearchChunk;
+    job->remaining   = chunks;
+    for (int i = 0; i < chunks; i++)
+    {
+        const int begin = i * SearchChunk;
+        const int end   = std::min(begin + SearchChunk, count);
+        m_impl->pool.start(QRunnable::create(
+            [this, job, begin, end]
+            {
+                Impl::run(*job, begin, end);
+                if (job->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1 && !job->cancel.load(std::memory_order_relaxed))
+                {
+                    const auto generation = job->generation;
+                    QMetaObject::invokeMethod(
+                        this, [this, generation] { finishSearch(generation); }, Qt::QueuedConnection);
+                }
+            }));
+    }
+}
+
+/*!
+    \brief      返回是否有正在进行的后台查询.
+    \sa         search
+*/
+bool QCtmLogFilterModel::isSearching() const
+{
+    return m_impl->job != nullptr;
+}
+
+/*!
+    \reimp
+*/
+void QCtmLogFilterModel::setSourceModel(QAbstractItemModel* model)
+{
+    cancelSearch();
+    for (const auto& connection : m_impl->connections)
+    {
+        disconnect(connection);
+    }
+    m_impl->connections.clear();
+    m_impl->logModel         = qobject_cast<QCtmLogModel*>(model);
+    m_impl->abstractLogModel = qobject_cast<QCtmAbstractLogModel*>(model);
+    m_impl->timeRowsDirty    = true;
+    QSortFilterProxyModel::setSourceModel(model);
+    if (model)
+    {
+        m_impl->connections << connect(model, &QAbstractItemModel::rowsAboutToBeInserted, this, &QCtmLogFilterModel::onRowsAboutToBeInserted);
+        m_impl->connections << connect(model, &QAbstractItemModel::rowsAboutToBeRemoved, this, &QCtmLogFilterModel::onRowsAboutToBeRemoved);
+        m_impl->connections << connect(model,
+                                       &QAbstractItemModel::modelReset,
+                                       this,
+                                       [this]
+                                       {
+                                           cancelSearch();
+                                           resetStates();
+                                           m_impl->timeRowsDirty = true;
+                                       });
+        m_impl->connections << connect(model,
+                                       &QAbstractItemModel::layoutChanged,
+                                       this,
+                                       [this]
+                                       {
+                                           cancelSearch();
+                                           resetStates();
+                                           m_impl->timeRowsDirty = true;
+                                       });
+    }
+    resetStates();
+    invalidateFilter();
 }
 
 /*!
@@ -59,16 +285,160 @@ void QCtmLogFilterModel::search(const QString& keyword)
 */
 bool QCtmLogFilterModel::filterAcceptsRow(int sourceRow, [[maybe_unused]] const QModelIndex& sourceParent) const
 {
-    auto type = this->sourceModel()->data(this->sourceModel()->index(sourceRow, 0), QCtmLogModel::TypeRole).toInt();
-    if (!m_impl->keyword.isEmpty())
+    auto type = this->sourceModel()->data(this->sourceModel()->index(sourceRow, 0), QCtmAbstractLogModel::TypeRole).toInt();
+    if (!m_impl->showLogs[type])
+        return false;
+    if (m_impl->timeFilter && !acceptsTime(sourceRow))
+        return false;
+    if (m_impl->keyword.isEmpty())
+        return true;
+    const auto row = static_cast<size_t>(sourceRow);
+    if (row < m_impl->states.size() && m_impl->states[row] != Unknown)
+        return m_impl->states[row] == Accepted;
+    // 查询之后新增的行
+    const bool accepted = Impl::matches(m_impl->text(sourceModel(), sourceRow), m_impl->terms);
+    if (row < m_impl->states.size())
+        m_impl->states[row] = accepted ? Accepted : Rejected;
+    return accepted;
+}
+
+/*!
+    \brief      只显示时间在 \a from 与 \a to 之间 (包含两端) 的日志.
+                源为 QCtmLogModel 时以二分查找确定行范围, 筛选时只比较行号.
+    \sa         clearTimeRange, hasTimeRange
+*/
+void QCtmLogFilterModel::setTimeRange(const QDateTime& from, const QDateTime& to)
+{
+    m_impl->timeFilter    = true;
+    m_impl->from          = from.toMSecsSinceEpoch();
+    m_impl->to            = to.toMSecsSinceEpoch();
+    m_impl->timeRowsDirty = true;
+    invalidateFilter();
+}
+
+/*!
+    \brief      取消时间范围筛选.
+    \sa         setTimeRange
+*/
+void QCtmLogFilterModel::clearTimeRange()
+{
+    if (!m_impl->timeFilter)
+        return;
+    m_impl->timeFilter = false;
+    invalidateFilter();
+}
+
+/*!
+    \brief      返回是否设置了时间范围筛选.
+    \sa         setTimeRange
+*/
+bool QCtmLogFilterModel::hasTimeRange() const
+{
+    return m_impl->timeFilter;
+}
+
+/*!
+    \brief      返回源行 \a sourceRow 是否在筛选的时间范围内.
+*/
+bool QCtmLogFilterModel::acceptsTime(int sourceRow) const
+{
+    if (auto model = m_impl->logModel)
     {
-        const auto& desc = this->sourceModel()->data(this->sourceModel()->index(sourceRow, 1), Qt::DisplayRole).toString();
-        return m_impl->showLogs[type] && desc.contains(m_impl->keyword, Qt::CaseInsensitive);
+        if (m_impl->timeRowsDirty)
+        {
+            m_impl->timeRows      = model->rowsForTimeRange(QDateTime::fromMSecsSinceEpoch(m_impl->from),
+                                                       QDateTime::fromMSecsSinceEpoch(m_impl->to));
+            m_impl->timeRowsDirty = false;
+        }
+        return sourceRow >= m_impl->timeRows.first && sourceRow <= m_impl->timeRows.second;
     }
-    return m_impl->showLogs[type];
+    const auto time = sourceModel()->index(sourceRow, 0).data(QCtmAbstractLogModel::TimeRole);
+    if (!time.isValid())
+        return true; // 无法解析时间的行不参与时间筛选
+    const auto msecs = time.toLongLong();
+    return msecs >= m_impl->from && msecs <= m_impl->to;
 }
 
 /*!
     \brief      设置日志类型 \a type 是否显示 \a show.
 */
 void QCtmLogFilterModel::showLog(QtMsgType type, bool show) { m_impl->showLogs[type] = show; }
+
+/*!
+    \brief      应用第 \a generation 次查询的结果, 并重放查询期间源的行变化.
+*/
+void QCtmLogFilterModel::finishSearch(quint64 generation)
+{
+    if (!m_impl->job || m_impl->job->generation != generation)
+        return;
+    auto job = std::move(m_impl->job);
+    std::vector<quint8> states(job->sourceRows, Rejected);
+    for (size_t i = 0; i < job->rows.size(); i++)
+    {
+        states[job->rows[i]] = job->result[i];
+    }
+    for (const auto& [first, count] : job->ops)
+    {
+        if (count > 0)
+            states.insert(states.begin() + first, count, Unknown);
+        else
+            states.erase(states.begin() + first, states.begin() + first - count);
+    }
+    m_impl->keyword = job->keyword;
+    m_impl->terms   = job->terms;
+    m_impl->states  = std::move(states);
+    invalidateFilter();
+    emit searchFinished();
+}
+
+/*!
+    \brief      取消正在进行的查询.
+*/
+void QCtmLogFilterModel::cancelSearch()
+{
+    if (m_impl->job)
+    {
+        m_impl->job->cancel = true;
+        m_impl->job.reset();
+    }
+}
+
+/*!
+    \brief      重置所有行的匹配结果, 结果在筛选时重新计算.
+*/
+void QCtmLogFilterModel::resetStates()
+{
+    m_impl->states.clear();
+    if (!m_impl->keyword.isEmpty() && sourceModel())
+        m_impl->states.assign(sourceModel()->rowCount(), Unknown);
+}
+
+/*!
+    \brief      源插入行 \a first 至 \a last 之前保持匹配结果与源行对齐.
+*/
+void QCtmLogFilterModel::onRowsAboutToBeInserted(const QModelIndex& parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+    m_impl->timeRowsDirty = true;
+    const int count       = last - first + 1;
+    if (!m_impl->states.empty() || !m_impl->keyword.isEmpty())
+        m_impl->states.insert(m_impl->states.begin() + std::min<size_t>(first, m_impl->states.size()), count, Unknown);
+    if (m_impl->job)
+        m_impl->job->ops.emplace_back(first, count);
+}
+
+/*!
+    \brief      源移除行 \a first 至 \a last 之前保持匹配结果与源行对齐.
+*/
+void QCtmLogFilterModel::onRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+    m_impl->timeRowsDirty = true;
+    const auto begin      = std::min<size_t>(first, m_impl->states.size());
+    const auto end        = std::min<size_t>(last + 1, m_impl->states.size());
+    m_impl->states.erase(m_impl->states.begin() + begin, m_impl->states.begin() + end);
+    if (m_impl->job)
+        m_impl->job->ops.emplace_back(first, -(last - first + 1));
+}
@@ -32,10 +32,25 @@ public:
     ~QCtmLogFilterModel();
 
     void search(const QString& keyword);
+    bool isSearching() const;
+    void setTimeRange(const QDateTime& from, const QDateTime& to);
+    void clearTimeRange();
+    bool hasTimeRange() const;
+    void setSourceModel(QAbstractItemModel* model) override;
     bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+signals:
+    void searchFinished();
 public slots:
     void showLog(QtMsgType type, bool show);
 
+private:
+    void finishSearch(quint64 generation);
+    void cancelSearch();
+    void resetStates();
+    bool acceptsTime(int sourceRow) const;
+    void onRowsAboutToBeInserted(const QModelIndex& parent, int first, int last);
+    void onRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last);
+
 private:
     struct Impl;
     std::unique_ptr<Impl> m_impl;
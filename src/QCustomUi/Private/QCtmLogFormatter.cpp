@@ -0,0 +1,429 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#include "QCtmLogFormatter_p.h"
+#include "QCtmLogData.h"
+
+#include <QDateTime>
+
+#include <tao/pegtl.hpp>
+
+namespace LogPattern
+{
+struct Context
+{
+    std::vector<QCtmLogFormatter::Op> ops;
+    std::string name;
+    std::string spec;
+    bool error { false };
+
+    inline void appendLiteral(const char* begin, size_t size)
+    {
+        if (ops.empty() || ops.back().type != QCtmLogFormatter::OpType::Literal)
+            ops.push_back(QCtmLogFormatter::Op { QCtmLogFormatter::OpType::Literal });
+        ops.back().text.append(begin, static_cast<int>(size));
+    }
+};
+
+using namespace tao::pegtl;
+// clang-format off
+struct OpenEscape : two<'{'> {};
+struct CloseEscape : two<'}'> {};
+struct FieldName : plus<ascii::alpha> {};
+struct FieldSpec : star<not_one<'}'>> {};
+struct Field : seq<one<'{'>, FieldName, opt<one<':'>, FieldSpec>, one<'}'>> {};
+struct Text : plus<not_one<'{', '}'>> {};
+struct Pattern : seq<star<sor<OpenEscape, CloseEscape, Field, Text>>, eof> {};
+
+template<typename T>
+struct Action {};
+// clang-format on
+
+template<>
+struct Action<OpenEscape>
+{
+    template<typename ParseInput>
+    static void apply(const ParseInput&, Context& ctx)
+    {
+        ctx.appendLiteral("{", 1);
+    }
+};
+
+template<>
+struct Action<CloseEscape>
+{
+    template<typename ParseInput>
+    static void apply(const ParseInput&, Context& ctx)
+    {
+        ctx.appendLiteral("}", 1);
+    }
+};
+
+template<>
+struct Action<Text>
+{
+    template<typename ParseInput>
+    static void apply(const ParseInput& in, Context& ctx)
+    {
+        ctx.appendLiteral(in.begin(), in.size());
+    }
+};
+
+template<>
+struct Action<FieldName>
+{
+    template<typename ParseInput>
+    static void apply(const ParseInput& in, Context& ctx)
+    {
+        ctx.name = in.string();
+        ctx.spec.clear();
+    }
+};
+
+template<>
+struct Action<FieldSpec>
+{
+    template<typename ParseInput>
+    static void apply(const ParseInput& in, Context& ctx)
+    {
+        ctx.spec = in.string();
+    }
+};
+
+std::vector<QCtmLogFormatter::TimePart> compileTime(const std::string& spec);
+
+template<>
+struct Action<Field>
+{
+    template<typename ParseInput>
+    static void apply(const ParseInput&, Context& ctx)
+    {
+        using Type = QCtmLogFormatter::OpType;
+        QCtmLogFormatter::Op op { Type::Literal };
+        if (ctx.name == "time")
+        {
+            op.type = Type::Time;
+            op.time = compileTime(ctx.spec.empty() ? "%F %T:%e" : ctx.spec);
+        }
+        else if (ctx.name == "level")
+            op.type = Type::Level;
+        else if (ctx.name == "file")
+            op.type = Type::File;
+        else if (ctx.name == "line")
+            op.type = Type::Line;
+        else if (ctx.name == "function")
+            op.type = Type::Function;
+        else if (ctx.name == "category")
+            op.type = Type::Category;
+        else if (ctx.name == "msg")
+            op.type = Type::Message;
+        else if (ctx.name == "repeat")
+            op.type = Type::Repeat;
+        else
+            ctx.error = true;
+        ctx.ops.push_back(std::move(op));
+    }
+};
+
+std::vector<QCtmLogFormatter::TimePart> compileTime(const std::string& spec)
+{
+    using Token = QCtmLogFormatter::TimeToken;
+    std::vector<QCtmLogFormatter::TimePart> parts;
+    auto literal = [&](const char* text, int size)
+    {
+        if (parts.empty() || parts.back().token != Token::Literal)
+            parts.push_back({ Token::Literal });
+        parts.back().text.append(text, size);
+    };
+    auto token = [&](Token t)
+    {
+        parts.push_back({ t });
+    };
+    for (size_t i = 0; i < spec.size(); ++i)
+    {
+        if (spec[i] != '%' || i + 1 == spec.size())
+        {
+            literal(&spec[i], 1);
+            continue;
+        }
+        switch (spec[++i])
+        {
+        case 'Y':
+            token(Token::Year);
+            break;
+        case 'y':
+            token(Token::ShortYear);
+            break;
+        case 'm':
+            token(Token::Month);
+            break;
+        case 'd':
+            token(Token::Day);
+            break;
+        case 'H':
+            token(Token::Hour);
+            break;
+        case 'M':
+            token(Token::Minute);
+            break;
+        case 'S':
+            token(Token::Second);
+            break;
+        case 'e':
+            token(Token::Millisecond);
+            break;
+        case 'F':
+            token(Token::Year);
+            literal("-", 1);
+            token(Token::Month);
+            literal("-", 1);
+            token(Token::Day);
+            break;
+        case 'T':
+            token(Token::Hour);
+            literal(":", 1);
+            token(Token::Minute);
+            literal(":", 1);
+            token(Token::Second);
+            break;
+        case '%':
+            literal("%", 1);
+            break;
+        default:
+            literal(&spec[i - 1], 2);
+            break;
+        }
+    }
+    return parts;
+}
+} // namespace LogPattern
+
+namespace
+{
+inline void appendNumber(QByteArray& out, qint64 value, int width)
+{
+    char buffer[24];
+    int pos     = sizeof(buffer);
+    bool minus  = value < 0;
+    quint64 abs = minus ? 0 - static_cast<quint64>(value) : static_cast<quint64>(value);
+    do
+    {
+        buffer[--pos] = static_cast<char>('0' + abs % 10);
+        abs /= 10;
+    } while (abs);
+    while (static_cast<int>(sizeof(buffer)) - pos < width)
+        buffer[--pos] = '0';
+    if (minus)
+        buffer[--pos] = '-';
+    out.append(buffer + pos, static_cast<int>(sizeof(buffer)) - pos);
+}
+
+inline void appendCString(QByteArray& out, const char* str)
+{
+    if (str)
+        out.append(str);
+}
+} // namespace
+
+QCtmLogFormatter::QCtmLogFormatter() { setPattern("[{time:%Y-%m-%d %H:%M:%S:%e}] [{level}] [{file}:{line}] {msg}{repeat}"); }
+
+bool QCtmLogFormatter::setPattern(const QString& pattern)
+{
+    LogPattern::Context ctx;
+    const auto str = pattern.toStdString();
+    if (!tao::pegtl::parse<LogPattern::Pattern, LogPattern::Action>(tao::pegtl::string_input(str, "pattern"), ctx) || ctx.error)
+        return false;
+    ctx.appendLiteral("\n", 1);
+    m_ops     = std::move(ctx.ops);
+    m_pattern = pattern;
+    return true;
+}
+
+const QString& QCtmLogFormatter::pattern() const { return m_pattern; }
+
+const std::vector<QCtmLogFormatter::Op>& QCtmLogFormatter::ops() const { return m_ops; }
+
+const char* QCtmLogFormatter::levelName(QtMsgType type)
+{
+    switch (type)
+    {
+    case QtMsgType::QtInfoMsg:
+        return "Info";
+    case QtMsgType::QtWarningMsg:
+        return "Warn";
+    case QtMsgType::QtCriticalMsg:
+        return "Error";
+    case QtMsgType::QtFatalMsg:
+        return "Abort";
+    case QtMsgType::QtDebugMsg:
+        return "Debug";
+    }
+    return "";
+}
+
+void QCtmLogFormatter::format(const QCtmLogData& data, QByteArray& out)
+{
+    for (auto& op : m_ops)
+    {
+        switch (op.type)
+        {
+        case OpType::Literal:
+            out.append(op.text);
+            break;
+        case OpType::Time:
+            renderTime(op, data.msecsSinceEpoch(), out);
+            break;
+        case OpType::Level:
+            out.append(levelName(data.type()));
+            break;
+        case OpType::File:
+            appendCString(out, data.context().file);
+            break;
+        case OpType::Line:
+            appendNumber(out, data.context().line, 0);
+            break;
+        case OpType::Function:
+            appendCString(out, data.context().function);
+            break;
+        case OpType::Category:
+            appendCString(out, data.context().category);
+            break;
+        case OpType::Message:
+            appendUtf8(out, data.msg());
+            break;
+        case OpType::Repeat:
+            if (data.repeatCount() > 1)
+            {
+                out.append(" \xc3\x97", 3); // " ×"
+                appendNumber(out, data.repeatCount(), 0);
+            }
+            break;
+        }
+    }
+}
+
+void QCtmLogFormatter::renderTime(Op& op, qint64 msecs, QByteArray& out)
+{
+    auto second = msecs / 1000;
+    auto millis = msecs % 1000;
+    if (millis < 0)
+    {
+        millis += 1000;
+        second -= 1;
+    }
+    if (second != op.cachedSecond)
+    {
+        const auto dateTime = QDateTime::fromMSecsSinceEpoch(second * 1000);
+        const auto date     = dateTime.date();
+        const auto time     = dateTime.time();
+        op.cachedSecond     = second;
+        op.cachedText.resize(0);
+        op.millisecondOffsets.clear();
+        for (const auto& part : op.time)
+        {
+            switch (part.token)
+            {
+            case TimeToken::Literal:
+                op.cachedText.append(part.text);
+                break;
+            case TimeToken::Year:
+                appendNumber(op.cachedText, date.year(), 4);
+                break;
+            case TimeToken::ShortYear:
+                appendNumber(op.cachedText, date.year() % 100, 2);
+                break;
+            case TimeToken::Month:
+                appendNumber(op.cachedText, date.month(), 2);
+                break;
+            case TimeToken::Day:
+                appendNumber(op.cachedText, date.day(), 2);
+                break;
+            case TimeToken::Hour:
+                appendNumber(op.cachedText, time.hour(), 2);
+                break;
+            case TimeToken::Minute:
+                appendNumber(op.cachedText, time.minute(), 2);
+                break;
+            case TimeToken::Second:
+                appendNumber(op.cachedText, time.second(), 2);
+                break;
+            case TimeToken::Millisecond:
+                op.millisecondOffsets.push_back(op.cachedText.size());
+                op.cachedText.append("000", 3);
+                break;
+            }
+        }
+    }
+
+    const auto base = out.size();
+    out.append(op.cachedText);
+    auto* data = out.data() + base;
+    for (auto offset : op.millisecondOffsets)
+    {
+        data[offset]     = static_cast<char>('0' + millis / 100);
+        data[offset + 1] = static_cast<char>('0' + millis / 10 % 10);
+        data[offset + 2] = static_cast<char>('0' + millis % 10);
+    }
+}
+
+void QCtmLogFormatter::appendUtf8(QByteArray& out, const QString& str)
+{
+    const auto* chars = reinterpret_cast<const char16_t*>(str.constData());
+    const auto size   = str.size();
+    const auto base   = out.size();
+    out.resize(base + size * 3); // UTF-16 单个码元最多编码为3字节, 代理对为4字节
+    auto* dst = reinterpret_cast<unsigned char*>(out.data() + base);
+    auto* beg = dst;
+    for (decltype(str.size()) i = 0; i < size; ++i)
+    {
+        char32_t c = chars[i];
+        if (c < 0x80)
+        {
+            *dst++ = static_cast<unsigned char>(c);
+            continue;
+        }
+        if (c >= 0xd800 && c < 0xdc00 && i + 1 < size && chars[i + 1] >= 0xdc00 && chars[i + 1] < 0xe000)
+        {
+            c = 0x10000 + ((c - 0xd800) << 10) + (chars[++i] - 0xdc00);
+        }
+        else if (c >= 0xd800 && c < 0xe000)
+        {
+            c = 0xfffd; // 孤立的代理项
+        }
+        if (c < 0x800)
+        {
+            *dst++ = static_cast<unsigned char>(0xc0 | (c >> 6));
+            *dst++ = static_cast<unsigned char>(0x80 | (c & 0x3f));
+        }
+        else if (c < 0x10000)
+        {
+            *dst++ = static_cast<unsigned char>(0xe0 | (c >> 12));
+            *dst++ = static_cast<unsigned char>(0x80 | ((c >> 6) & 0x3f));
+            *dst++ = static_cast<unsigned char>(0x80 | (c & 0x3f));
+        }
+        else
+        {
+            *dst++ = static_cast<unsigned char>(0xf0 | (c >> 18));
+            *dst++ = static_cast<unsigned char>(0x80 | ((c >> 12) & 0x3f));
+            *dst++ = static_cast<unsigned char>(0x80 | ((c >> 6) & 0x3f));
+            *dst++ = static_cast<unsigned char>(0x80 | (c & 0x3f));
+        }
+    }
+    out.resize(base + static_cast<int>(dst - beg));
+}
@@ -0,0 +1,99 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+#include <vector>
+
+class QCtmLogData;
+
+/*
+    日志行格式化器, 模式字符串只解析一次, 格式化时按编译后的操作序列直接输出 UTF-8.
+    模式字段: {time[:格式]} {level} {file} {line} {function} {category} {msg} {repeat}, 使用 {{ 与 }} 输出花括号.
+    {repeat} 在去重后的摘要日志中输出 " ×次数", 普通日志不输出.
+    时间格式: %Y %y %m %d %H %M %S %e(毫秒) %F(%Y-%m-%d) %T(%H:%M:%S) %%, 除毫秒外的时间文本按秒缓存.
+*/
+class QCtmLogFormatter
+{
+public:
+    QCtmLogFormatter();
+    bool setPattern(const QString& pattern);
+    const QString& pattern() const;
+    void format(const QCtmLogData& data, QByteArray& out);
+
+    static void appendUtf8(QByteArray& out, const QString& str);
+    static const char* levelName(QtMsgType type);
+
+public:
+    enum class TimeToken
+    {
+        Literal,
+        Year,
+        ShortYear,
+        Month,
+        Day,
+        Hour,
+        Minute,
+        Second,
+        Millisecond
+    };
+
+    struct TimePart
+    {
+        TimeToken token;
+        QByteArray text;
+    };
+
+    enum class OpType
+    {
+        Literal,
+        Time,
+        Level,
+        File,
+        Line,
+        Function,
+        Category,
+        Message,
+        Repeat
+    };
+
+    struct Op
+    {
+        OpType type;
+        QByteArray text;
+        std::vector<TimePart> time;
+        // 按秒缓存的时间文本, 毫秒位置预留占位
+        qint64 cachedSecond { -1 };
+        QByteArray cachedText;
+        std::vector<int> millisecondOffsets;
+    };
+
+    // 编译后的操作序列, 末尾为换行符
+    const std::vector<Op>& ops() const;
+
+private:
+    void renderTime(Op& op, qint64 msecs, QByteArray& out);
+
+private:
+    QString m_pattern;
+    std::vector<Op> m_ops;
+};
@@ -0,0 +1,266 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#include "QCtmLogLineParser_p.h"
+
+#include <QDateTime>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+using OpType    = QCtmLogFormatter::OpType;
+using TimeToken = QCtmLogFormatter::TimeToken;
+
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+inline bool isVariable(OpType type) { return type == OpType::File || type == OpType::Function || type == OpType::Category; }
+
+inline int widthOf(TimeToken token)
+{
+    switch (token)
+    {
+    case TimeToken::Year:
+        return 4;
+    case TimeToken::Millisecond:
+        return 3;
+    case TimeToken::Literal:
+        return 0;
+    default:
+        return 2;
+    }
+}
+
+// 读取 width 位数字, 失败返回 -1
+inline int number(const char* p, int width)
+{
+    int value = 0;
+    for (int i = 0; i < width; i++)
+    {
+        if (!isDigit(p[i]))
+            return -1;
+        value = value * 10 + p[i] - '0';
+    }
+    return value;
+}
+
+inline bool startsWith(const char* line, qint64 size, qint64 pos, const QByteArray& text)
+{
+    return size - pos >= text.size() && std::memcmp(line + pos, text.constData(), static_cast<size_t>(text.size())) == 0;
+}
+
+// 按固定宽度匹配时间文本, display 为最后一个非毫秒字段的结束位置
+bool matchTime(const QCtmLogFormatter::Op& op, const char* line, qint64 size, qint64& pos, qint64& display)
+{
+    for (const auto& part : op.time)
+    {
+        if (part.token == TimeToken::Literal)
+        {
+            if (!startsWith(line, size, pos, part.text))
+                return false;
+            pos += part.text.size();
+            continue;
+        }
+        const auto width = widthOf(part.token);
+        if (size - pos < width || number(line + pos, width) < 0)
+            return false;
+        pos += width;
+        if (part.token != TimeToken::Millisecond)
+            display = pos;
+    }
+    return true;
+}
+
+bool matchLevel(const char* line, qint64 size, qint64& pos, quint8& type)
+{
+    for (auto level : { QtMsgType::QtInfoMsg, QtMsgType::QtWarningMsg, QtMsgType::QtCriticalMsg, QtMsgType::QtFatalMsg, QtMsgType::QtDebugMsg })
+    {
+        const auto* name = QCtmLogFormatter::levelName(level);
+        const auto n     = static_cast<qint64>(std::strlen(name));
+        if (size - pos >= n && std::memcmp(line + pos, name, static_cast<size_t>(n)) == 0)
+        {
+            pos += n;
+            type = static_cast<quint8>(level);
+            return true;
+        }
+    }
+    return false;
+}
+} // namespace
+
+QCtmLogLineParser::QCtmLogLineParser() { setPattern(QCtmLogFormatter().pattern()); }
+
+bool QCtmLogLineParser::setPattern(const QString& pattern)
+{
+    QCtmLogFormatter formatter;
+    if (!formatter.setPattern(pattern))
+        return false;
+    const auto& ops = formatter.ops();
+    auto message    = std::find_if(ops.begin(), ops.end(), [](const auto& op) { return op.type == OpType::Message; });
+    if (message == ops.end() || message == ops.begin() || isVariable(ops.front().type))
+        return false;
+    for (auto it = message + 1; it != ops.end(); ++it)
+    {
+        if (it->type != OpType::Repeat && !(it->type == OpType::Literal && it->text == "\n"))
+            return false;
+    }
+    std::vector<QCtmLogFormatter::Op> steps(ops.begin(), message);
+    int time = -1;
+    for (size_t i = 0; i < steps.size(); i++)
+    {
+        const auto& step = steps[i];
+        if (step.type == OpType::Literal && step.text.contains('\n'))
+            return false;
+        if (isVariable(step.type) && (i + 1 == steps.size() || steps[i + 1].type != OpType::Literal))
+            return false;
+        if (step.type == OpType::Time && time < 0)
+            time = static_cast<int>(i);
+    }
+    m_steps   = std::move(steps);
+    m_time    = time;
+    m_pattern = pattern;
+    return true;
+}
+
+const QString& QCtmLogLineParser::pattern() const { return m_pattern; }
+
+// 匹配不含行尾换行符的一行 line, 成功时 record 给出各字段的位置
+bool QCtmLogLineParser::match(const char* line, qint64 size, Record& record) const
+{
+    record = Record {};
+    return matchSteps(0, line, size, 0, record);
+}
+
+// 从 record 记录的位置解析时间, 格式中没有日期时日期为 1970-01-01
+bool QCtmLogLineParser::parseTime(const char* line, const Record& record, qint64& msecs) const
+{
+    if (m_time < 0 || record.time < 0)
+        return false;
+    int year = 1970, month = 1, day = 1, hour = 0, minute = 0, second = 0, millisecond = 0;
+    const char* p = line + record.time;
+    for (const auto& part : m_steps[m_time].time)
+    {
+        if (part.token == TimeToken::Literal)
+        {
+            p += part.text.size();
+            continue;
+        }
+        const auto width = widthOf(part.token);
+        const auto value = number(p, width);
+        p += width;
+        switch (part.token)
+        {
+        case TimeToken::Year:
+            year = value;
+            break;
+        case TimeToken::ShortYear:
+            year = 2000 + value;
+            break;
+        case TimeToken::Month:
+            month = value;
+            break;
+        case TimeToken::Day:
+            day = value;
+            break;
+        case TimeToken::Hour:
+            hour = value;
+            break;
+        case TimeToken::Minute:
+            minute = value;
+            break;
+        case TimeToken::Second:
+            second = value;
+            break;
+        case TimeToken::Millisecond:
+            millisecond = value;
+            break;
+        default:
+            break;
+        }
+    }
+    const QDate date(year, month, day);
+    const QTime time(hour, minute, second, millisecond);
+    if (!date.isValid() || !time.isValid())
+        return false;
+    msecs = QDateTime(date, time).toMSecsSinceEpoch();
+    return true;
+}
+
+bool QCtmLogLineParser::matchSteps(size_t step, const char* line, qint64 size, qint64 pos, Record& record) const
+{
+    for (; step < m_steps.size(); step++)
+    {
+        const auto& op = m_steps[step];
+        switch (op.type)
+        {
+        case OpType::Literal:
+            if (!startsWith(line, size, pos, op.text))
+                return false;
+            pos += op.text.size();
+            break;
+        case OpType::Time:
+        {
+            const auto begin = pos;
+            auto display     = pos;
+            if (!matchTime(op, line, size, pos, display))
+                return false;
+            if (record.time < 0)
+            {
+                record.time        = begin;
+                record.timeSize    = pos - begin;
+                record.displaySize = display > begin ? display - begin : pos - begin;
+            }
+            break;
+        }
+        case OpType::Level:
+            if (!matchLevel(line, size, pos, record.type))
+                return false;
+            break;
+        case OpType::Line:
+        {
+            const auto begin = pos;
+            while (pos < size && isDigit(line[pos]))
+                pos++;
+            if (pos == begin)
+                return false;
+            break;
+        }
+        case OpType::File:
+        case OpType::Function:
+        case OpType::Category:
+        {
+            // 字段内容可能包含其后的文本, 依次尝试每个出现位置
+            const auto& next = m_steps[step + 1].text;
+            const auto saved = record;
+            for (auto at = pos; at + next.size() <= size; at++)
+            {
+                if (startsWith(line, size, at, next) && matchSteps(step + 1, line, size, at, record))
+                    return true;
+                record = saved;
+            }
+            return false;
+        }
+        default:
+            break;
+        }
+    }
+    record.message = pos;
+    return true;
+}
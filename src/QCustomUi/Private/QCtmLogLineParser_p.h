@@ -0,0 +1,60 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include "QCtmLogFormatter_p.h"
+
+#include <QString>
+
+#include <vector>
+
+/*
+    按日志行格式识别日志文件中的记录, 格式与 QCtmLogFormatter 相同.
+    只接受 {msg} 之前字段可以定位的格式: {msg} 恰好出现一次且之后只有 {repeat}, {msg} 之前不换行,
+    {file} {function} {category} 不能位于行首且其后必须紧跟文本, 匹配时依次尝试该文本的每个出现位置.
+    不能匹配格式的行属于上一条记录的多行消息.
+*/
+class QCtmLogLineParser
+{
+public:
+    // 记录首行中各字段的位置
+    struct Record
+    {
+        quint8 type { QtMsgType::QtInfoMsg };
+        qint64 time { -1 }; // 格式中没有时间字段时为 -1
+        qint64 timeSize { 0 };
+        qint64 displaySize { 0 }; // 显示的时间文本, 不含末尾的毫秒
+        qint64 message { 0 };
+    };
+
+    QCtmLogLineParser();
+    bool setPattern(const QString& pattern);
+    const QString& pattern() const;
+    bool match(const char* line, qint64 size, Record& record) const;
+    bool parseTime(const char* line, const Record& record, qint64& msecs) const;
+
+private:
+    bool matchSteps(size_t step, const char* line, qint64 size, qint64 pos, Record& record) const;
+
+private:
+    QString m_pattern;
+    std::vector<QCtmLogFormatter::Op> m_steps; // {msg} 之前的操作
+    int m_time { -1 };
+};
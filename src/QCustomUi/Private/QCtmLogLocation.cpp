@@ -0,0 +1,196 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#include "QCtmLogLocation_p.h"
+
+#include <QByteArray>
+#include <QReadWriteLock>
+
+#include <atomic>
+#include <cstring>
+#include <unordered_map>
+
+namespace
+{
+constexpr int ChunkBits = 8;
+constexpr int ChunkSize = 1 << ChunkBits;
+constexpr int MaxChunks = 4096; // 最多驻留 1M 个上下文, 超出后返回空上下文
+
+struct Entry
+{
+    QByteArray file;
+    QByteArray function;
+    QByteArray category;
+    QMessageLogContext context;
+};
+
+struct Table
+{
+    std::atomic<Entry*> chunks[MaxChunks] {};
+    std::unordered_multimap<quint64, quint32> index;
+    quint32 size { 1 }; // 0 为空上下文
+    QReadWriteLock lock;
+
+    Table() { chunks[0] = new Entry[ChunkSize]; }
+};
+
+Table& table()
+{
+    static auto* t = new Table; // 日志记录可能在静态析构期间释放, 驻留表不析构
+    return *t;
+}
+
+inline quint64 hashBytes(quint64 h, const char* str)
+{
+    if (str)
+    {
+        for (; *str; ++str)
+        {
+            h ^= static_cast<unsigned char>(*str);
+            h *= 1099511628211ull;
+        }
+    }
+    h ^= 0xff; // 字段分隔, 避免不同字段拼接后相同
+    h *= 1099511628211ull;
+    return h;
+}
+
+inline bool sameString(const QByteArray& stored, const char* str)
+{
+    if (!str)
+        return stored.isNull();
+    return !stored.isNull() && std::strcmp(stored.constData(), str) == 0;
+}
+
+inline bool sameLocation(const Entry& entry, const QMessageLogContext& context)
+{
+    return entry.context.line == context.line && sameString(entry.file, context.file) && sameString(entry.function, context.function) &&
+           sameString(entry.category, context.category);
+}
+
+inline Entry& entryAt(const Table& t, quint32 id)
+{
+    return t.chunks[id >> ChunkBits].load(std::memory_order_acquire)[id & (ChunkSize - 1)];
+}
+
+inline QByteArray copyString(const char* str)
+{
+    return str ? QByteArray(str) : QByteArray();
+}
+
+// 调用点的上下文字符串通常是常量, 按地址与行号缓存编号
+struct CallSite
+{
+    const char* file;
+    const char* function;
+    const char* category;
+    int line;
+    quint32 id;
+};
+
+constexpr quintptr CallSiteCacheSize = 256;
+
+inline quintptr callSiteSlot(const QMessageLogContext& context)
+{
+    auto key = reinterpret_cast<quintptr>(context.file) ^ (reinterpret_cast<quintptr>(context.function) >> 4) ^
+               (reinterpret_cast<quintptr>(context.category) >> 8) ^ static_cast<quintptr>(context.line) * 0x9e3779b1u;
+    return (key ^ (key >> 12)) & (CallSiteCacheSize - 1);
+}
+
+quint32 internSlow(Table& t, const QMessageLogContext& context)
+{
+    quint64 hash = 14695981039346656037ull;
+    hash         = hashBytes(hash, context.file);
+    hash         = hashBytes(hash, context.function);
+    hash         = hashBytes(hash, context.category);
+    hash ^= static_cast<quint32>(context.line);
+    hash *= 1099511628211ull;
+
+    {
+        QReadLocker locker(&t.lock);
+        auto range = t.index.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (sameLocation(entryAt(t, it->second), context))
+                return it->second;
+        }
+    }
+
+    QWriteLocker locker(&t.lock);
+    auto range = t.index.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (sameLocation(entryAt(t, it->second), context))
+            return it->second;
+    }
+    const auto id    = t.size;
+    const auto chunk = id >> ChunkBits;
+    if (chunk >= MaxChunks)
+        return 0;
+    if (!t.chunks[chunk].load(std::memory_order_relaxed))
+        t.chunks[chunk].store(new Entry[ChunkSize], std::memory_order_release);
+
+    auto& entry            = entryAt(t, id);
+    entry.file             = copyString(context.file);
+    entry.function         = copyString(context.function);
+    entry.category         = copyString(context.category);
+    entry.context.file     = entry.file.isNull() ? nullptr : entry.file.constData();
+    entry.context.function = entry.function.isNull() ? nullptr : entry.function.constData();
+    entry.context.category = entry.category.isNull() ? nullptr : entry.category.constData();
+    entry.context.line     = context.line;
+    t.index.emplace(hash, id);
+    ++t.size;
+    return id;
+}
+} // namespace
+
+quint32 QCtmLogLocation::intern(const QMessageLogContext& context)
+{
+    if (!context.file && !context.function && !context.category && !context.line)
+        return 0;
+
+    // 每个线程独立的直接映射缓存, 命中时不计算哈希也不加锁.
+    // 地址相同而内容已变化的上下文 (如动态生成的字符串) 由 sameLocation 排除, 缓存的编号只来自本线程, 读取条目无需同步
+    thread_local CallSite callSites[CallSiteCacheSize] {};
+    auto& t    = table();
+    auto& site = callSites[callSiteSlot(context)];
+    if (site.id && site.file == context.file && site.function == context.function && site.category == context.category &&
+        site.line == context.line && sameLocation(entryAt(t, site.id), context))
+        return site.id;
+
+    const auto id = internSlow(t, context);
+    if (id)
+        site = { context.file, context.function, context.category, context.line, id };
+    return id;
+}
+
+const QMessageLogContext& QCtmLogLocation::context(quint32 id)
+{
+    const auto& t = table();
+    if ((id >> ChunkBits) >= MaxChunks || !t.chunks[id >> ChunkBits].load(std::memory_order_acquire))
+        return entryAt(t, 0).context;
+    return entryAt(t, id).context;
+}
+
+int QCtmLogLocation::count()
+{
+    auto& t = table();
+    QReadLocker locker(&t.lock);
+    return static_cast<int>(t.size);
+}
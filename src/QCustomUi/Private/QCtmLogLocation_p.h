@@ -0,0 +1,36 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include <QtGlobal>
+#include <qlogging.h>
+
+/*
+    日志上下文 (文件, 行号, 函数, 分类) 的驻留表.
+    相同的上下文只保存一份, 日志记录中仅保存32位的编号, 编号 0 表示空上下文.
+    驻留后的上下文地址在程序运行期间保持不变, 读取不需要加锁.
+    intern 先查询线程内按调用点地址缓存的编号, 未命中时才计算哈希并加锁查询驻留表.
+*/
+namespace QCtmLogLocation
+{
+quint32 intern(const QMessageLogContext& context);
+const QMessageLogContext& context(quint32 id);
+int count();
+} // namespace QCtmLogLocation
@@ -0,0 +1,125 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+/*
+    定长内存块池, 按块大小区分实例, 每次向系统申请一组内存块, 释放的内存块回到空闲链表中复用, 不归还系统.
+*/
+template<size_t BlockSize, size_t BlockAlign>
+class QCtmLogPool
+{
+public:
+    static QCtmLogPool& instance()
+    {
+        static auto* pool = new QCtmLogPool; // 日志记录可能在静态析构期间释放, 内存池不析构
+        return *pool;
+    }
+
+    void* allocate()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        if (!m_free)
+            grow();
+        auto block = m_free;
+        m_free     = block->next;
+        return block;
+    }
+
+    void deallocate(void* p)
+    {
+        auto block = static_cast<Block*>(p);
+        std::lock_guard<std::mutex> locker(m_mutex);
+        block->next = m_free;
+        m_free      = block;
+    }
+
+private:
+    union alignas(BlockAlign) Block
+    {
+        Block* next;
+        unsigned char storage[BlockSize];
+    };
+
+    static constexpr size_t BlocksPerChunk = 1024;
+
+    void grow()
+    {
+        auto chunk = std::make_unique<Block[]>(BlocksPerChunk);
+        for (size_t i = 0; i < BlocksPerChunk; ++i)
+        {
+            chunk[i].next = m_free;
+            m_free        = &chunk[i];
+        }
+        m_chunks.push_back(std::move(chunk));
+    }
+
+private:
+    std::mutex m_mutex;
+    Block* m_free { nullptr };
+    std::vector<std::unique_ptr<Block[]>> m_chunks;
+};
+
+/*
+    从 QCtmLogPool 分配单个对象的分配器, 用于 std::allocate_shared, 对象与控制块位于同一内存块中.
+*/
+template<typename T>
+struct QCtmLogPoolAllocator
+{
+    using value_type = T;
+
+    QCtmLogPoolAllocator() noexcept = default;
+    template<typename U>
+    QCtmLogPoolAllocator(const QCtmLogPoolAllocator<U>&) noexcept
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        if (n == 1)
+            return static_cast<T*>(QCtmLogPool<sizeof(T), alignof(T)>::instance().allocate());
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept
+    {
+        if (n == 1)
+            QCtmLogPool<sizeof(T), alignof(T)>::instance().deallocate(p);
+        else
+            ::operator delete(p);
+    }
+
+    template<typename U>
+    bool operator==(const QCtmLogPoolAllocator<U>&) const noexcept
+    {
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const QCtmLogPoolAllocator<U>&) const noexcept
+    {
+        return false;
+    }
+};
@@ -0,0 +1,123 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/*
+    有界无锁队列, 多生产者/多消费者, 基于序号的环形缓冲区 (Dmitry Vyukov).
+    容量向上取整为2的幂, 队列满时 tryPush 返回 false, 由调用方决定丢弃或等待.
+*/
+template<typename T>
+class QCtmLogQueue
+{
+public:
+    explicit QCtmLogQueue(size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+        m_mask  = size - 1;
+        m_cells = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; ++i)
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    QCtmLogQueue(const QCtmLogQueue&)            = delete;
+    QCtmLogQueue& operator=(const QCtmLogQueue&) = delete;
+
+    bool tryPush(T&& value)
+    {
+        Cell* cell;
+        auto pos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell     = &m_cells[pos & m_mask];
+            auto seq = cell->sequence.load(std::memory_order_acquire);
+            auto dif = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (dif == 0)
+            {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (dif < 0)
+                return false; // 已满
+            else
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+        cell->data = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& value)
+    {
+        Cell* cell;
+        auto pos = m_dequeuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell     = &m_cells[pos & m_mask];
+            auto seq = cell->sequence.load(std::memory_order_acquire);
+            auto dif = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (dif == 0)
+            {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (dif < 0)
+                return false; // 已空
+            else
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+        }
+        value = std::move(cell->data);
+        cell->data = T {};
+        cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*
+        近似深度, 并发读写时仅作为统计与准入判断使用.
+    */
+    size_t size() const
+    {
+        auto tail = m_dequeuePos.load(std::memory_order_relaxed);
+        auto head = m_enqueuePos.load(std::memory_order_relaxed);
+        return head > tail ? head - tail : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    size_t capacity() const { return m_mask + 1; }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask { 0 };
+    alignas(64) std::atomic<size_t> m_enqueuePos { 0 };
+    alignas(64) std::atomic<size_t> m_dequeuePos { 0 };
+};
@@ -0,0 +1,110 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+/*
+    固定容量的环形缓冲区, 下标 0 为最旧的元素.
+    尾部追加与头部批量移除均为 O(1), 存储空间随元素增加按需分配, 最多分配 capacity 个元素.
+*/
+template<typename T>
+class QCtmLogRingBuffer
+{
+public:
+    explicit QCtmLogRingBuffer(int capacity = 0) : m_capacity(std::max(capacity, 0)) {}
+
+    int capacity() const { return m_capacity; }
+
+    void setCapacity(int capacity)
+    {
+        capacity = std::max(capacity, 0);
+        if (m_size > capacity)
+            popFront(m_size - capacity);
+        std::vector<T> data;
+        data.reserve(m_size);
+        for (int i = 0; i < m_size; ++i)
+            data.push_back(std::move((*this)[i]));
+        m_data.swap(data);
+        m_head     = 0;
+        m_capacity = capacity;
+    }
+
+    int size() const { return m_size; }
+
+    bool isEmpty() const { return m_size == 0; }
+
+    bool isFull() const { return m_size >= m_capacity; }
+
+    void clear()
+    {
+        m_data.clear();
+        m_head = 0;
+        m_size = 0;
+    }
+
+    // 调用前需保证缓冲区未满
+    void pushBack(T&& value)
+    {
+        if (m_size < static_cast<int>(m_data.size()))
+        {
+            (*this)[m_size] = std::move(value);
+        }
+        else
+        {
+            if (m_head != 0) // 存储未分配满时发生过移除, 先线性化再扩展
+                setCapacity(m_capacity);
+            m_data.push_back(std::move(value));
+        }
+        ++m_size;
+    }
+
+    void popFront(int count)
+    {
+        count = std::min(count, m_size);
+        for (int i = 0; i < count; ++i)
+            (*this)[i] = T {};
+        if (!m_data.empty())
+            m_head = (m_head + count) % static_cast<int>(m_data.size());
+        m_size -= count;
+        if (m_size == 0)
+            m_head = 0;
+    }
+
+    T& operator[](int index) { return m_data[position(index)]; }
+
+    const T& operator[](int index) const { return m_data[position(index)]; }
+
+private:
+    inline int position(int index) const
+    {
+        auto pos = m_head + index;
+        auto end = static_cast<int>(m_data.size());
+        return pos >= end ? pos - end : pos;
+    }
+
+private:
+    std::vector<T> m_data;
+    int m_head { 0 };
+    int m_size { 0 };
+    int m_capacity { 0 };
+};
@@ -0,0 +1,109 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#include "QCtmLogSinkWorker_p.h"
+
+#include <QMutexLocker>
+#include <QThread>
+
+namespace
+{
+constexpr unsigned long IdleFlushMsecs = 1000;
+} // namespace
+
+QCtmLogSinkWorker::QCtmLogSinkWorker(QCtmLogSinkPtr sink) : m_sink(std::move(sink))
+{
+    m_thread = QThread::create([this] { run(); });
+    m_thread->setObjectName("QCtmLogSink");
+    m_thread->start(QThread::LowPriority);
+}
+
+QCtmLogSinkWorker::~QCtmLogSinkWorker() { stop(); }
+
+const QCtmLogSinkPtr& QCtmLogSinkWorker::sink() const { return m_sink; }
+
+void QCtmLogSinkWorker::post(const QCtmLogDataPtr& log)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_mutex);
+#endif
+    if (m_stop)
+        return;
+    if (m_pending.size() >= m_sink->queueCapacity())
+    {
+        m_sink->addDroppedCount(1);
+        return;
+    }
+    m_pending.push_back(log);
+    if (m_pending.size() == 1)
+        m_condition.wakeOne();
+}
+
+bool QCtmLogSinkWorker::stop(unsigned long msecs /* = ULONG_MAX */)
+{
+    {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        QMutexLocker locker(&m_mutex);
+#else
+        QMutexLocker<QMutex> locker(&m_mutex);
+#endif
+        m_stop = true;
+        m_condition.wakeOne();
+    }
+    if (!m_thread)
+        return true;
+    if (!m_thread->wait(msecs))
+        return false; // 输出目标阻塞, 线程保留到其返回为止
+    delete m_thread;
+    m_thread = nullptr;
+    return true;
+}
+
+void QCtmLogSinkWorker::run()
+{
+    QVector<QCtmLogDataPtr> batch;
+    for (;;)
+    {
+        bool stop;
+        {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+            QMutexLocker locker(&m_mutex);
+#else
+            QMutexLocker<QMutex> locker(&m_mutex);
+#endif
+            if (m_pending.isEmpty() && !m_stop)
+                m_condition.wait(&m_mutex, IdleFlushMsecs);
+            batch.swap(m_pending);
+            stop = m_stop;
+        }
+        if (!batch.isEmpty())
+        {
+            m_sink->write(batch);
+            batch.clear();
+        }
+        else
+            m_sink->flush(); // 空闲时刷新
+        if (stop)
+            break;
+    }
+    m_sink->flush();
+    m_sink->close();
+}
@@ -0,0 +1,56 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include "QCtmAbstractLogSink.h"
+
+#include <QMutex>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <climits>
+
+class QThread;
+
+/*
+    为一个输出目标提供独立的线程与有界队列, 日志由任意线程投递, 在输出目标的线程中按批写入.
+    队列为空时按固定间隔调用 flush, 停止时写出剩余的日志并在同一线程中调用 close.
+*/
+class QCtmLogSinkWorker
+{
+public:
+    explicit QCtmLogSinkWorker(QCtmLogSinkPtr sink);
+    ~QCtmLogSinkWorker();
+
+    const QCtmLogSinkPtr& sink() const;
+    void post(const QCtmLogDataPtr& log);
+    bool stop(unsigned long msecs = ULONG_MAX);
+
+private:
+    void run();
+
+private:
+    QCtmLogSinkPtr m_sink;
+    QMutex m_mutex;
+    QWaitCondition m_condition;
+    QThread* m_thread { nullptr };
+    QVector<QCtmLogDataPtr> m_pending;
+    bool m_stop { false };
+};
@@ -0,0 +1,112 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#include "QCtmLogStream_p.h"
+
+#include <QDataStream>
+#include <QIODevice>
+#include <QtEndian>
+
+namespace
+{
+inline QByteArray frame(const QByteArray& payload)
+{
+    QByteArray out(4, Qt::Uninitialized);
+    qToBigEndian<quint32>(static_cast<quint32>(payload.size()), out.data());
+    out.append(payload);
+    return out;
+}
+
+inline QByteArray nullable(const char* str) { return str ? QByteArray(str) : QByteArray(); }
+
+inline const char* nullable(const QByteArray& str) { return str.isNull() ? nullptr : str.constData(); }
+} // namespace
+
+QByteArray QCtmLogStream::encodeHello(const QString& source)
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << static_cast<quint8>(Hello) << source;
+    return frame(payload);
+}
+
+QByteArray QCtmLogStream::encodeRecords(const QVector<QCtmLogDataPtr>& logs)
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << static_cast<quint8>(Records) << static_cast<quint32>(logs.size());
+    for (const auto& log : logs)
+    {
+        const auto& context = log->context();
+        out << static_cast<quint8>(log->type()) << log->msecsSinceEpoch() << log->repeatCount() << nullable(context.file)
+            << static_cast<qint32>(context.line) << nullable(context.function) << nullable(context.category) << log->msg();
+    }
+    return frame(payload);
+}
+
+bool QCtmLogStream::decode(QByteArray& buffer, const QString& prefix, Frame& frame, bool& error)
+{
+    error = false;
+    if (buffer.size() < 4)
+        return false;
+    const auto size = qFromBigEndian<quint32>(buffer.constData());
+    if (size > MaxFrameBytes)
+    {
+        error = true;
+        return false;
+    }
+    if (static_cast<quint32>(buffer.size()) - 4 < size)
+        return false;
+
+    const auto payload = QByteArray::fromRawData(buffer.constData() + 4, static_cast<int>(size));
+    QDataStream in(payload);
+    in.setVersion(QDataStream::Qt_5_12);
+    in >> frame.kind;
+    if (frame.kind == Hello)
+    {
+        in >> frame.source;
+    }
+    else if (frame.kind == Records)
+    {
+        quint32 count;
+        in >> count;
+        for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++)
+        {
+            quint8 level;
+            qint64 msecs;
+            quint32 repeat;
+            QByteArray file, function, category;
+            qint32 line;
+            QString msg;
+            in >> level >> msecs >> repeat >> file >> line >> function >> category >> msg;
+            if (in.status() != QDataStream::Ok || level > QtMsgType::QtInfoMsg)
+                break;
+            const QMessageLogContext context(nullable(file), line, nullable(function), nullable(category));
+            auto log = QCtmLogData::create(static_cast<QtMsgType>(level), QCtmLogData::internLocation(context), prefix + msg, msecs);
+            if (repeat > 1)
+                log->setRepeatCount(repeat);
+            frame.logs.push_back(std::move(log));
+        }
+    }
+    error = in.status() != QDataStream::Ok;
+    buffer.remove(0, static_cast<int>(size) + 4);
+    return !error;
+}
@@ -0,0 +1,58 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include "QCtmLogData.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+/*
+    日志流的帧格式, QCtmLogSocketSink 与 QCtmLogSocketReceiver 共用.
+    帧: [4字节大端长度][负载], 负载以 QDataStream (Qt_5_12) 编码, 首字节为帧类型.
+    Hello: 来源名称; Records: 日志数量, 之后每条为 类型、时间、重复次数、文件、行号、函数、分类、内容.
+*/
+namespace QCtmLogStream
+{
+enum Kind : quint8
+{
+    Hello = 1,
+    Records
+};
+
+constexpr quint32 MaxFrameBytes = 64 * 1024 * 1024; // 损坏数据保护
+
+struct Frame
+{
+    quint8 kind { 0 };
+    QString source;
+    QVector<QCtmLogDataPtr> logs;
+};
+
+QByteArray encodeHello(const QString& source);
+QByteArray encodeRecords(const QVector<QCtmLogDataPtr>& logs);
+
+/*
+    从 buffer 头部解析一个完整的帧到 frame 并移除, 日志内容前附加 prefix.
+    数据不完整时返回 false 并保留 buffer, 帧损坏时设置 error 并返回 false.
+*/
+bool decode(QByteArray& buffer, const QString& prefix, Frame& frame, bool& error);
+} // namespace QCtmLogStream
@@ -0,0 +1,171 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#include "QCtmLogThrottle_p.h"
+
+#include <algorithm>
+
+void QCtmLogThrottle::setWindow(int msec)
+{
+    m_window = std::max(msec, 0);
+    updateEnabled();
+}
+
+int QCtmLogThrottle::window() const { return m_window; }
+
+void QCtmLogThrottle::setRate(int perSecond)
+{
+    m_rate = std::max(perSecond, 0);
+    updateEnabled();
+}
+
+int QCtmLogThrottle::rate() const { return m_rate; }
+
+void QCtmLogThrottle::setBurst(int count) { m_burst = std::max(count, 0); }
+
+int QCtmLogThrottle::burst() const { return m_burst; }
+
+bool QCtmLogThrottle::enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+/*!
+    \brief      判断日志 \a type, \a location, \a msg 是否放行, \a now 为当前时间.
+                同一位置已到期的重复摘要追加到 \a summaries.
+*/
+bool QCtmLogThrottle::admit(QtMsgType type, quint32 location, const QString& msg, qint64 now, std::vector<Summary>& summaries)
+{
+    if (type == QtMsgType::QtFatalMsg)
+        return true;
+    auto& shard       = m_shards[location % ShardCount];
+    const auto window = m_window.load(std::memory_order_relaxed);
+    const auto rate   = m_rate.load(std::memory_order_relaxed);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&shard.mutex);
+#else
+    QMutexLocker<QMutex> locker(&shard.mutex);
+#endif
+    if (window > 0)
+    {
+        Key key { location, static_cast<quint8>(type), msg };
+        auto it = shard.entries.find(key);
+        if (it != shard.entries.end())
+        {
+            if (now - it->start < window)
+            {
+                it->suppressed++;
+                it->last = now;
+                m_suppressed.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (it->suppressed > 0)
+                summaries.push_back({ type, location, msg, it->last, it->suppressed });
+            *it = { now, now, 0 };
+        }
+        else
+        {
+            if (shard.entries.size() >= MaxEntries)
+            {
+                for (auto entry = shard.entries.cbegin(); entry != shard.entries.cend(); ++entry)
+                {
+                    if (entry->suppressed > 0)
+                    {
+                        const auto& k = entry.key();
+                        summaries.push_back({ static_cast<QtMsgType>(k.type), k.location, k.msg, entry->last, entry->suppressed });
+                    }
+                }
+                shard.entries.clear();
+            }
+            shard.entries.insert(std::move(key), { now, now, 0 });
+        }
+    }
+    if (rate > 0)
+    {
+        const double burst = std::max(m_burst.load(std::memory_order_relaxed), 1);
+        auto it            = shard.buckets.find(location);
+        if (it == shard.buckets.end())
+            it = shard.buckets.insert(location, { burst, now });
+        it->tokens = std::min(burst, it->tokens + static_cast<double>(now - it->last) * rate / 1000.0);
+        it->last   = now;
+        if (it->tokens < 1.0)
+        {
+            m_rateLimited.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        it->tokens -= 1.0;
+    }
+    return true;
+}
+
+/*!
+    \brief      输出窗口已结束 (\a all 为 true 时为全部) 的重复摘要到 \a summaries 并清理过期的状态, \a now 为当前时间.
+*/
+void QCtmLogThrottle::collect(qint64 now, std::vector<Summary>& summaries, bool all)
+{
+    const auto window = m_window.load(std::memory_order_relaxed);
+    const auto rate   = m_rate.load(std::memory_order_relaxed);
+    for (auto& shard : m_shards)
+    {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        QMutexLocker locker(&shard.mutex);
+#else
+        QMutexLocker<QMutex> locker(&shard.mutex);
+#endif
+        for (auto it = shard.entries.begin(); it != shard.entries.end();)
+        {
+            if (all || now - it->start >= window)
+            {
+                if (it->suppressed > 0)
+                {
+                    const auto& key = it.key();
+                    summaries.push_back({ static_cast<QtMsgType>(key.type), key.location, key.msg, it->last, it->suppressed });
+                }
+                it = shard.entries.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        // 令牌已回满的桶与新建的桶等价
+        const auto full = rate > 0 ? static_cast<qint64>(1000.0 * std::max(m_burst.load(std::memory_order_relaxed), 1) / rate) : 0;
+        for (auto it = shard.buckets.begin(); it != shard.buckets.end();)
+        {
+            if (rate == 0 || now - it->last >= full)
+                it = shard.buckets.erase(it);
+            else
+                ++it;
+        }
+    }
+}
+
+/*!
+    \brief      距上一次收集超过去重窗口时返回 true, 同一时刻只有一个调用者返回 true.
+*/
+bool QCtmLogThrottle::collectDue(qint64 now)
+{
+    auto next = m_nextCollect.load(std::memory_order_relaxed);
+    if (now < next)
+        return false;
+    return m_nextCollect.compare_exchange_strong(next, now + std::max(m_window.load(std::memory_order_relaxed), 100));
+}
+
+quint64 QCtmLogThrottle::suppressedCount() const { return m_suppressed; }
+
+quint64 QCtmLogThrottle::rateLimitedCount() const { return m_rateLimited; }
+
+void QCtmLogThrottle::updateEnabled() { m_enabled = m_window > 0 || m_rate > 0; }
@@ -0,0 +1,109 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+#include <atomic>
+#include <vector>
+
+/*
+    日志去重与限流.
+    去重: 时间窗口内相同 (等级, 位置, 内容) 的日志只放行第一条, 其余计数, 窗口结束后输出一条带重复次数的摘要.
+    限流: 每个位置 (文件与行号) 一个令牌桶, 令牌不足时丢弃并计数. Fatal 日志不受影响.
+    状态按位置分片加锁, 未开启时 enabled 只读取一个原子变量.
+*/
+class QCtmLogThrottle
+{
+public:
+    struct Summary
+    {
+        QtMsgType type;
+        quint32 location;
+        QString msg;
+        qint64 msecs;
+        quint32 repeat;
+    };
+
+    void setWindow(int msec);
+    int window() const;
+    void setRate(int perSecond);
+    int rate() const;
+    void setBurst(int count);
+    int burst() const;
+    bool enabled() const;
+    bool admit(QtMsgType type, quint32 location, const QString& msg, qint64 now, std::vector<Summary>& summaries);
+    void collect(qint64 now, std::vector<Summary>& summaries, bool all = false);
+    bool collectDue(qint64 now);
+    quint64 suppressedCount() const;
+    quint64 rateLimitedCount() const;
+
+private:
+    struct Key
+    {
+        quint32 location;
+        quint8 type;
+        QString msg;
+
+        inline bool operator==(const Key& other) const
+        {
+            return location == other.location && type == other.type && msg == other.msg;
+        }
+
+        friend inline size_t qHash(const Key& key, size_t seed = 0) { return qHash(key.msg, seed) ^ (key.location * 31u + key.type); }
+    };
+
+    struct Entry
+    {
+        qint64 start;
+        qint64 last;
+        quint32 suppressed;
+    };
+
+    struct Bucket
+    {
+        double tokens;
+        qint64 last;
+    };
+
+    struct Shard
+    {
+        QMutex mutex;
+        QHash<Key, Entry> entries;
+        QHash<quint32, Bucket> buckets;
+    };
+
+    void updateEnabled();
+
+private:
+    static constexpr int ShardCount = 16;
+    static constexpr int MaxEntries = 4096; // 每个分片, 超出时提前输出摘要
+
+    Shard m_shards[ShardCount];
+    std::atomic_bool m_enabled { false };
+    std::atomic_int m_window { 0 };
+    std::atomic_int m_rate { 0 };
+    std::atomic_int m_burst { 0 };
+    std::atomic<qint64> m_nextCollect { 0 };
+    std::atomic<quint64> m_suppressed { 0 };
+    std::atomic<quint64> m_rateLimited { 0 };
+};
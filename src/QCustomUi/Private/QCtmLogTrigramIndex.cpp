@@ -0,0 +1,195 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#include "QCtmLogTrigramIndex_p.h"
+
+#include <QRegularExpression>
+
+#include <algorithm>
+
+/*!
+    \brief      追加最新一行 \a text.
+*/
+void QCtmLogTrigramIndex::add(const QString& text)
+{
+    trigrams(text, m_keys);
+    const auto id = m_next++;
+    for (auto key : m_keys)
+    {
+        m_postings[key].ids.push_back(id);
+    }
+}
+
+/*!
+    \brief      移除最旧的一行, \a text 为该行添加时的内容.
+*/
+void QCtmLogTrigramIndex::removeFront(const QString& text)
+{
+    if (m_first == m_next)
+        return;
+    const auto id = m_first++;
+    trigrams(text, m_keys);
+    for (auto key : m_keys)
+    {
+        auto it = m_postings.find(key);
+        if (it == m_postings.end())
+            continue;
+        auto& posting = it->second;
+        if (posting.head < posting.ids.size() && posting.ids[posting.head] == id)
+            posting.head++;
+        if (posting.head == posting.ids.size())
+        {
+            m_postings.erase(it);
+        }
+        else if (posting.head >= 64 && posting.head * 2 >= posting.ids.size())
+        {
+            posting.ids.erase(posting.ids.begin(), posting.ids.begin() + posting.head);
+            posting.head = 0;
+        }
+    }
+}
+
+/*!
+    \brief      清空索引.
+*/
+void QCtmLogTrigramIndex::clear()
+{
+    m_postings.clear();
+    m_first = 0;
+    m_next  = 0;
+}
+
+/*!
+    \brief      查询可能同时包含 \a terms 中全部关键字的行, 以升序写入 \a rows.
+    \return     所有关键字都短于3个字符时无法使用索引, 返回 false.
+*/
+bool QCtmLogTrigramIndex::candidates(const QStringList& terms, std::vector<quint32>& rows) const
+{
+    rows.clear();
+    std::vector<const Posting*> lists;
+    for (const auto& term : terms)
+    {
+        trigrams(term, m_keys);
+        for (auto key : m_keys)
+        {
+            auto it = m_postings.find(key);
+            if (it == m_postings.end())
+                return true; // 必然没有匹配的行
+            lists.push_back(&it->second);
+        }
+    }
+    if (lists.empty())
+        return false;
+
+    auto size = [](const Posting* posting) { return posting->ids.size() - posting->head; };
+    std::sort(lists.begin(), lists.end(), [&](const Posting* l, const Posting* r) { return size(l) != size(r) ? size(l) < size(r) : l < r; });
+    lists.erase(std::unique(lists.begin(), lists.end()), lists.end());
+    rows.assign(lists.front()->ids.begin() + lists.front()->head, lists.front()->ids.end());
+    // 由短到长求交集, 在较长的倒排表中二分查找
+    for (size_t i = 1; i < lists.size() && !rows.empty(); i++)
+    {
+        auto begin = lists[i]->ids.begin() + lists[i]->head;
+        auto end   = lists[i]->ids.end();
+        auto out   = rows.begin();
+        for (auto id : rows)
+        {
+            begin = std::lower_bound(begin, end, id);
+            if (begin == end)
+                break;
+            if (*begin == id)
+                *out++ = id;
+        }
+        rows.erase(out, rows.end());
+    }
+    return true;
+}
+
+/*!
+    \brief      返回最旧一行的编号.
+*/
+quint32 QCtmLogTrigramIndex::firstId() const
+{
+    return m_first;
+}
+
+/*!
+    \brief      返回下一行的编号.
+*/
+quint32 QCtmLogTrigramIndex::nextId() const
+{
+    return m_next;
+}
+
+/*!
+    \brief      返回索引占用内存的估计值, 单位为字节.
+*/
+qint64 QCtmLogTrigramIndex::memoryUsage() const
+{
+    // 哈希表节点包含键值、下一节点指针与缓存的哈希值
+    constexpr qint64 node = sizeof(std::pair<const quint64, Posting>) + 2 * sizeof(void*);
+    qint64 bytes          = static_cast<qint64>(m_postings.bucket_count() * sizeof(void*));
+    for (const auto& [key, posting] : m_postings)
+    {
+        bytes += node + static_cast<qint64>(posting.ids.capacity() * sizeof(quint32));
+    }
+    return bytes;
+}
+
+/*!
+    \brief      将 \a keywords 按空白拆分为关键字.
+*/
+QStringList QCtmLogTrigramIndex::terms(const QString& keywords)
+{
+    static const QRegularExpression space("\\s+");
+#if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
+    return keywords.split(space, QString::SkipEmptyParts);
+#else
+    return keywords.split(space, Qt::SkipEmptyParts);
+#endif
+}
+
+/*!
+    \brief      返回索引能否缩小 \a terms 的查询范围, 即至少有一个关键字不短于3个字符.
+                不能时 candidates 返回 false, 调用方需要逐行查询.
+*/
+bool QCtmLogTrigramIndex::indexable(const QStringList& terms)
+{
+    return std::any_of(terms.begin(), terms.end(), [](const QString& term) { return term.size() >= 3; });
+}
+
+/*!
+    \brief      提取 \a text 折叠大小写后的全部三元组并去重, 写入 \a keys.
+*/
+void QCtmLogTrigramIndex::trigrams(const QString& text, std::vector<quint64>& keys)
+{
+    keys.clear();
+    const auto size = text.size();
+    if (size < 3)
+        return;
+    const auto* data = text.constData();
+    quint64 key      = (quint64(data[0].toCaseFolded().unicode()) << 16) | data[1].toCaseFolded().unicode();
+    keys.reserve(size - 2);
+    for (decltype(text.size()) i = 2; i < size; i++)
+    {
+        key = ((key << 16) | data[i].toCaseFolded().unicode()) & 0xffffffffffffull;
+        keys.push_back(key);
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+}
@@ -0,0 +1,62 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+#include <unordered_map>
+#include <vector>
+
+/*
+    日志消息的三元组倒排索引, 行按追加顺序编号, 只支持追加最新行与移除最旧行.
+    消息按 UTF-16 码元折叠大小写后, 每3个连续码元组成一个三元组, 倒排表中的行号保持升序.
+    candidates 给出可能包含全部关键字的行, 调用方仍需逐行确认.
+*/
+class QCtmLogTrigramIndex
+{
+public:
+    void add(const QString& text);
+    void removeFront(const QString& text);
+    void clear();
+    bool candidates(const QStringList& terms, std::vector<quint32>& rows) const;
+    quint32 firstId() const;
+    quint32 nextId() const;
+    qint64 memoryUsage() const;
+
+    static QStringList terms(const QString& keywords);
+    static bool indexable(const QStringList& terms);
+
+private:
+    // 移除最旧的行时只前移 head, 累积到一定数量再压缩
+    struct Posting
+    {
+        std::vector<quint32> ids;
+        size_t head { 0 };
+    };
+
+    static void trigrams(const QString& text, std::vector<quint64>& keys);
+
+private:
+    std::unordered_map<quint64, Posting> m_postings;
+    quint32 m_first { 0 };
+    quint32 m_next { 0 };
+    mutable std::vector<quint64> m_keys;
+};
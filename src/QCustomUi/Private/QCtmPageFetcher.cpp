@@ -0,0 +1,123 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#include "QCtmPageFetcher_p.h"
+
+#include <QMutexLocker>
+#include <QThread>
+
+#include <utility>
+
+QCtmPageFetcher::QCtmPageFetcher()
+{
+    m_thread = QThread::create([this] { run(); });
+    m_thread->setObjectName("QCtmPageFetcher");
+    m_thread->start();
+}
+
+QCtmPageFetcher::~QCtmPageFetcher()
+{
+    {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        QMutexLocker locker(&m_mutex);
+#else
+        QMutexLocker<QMutex> locker(&m_mutex);
+#endif
+        m_stop = true;
+        m_condition.wakeOne();
+    }
+    m_thread->wait(); // 等待正在进行的读取返回
+    delete m_thread;
+}
+
+void QCtmPageFetcher::reset(PageJob fetch, Job prepare /* = {} */)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_mutex);
+#endif
+    m_fetch    = std::move(fetch);
+    m_prepare  = std::move(prepare);
+    m_inFlight = -1;
+    m_queue.clear();
+    m_condition.wakeOne();
+}
+
+void QCtmPageFetcher::request(const QVector<int>& pages)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_mutex);
+#endif
+    m_queue.clear();
+    for (auto page : pages)
+    {
+        if (page != m_inFlight)
+            m_queue.push_back(page);
+    }
+    if (!m_queue.isEmpty())
+        m_condition.wakeOne();
+}
+
+void QCtmPageFetcher::run()
+{
+    for (;;)
+    {
+        PageJob fetch;
+        Job prepare;
+        int page = -1;
+        {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+            QMutexLocker locker(&m_mutex);
+#else
+            QMutexLocker<QMutex> locker(&m_mutex);
+#endif
+            while (!m_stop && !m_prepare && (m_queue.isEmpty() || !m_fetch))
+                m_condition.wait(&m_mutex);
+            if (m_stop)
+                break;
+            if (m_prepare)
+                prepare = std::exchange(m_prepare, nullptr);
+            else
+            {
+                fetch      = m_fetch;
+                page       = m_queue.takeFirst();
+                m_inFlight = page;
+            }
+        }
+
+        if (prepare)
+        {
+            prepare();
+            continue;
+        }
+        fetch(page);
+        {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+            QMutexLocker locker(&m_mutex);
+#else
+            QMutexLocker<QMutex> locker(&m_mutex);
+#endif
+            if (m_inFlight == page)
+                m_inFlight = -1;
+        }
+    }
+}
@@ -0,0 +1,58 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include <QMutex>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <functional>
+
+class QThread;
+
+/*
+    在独立线程中读取分页数据. 读取方式由调用方以任务的形式提供, 任务自行把结果交回 GUI 线程.
+    请求队列每次整体替换, 离开当前页附近的请求被直接丢弃; 重置后先执行一次准备任务 (如查询总行数) 再读取页面.
+*/
+class QCtmPageFetcher
+{
+public:
+    using PageJob = std::function<void(int page)>;
+    using Job     = std::function<void()>;
+
+    QCtmPageFetcher();
+    ~QCtmPageFetcher();
+
+    void reset(PageJob fetch, Job prepare = {});
+    void request(const QVector<int>& pages);
+
+private:
+    void run();
+
+private:
+    QMutex m_mutex;
+    QWaitCondition m_condition;
+    QThread* m_thread { nullptr };
+    PageJob m_fetch;
+    Job m_prepare;
+    QVector<int> m_queue;
+    int m_inFlight { -1 };
+    bool m_stop { false };
+};
@@ -0,0 +1,68 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#include "QCtmAbstractCursorPageProvider.h"
+
+/*!
+    \class      QCtmAbstractCursorPageProvider
+    \brief      基于游标的分页数据提供者基类, 为 QCtmCursorMultiPageTableModel 按页提供数据.
+                适用于无法预先得知总行数的数据源, 如按主键范围 (keyset) 分页的 SQL 查询、流式接口等.
+                fetch 在 model 的工作线程中调用, columnCount 与 headerData 在 GUI 线程中调用.
+    \ingroup    QCustomUi
+    \inmodule   QCustomUi
+    \inheaderfile QCtmAbstractCursorPageProvider.h
+    \sa         QCtmCursorMultiPageTableModel
+*/
+
+/*!
+    \class      QCtmAbstractCursorPageProvider::Page
+    \brief      一页数据 rows 与下一页的游标 next, next 无效表示没有更多数据.
+    \inmodule   QCustomUi
+*/
+
+/*!
+    \fn         int QCtmAbstractCursorPageProvider::columnCount() const
+    \brief      返回列数量, 在 GUI 线程中调用.
+*/
+
+/*!
+    \fn         QCtmAbstractCursorPageProvider::Page QCtmAbstractCursorPageProvider::fetch(const QVariant& cursor, int count)
+    \brief      返回游标 \a cursor 处开始的至多 \a count 行数据及下一页的游标, 在工作线程中调用.
+                第一页的 \a cursor 为无效的 QVariant, 其余页的游标为上一页返回的 next.
+*/
+
+/*!
+    \brief      构造函数.
+*/
+QCtmAbstractCursorPageProvider::QCtmAbstractCursorPageProvider() {}
+
+/*!
+    \brief      析构函数.
+*/
+QCtmAbstractCursorPageProvider::~QCtmAbstractCursorPageProvider() {}
+
+/*!
+    \brief      返回 \a section 的表头数据 \a orientation, \a role, 在 GUI 线程中调用. 默认不提供表头.
+*/
+QVariant QCtmAbstractCursorPageProvider::headerData(int section,
+                                                    Qt::Orientation orientation,
+                                                    int role /* = Qt::DisplayRole */) const
+{
+    return {};
+}
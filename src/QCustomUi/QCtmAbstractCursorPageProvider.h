@@ -0,0 +1,43 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include "QCtmAbstractPageProvider.h"
+
+class QCUSTOMUI_EXPORT QCtmAbstractCursorPageProvider
+{
+public:
+    using Row = QCtmAbstractPageProvider::Row;
+
+    struct Page
+    {
+        QVector<Row> rows;
+        QVariant next;
+    };
+
+    QCtmAbstractCursorPageProvider();
+    virtual ~QCtmAbstractCursorPageProvider();
+
+    virtual int columnCount() const = 0;
+    virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+    virtual Page fetch(const QVariant& cursor, int count) = 0;
+};
+
+using QCtmCursorPageProviderPtr = std::shared_ptr<QCtmAbstractCursorPageProvider>;
@@ -18,8 +18,27 @@
 **********************************************************************************/
 
 #include "QCtmAbstractLogModel.h"
+#include "QCtmLogData.h"
 #include "QCtmLogManager.h"
 
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTimer>
+
+#include <algorithm>
+
+struct QCtmAbstractLogModel::Impl
+{
+    QMutex mutex;
+    QVector<QCtmLogDataPtr> pending;
+    qint64 oldestPending { 0 };
+    int batchSize { 512 };
+    bool timerPosted { false };
+    bool flushPosted { false };
+    bool subscribed { false };
+    QTimer* timer { nullptr };
+};
+
 /*!
     \class      QCtmAbstractLogModel
     \brief      日志 model 接口类.
@@ -32,10 +51,26 @@
 /*!
     \brief      构造一个日志 model 设置 \a objectName 和父对象 \a parent.
 */
-QCtmAbstractLogModel::QCtmAbstractLogModel(const QString& objectName, QObject* parent) : QAbstractTableModel(parent)
+QCtmAbstractLogModel::QCtmAbstractLogModel(const QString& objectName, QObject* parent)
+    : QCtmAbstractLogModel(objectName, true, parent)
+{
+}
+
+/*!
+    \brief      构造一个日志 model 设置 \a objectName 和父对象 \a parent. \a subscribe 为 false 时不向
+                QCtmLogManager 注册, 不接收实时日志, 用于只读的日志 model (如日志文件).
+*/
+QCtmAbstractLogModel::QCtmAbstractLogModel(const QString& objectName, bool subscribe, QObject* parent)
+    : QAbstractTableModel(parent), m_impl(std::make_unique<Impl>())
 {
     setObjectName(objectName);
-    QCtmLogManager::instance().registerModel(this);
+    m_impl->timer = new QTimer(this);
+    m_impl->timer->setSingleShot(true);
+    m_impl->timer->setInterval(16);
+    connect(m_impl->timer, &QTimer::timeout, this, &QCtmAbstractLogModel::flushBatch);
+    m_impl->subscribed = subscribe;
+    if (subscribe)
+        QCtmLogManager::instance().registerModel(this);
 }
 
 /*!
@@ -43,7 +78,8 @@ QCtmAbstractLogModel::QCtmAbstractLogModel(const QString& objectName, QObject* p
 */
 QCtmAbstractLogModel::~QCtmAbstractLogModel()
 {
-    QCtmLogManager::instance().unRegisterModel(this);
+    if (m_impl->subscribed)
+        QCtmLogManager::instance().unRegisterModel(this);
 }
 
 /*!
@@ -51,6 +87,27 @@ QCtmAbstractLogModel::~QCtmAbstractLogModel()
     \brief      清空日志.
 */
 
+/*!
+    \brief      返回第 \a row 行的完整消息文本, 与消息列 CopyMessageRole 的数据相同.
+                默认通过 data 获取, 子类可以直接返回以避免 QVariant 的转换.
+    \sa         messageReader
+*/
+QString QCtmAbstractLogModel::messageAt(int row) const
+{
+    return index(row, 2).data(CopyMessageRole).toString();
+}
+
+/*!
+    \brief      返回可以在工作线程中调用的消息读取函数, 参数为调用时的行号, 用于在后台批量查询消息.
+                返回的函数持有所需数据的快照, model 之后的变化不影响其安全性. 默认返回空函数, 表示不支持,
+                此时调用者应在 model 所在的线程中使用 messageAt.
+    \sa         messageAt
+*/
+QCtmAbstractLogModel::MessageReader QCtmAbstractLogModel::messageReader() const
+{
+    return {};
+}
+
 /*!
     \reimp
 */
@@ -91,6 +148,52 @@ bool QCtmAbstractLogModel::removeColumns(int column, int count, const QModelInde
     return true;
 }
 
+/*!
+    \brief      设置日志批量投递的时间间隔 \a msec, 间隔内到达的日志合并为一批通过 onLogBatch 投递, 默认为 16 毫秒.
+    \sa         batchInterval, setBatchSize
+*/
+void QCtmAbstractLogModel::setBatchInterval(int msec)
+{
+    m_impl->timer->setInterval(std::max(msec, 0));
+}
+
+/*!
+    \brief      返回日志批量投递的时间间隔.
+    \sa         setBatchInterval
+*/
+int QCtmAbstractLogModel::batchInterval() const
+{
+    return m_impl->timer->interval();
+}
+
+/*!
+    \brief      设置单批日志的最大数量 \a count, 待投递的日志达到该数量时不再等待时间间隔, 立即投递, 默认为 512.
+    \sa         batchSize, setBatchInterval
+*/
+void QCtmAbstractLogModel::setBatchSize(int count)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    m_impl->batchSize = std::max(count, 1);
+}
+
+/*!
+    \brief      返回单批日志的最大数量.
+    \sa         setBatchSize
+*/
+int QCtmAbstractLogModel::batchSize() const
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    return m_impl->batchSize;
+}
+
 /*!
     \brief      重新翻译UI.
 */
@@ -105,6 +208,98 @@ void QCtmAbstractLogModel::onLog(QCtmLogDataPtr)
 {
 }
 
+/*!
+    \brief      响应一批日志 \a logs, 默认逐条调用 onLog, 子类可重写该函数以合并处理整批日志.
+    \sa         onLog, setBatchInterval
+*/
+void QCtmAbstractLogModel::onLogBatch(const QVector<QCtmLogDataPtr>& logs)
+{
+    for (const auto& log : logs)
+    {
+        onLog(log);
+    }
+}
+
+/*!
+    \brief      由日志管理器在任意线程调用, 将日志 \a log 加入待投递队列.
+*/
+void QCtmAbstractLogModel::post(const QCtmLogDataPtr& log)
+{
+    bool startTimer = false;
+    bool flushNow   = false;
+    {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        QMutexLocker locker(&m_impl->mutex);
+#else
+        QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+        if (m_impl->pending.isEmpty())
+            m_impl->oldestPending = log->msecsSinceEpoch();
+        m_impl->pending.push_back(log);
+        if (m_impl->pending.size() >= m_impl->batchSize && !m_impl->flushPosted)
+        {
+            m_impl->flushPosted = true;
+            flushNow            = true;
+        }
+        else if (!m_impl->timerPosted)
+        {
+            m_impl->timerPosted = true;
+            startTimer          = true;
+        }
+    }
+    if (flushNow)
+    {
+        QMetaObject::invokeMethod(this, &QCtmAbstractLogModel::flushBatch, Qt::QueuedConnection);
+    }
+    else if (startTimer)
+    {
+        QMetaObject::invokeMethod(
+            this,
+            [this]()
+            {
+                if (!m_impl->timer->isActive())
+                    m_impl->timer->start();
+            },
+            Qt::QueuedConnection);
+    }
+}
+
+/*!
+    \brief      返回等待投递的日志数量, 并通过 \a oldestMsecs 返回其中最早一条的时间.
+*/
+int QCtmAbstractLogModel::pendingCount(qint64* oldestMsecs) const
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    if (oldestMsecs)
+        *oldestMsecs = m_impl->oldestPending;
+    return static_cast<int>(m_impl->pending.size());
+}
+
+/*!
+    \brief      投递所有待处理的日志.
+*/
+void QCtmAbstractLogModel::flushBatch()
+{
+    QVector<QCtmLogDataPtr> logs;
+    {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        QMutexLocker locker(&m_impl->mutex);
+#else
+        QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+        logs.swap(m_impl->pending);
+        m_impl->timerPosted = false;
+        m_impl->flushPosted = false;
+    }
+    m_impl->timer->stop();
+    if (!logs.isEmpty())
+        onLogBatch(logs);
+}
+
 /*!
     \reimp
 */
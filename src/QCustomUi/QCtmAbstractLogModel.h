@@ -24,25 +24,54 @@
 #include <QAbstractTableModel>
 #include <QApplication>
 
+#include <functional>
 #include <memory>
 
 using QCtmLogDataPtr = std::shared_ptr<class QCtmLogData>;
+class QCtmLogManager;
 class QCUSTOMUI_EXPORT QCtmAbstractLogModel : public QAbstractTableModel
 {
     Q_OBJECT
 
 public:
+    enum
+    {
+        TypeRole = Qt::UserRole + 1,
+        CopyMessageRole,
+        TimeRole
+    };
+
+    using MessageReader = std::function<QString(int row)>;
+
     explicit QCtmAbstractLogModel(const QString& objectName, QObject* parent = nullptr);
     ~QCtmAbstractLogModel();
     virtual void clear() = 0;
+    virtual QString messageAt(int row) const;
+    virtual MessageReader messageReader() const;
     bool insertRows(int row, int count, const QModelIndex& parent = QModelIndex()) override;
     bool insertColumns(int column, int count, const QModelIndex& parent = QModelIndex()) override;
     bool removeRows(int row, int count, const QModelIndex& parent = QModelIndex()) override;
     bool removeColumns(int column, int count, const QModelIndex& parent = QModelIndex()) override;
+    void setBatchInterval(int msec);
+    int batchInterval() const;
+    void setBatchSize(int count);
+    int batchSize() const;
 public slots:
     virtual void onLog(QCtmLogDataPtr) = 0;
+    virtual void onLogBatch(const QVector<QCtmLogDataPtr>& logs);
 
 protected:
+    QCtmAbstractLogModel(const QString& objectName, bool subscribe, QObject* parent);
     bool event(QEvent* e) override;
     virtual void retranslateUi();
+
+private:
+    void post(const QCtmLogDataPtr& log);
+    int pendingCount(qint64* oldestMsecs) const;
+    void flushBatch();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+    friend QCtmLogManager;
 };
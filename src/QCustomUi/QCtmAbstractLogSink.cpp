@@ -0,0 +1,98 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#include "QCtmAbstractLogSink.h"
+
+#include <algorithm>
+#include <atomic>
+
+struct QCtmAbstractLogSink::Impl
+{
+    std::atomic<int> capacity { 65536 };
+    std::atomic<quint64> dropped { 0 };
+};
+
+/*!
+    \class      QCtmAbstractLogSink
+    \brief      日志输出目标接口, 通过 QCtmLogManager::addSink 添加.
+                每个输出目标拥有独立的线程与队列, 从同一日志流中异步获取日志, 慢速的输出目标不会阻塞日志写入或其他输出目标.
+    \ingroup    QCustomUi
+    \inmodule   QCustomUi
+    \inheaderfile QCtmAbstractLogSink.h
+    \sa         QCtmLogFileSink, QCtmLogMemorySink, QCtmLogSocketSink
+*/
+
+/*!
+    \fn         void QCtmAbstractLogSink::write(const QVector<QCtmLogDataPtr>& logs)
+    \brief      在输出目标的线程中写入一批日志 \a logs.
+*/
+
+/*!
+    \brief      构造函数.
+*/
+QCtmAbstractLogSink::QCtmAbstractLogSink() : m_impl(std::make_unique<Impl>()) {}
+
+/*!
+    \brief      析构函数.
+*/
+QCtmAbstractLogSink::~QCtmAbstractLogSink() {}
+
+/*!
+    \brief      在输出目标的线程中空闲时调用, 刷新缓冲的数据, 默认实现为空.
+*/
+void QCtmAbstractLogSink::flush() {}
+
+/*!
+    \brief      输出目标被移除或程序退出时在输出目标的线程中调用, 用于释放在该线程中创建的资源, 默认实现为空.
+*/
+void QCtmAbstractLogSink::close() {}
+
+/*!
+    \brief      设置等待写入的日志数量上限 \a capacity, 超出后新的日志被丢弃, 默认为 65536.
+    \sa         queueCapacity, droppedCount
+*/
+void QCtmAbstractLogSink::setQueueCapacity(int capacity)
+{
+    m_impl->capacity.store(std::max(capacity, 1), std::memory_order_relaxed);
+}
+
+/*!
+    \brief      返回等待写入的日志数量上限.
+    \sa         setQueueCapacity
+*/
+int QCtmAbstractLogSink::queueCapacity() const
+{
+    return m_impl->capacity.load(std::memory_order_relaxed);
+}
+
+/*!
+    \brief      返回因队列已满或输出目标不可用而丢弃的日志数量.
+*/
+quint64 QCtmAbstractLogSink::droppedCount() const
+{
+    return m_impl->dropped.load(std::memory_order_relaxed);
+}
+
+/*!
+    \brief      累加丢弃的日志数量 \a count, 供子类在无法写出日志时调用.
+*/
+void QCtmAbstractLogSink::addDroppedCount(quint64 count)
+{
+    m_impl->dropped.fetch_add(count, std::memory_order_relaxed);
+}
@@ -0,0 +1,52 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include "qcustomui_global.h"
+
+#include <QVector>
+
+#include <memory>
+
+using QCtmLogDataPtr = std::shared_ptr<class QCtmLogData>;
+
+class QCUSTOMUI_EXPORT QCtmAbstractLogSink
+{
+public:
+    QCtmAbstractLogSink();
+    virtual ~QCtmAbstractLogSink();
+
+    virtual void write(const QVector<QCtmLogDataPtr>& logs) = 0;
+    virtual void flush();
+    virtual void close();
+    void setQueueCapacity(int capacity);
+    int queueCapacity() const;
+    quint64 droppedCount() const;
+
+protected:
+    void addDroppedCount(quint64 count);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+    friend class QCtmLogSinkWorker;
+};
+
+using QCtmLogSinkPtr = std::shared_ptr<QCtmAbstractLogSink>;
@@ -28,6 +28,9 @@ struct QCtmAbstractMultiPageItemModel::Impl
     int pageCountCache { 0 };
 
     int tempPageCount { 0 };
+    bool resetting { false };
+    PageChangeMode pageChangeMode { PageChangeMode::FullUpdate };
+    QVector<int> pageChangeRoles { Qt::DisplayRole, Qt::EditRole };
 };
 
 /*!
@@ -39,6 +42,17 @@ struct QCtmAbstractMultiPageItemModel::Impl
     \inheaderfile QCtmAbstractMultiPageItemModel.h
 */
 
+/*!
+    \enum       QCtmAbstractMultiPageItemModel::PageChangeMode
+                切换页面时发送的变更通知.
+    \value      FullUpdate
+                通知当前页所有单元格的所有角色改变, 行数量不同时插入或删除行.
+    \value      BoundedRoles
+                只通知 pageChangeRoles 中的角色改变, 且只覆盖切换前后都存在的行, 新插入的行不再重复通知.
+    \value      Reset
+                以 model 重置代替逐行通知, 代理 model 直接丢弃映射而不逐行重新计算, 视图的当前项与选择会被清除.
+*/
+
 /*!
     \fn         virtual int QCtmAbstractMultiPageItemModel::pageCount() const;
     \brief      返回页面数量.
@@ -76,6 +90,7 @@ QCtmAbstractMultiPageItemModel::QCtmAbstractMultiPageItemModel(QObject* parent /
             this,
             [=]()
             {
+                m_impl->resetting     = true;
                 m_impl->tempPageCount = pageCount();
             });
     connect(this,
@@ -83,6 +98,7 @@ QCtmAbstractMultiPageItemModel::QCtmAbstractMultiPageItemModel(QObject* parent /
             this,
             [=]()
             {
+                m_impl->resetting = false;
                 if (auto pageCount = this->pageCount(); pageCount != m_impl->tempPageCount)
                     emit pageCountChanged(pageCount);
             });
@@ -104,6 +120,20 @@ int QCtmAbstractMultiPageItemModel::currentPage() const
     return m_impl->currentPage;
 }
 
+/*!
+    \brief      在 model 重置期间 (beginResetModel 与 endResetModel 之间) 直接回到第一页, 不发送信号.
+                重置后没有任何页面时 setCurrentPage 不会改变当前页面, 此时使用该函数.
+    \return     当前页面改变时返回 true, 调用者应在重置结束后发送 currentPageChanged.
+    \sa         setCurrentPage
+*/
+bool QCtmAbstractMultiPageItemModel::resetCurrentPage()
+{
+    if (m_impl->currentPage == 0)
+        return false;
+    m_impl->currentPage = 0;
+    return true;
+}
+
 /*!
     \brief      返回每页的行数量.
     \sa         setPageRowCount
@@ -113,6 +143,16 @@ int QCtmAbstractMultiPageItemModel::pageRowCount() const
     return m_impl->pageRowCount;
 }
 
+/*!
+    \brief      返回页面总数是否已知, 默认为 true.
+                总数未知时 pageCount 只包含已发现的页面, 存在下一页时其中包含下一页, QCtmMultiPageButtonBox 据此不显示总数.
+    \sa         pageCount
+*/
+bool QCtmAbstractMultiPageItemModel::isPageCountKnown() const
+{
+    return true;
+}
+
 /*!
     \brief      返回数据偏移量，即首行在所有数据中的位置.
 */
@@ -122,8 +162,45 @@ int QCtmAbstractMultiPageItemModel::offset() const
 }
 
 /*!
-    \brief      设置当前页 \a page.
-    \sa         currentPage
+    \brief      设置切换页面时的变更通知方式 \a mode.
+    \sa         pageChangeMode, setPageChangeRoles
+*/
+void QCtmAbstractMultiPageItemModel::setPageChangeMode(PageChangeMode mode)
+{
+    m_impl->pageChangeMode = mode;
+}
+
+/*!
+    \brief      返回切换页面时的变更通知方式.
+    \sa         setPageChangeMode
+*/
+QCtmAbstractMultiPageItemModel::PageChangeMode QCtmAbstractMultiPageItemModel::pageChangeMode() const
+{
+    return m_impl->pageChangeMode;
+}
+
+/*!
+    \brief      设置 BoundedRoles 模式下切换页面时随页面改变的角色 \a roles, 默认为 Qt::DisplayRole 与 Qt::EditRole.
+                与页面无关的角色 (如图标、对齐方式) 不必列出, 视图与代理 model 不会重新查询它们.
+    \sa         pageChangeRoles, setPageChangeMode
+*/
+void QCtmAbstractMultiPageItemModel::setPageChangeRoles(const QVector<int>& roles)
+{
+    m_impl->pageChangeRoles = roles;
+}
+
+/*!
+    \brief      返回 BoundedRoles 模式下切换页面时随页面改变的角色.
+    \sa         setPageChangeRoles
+*/
+const QVector<int>& QCtmAbstractMultiPageItemModel::pageChangeRoles() const
+{
+    return m_impl->pageChangeRoles;
+}
+
+/*!
+    \brief      设置当前页 \a page, 变更通知方式由 pageChangeMode 决定.
+    \sa         currentPage, setPageChangeMode
 */
 void QCtmAbstractMultiPageItemModel::setCurrentPage(int page)
 {
@@ -132,6 +209,17 @@ void QCtmAbstractMultiPageItemModel::setCurrentPage(int page)
         return;
     if (page == m_impl->currentPage)
         return;
+    if (m_impl->pageChangeMode == PageChangeMode::Reset)
+    {
+        const bool nested = m_impl->resetting; // setPageRowCount 等已在重置中
+        if (!nested)
+            beginResetModel();
+        m_impl->currentPage = page;
+        if (!nested)
+            endResetModel();
+        emit currentPageChanged(page);
+        return;
+    }
     auto beforeRowCount = rowCount();
     auto beforePage     = m_impl->currentPage;
     m_impl->currentPage = page;
@@ -140,7 +228,10 @@ void QCtmAbstractMultiPageItemModel::setCurrentPage(int page)
     auto guard = qScopeGuard(
         [&]
         {
-            emit dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
+            if (m_impl->pageChangeMode == PageChangeMode::FullUpdate)
+                emit dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
+            else if (auto rows = std::min(beforeRowCount, afterRowCount); rows > 0 && columnCount() > 0)
+                emit dataChanged(index(0, 0), index(rows - 1, columnCount() - 1), m_impl->pageChangeRoles);
             emit currentPageChanged(page);
         });
 
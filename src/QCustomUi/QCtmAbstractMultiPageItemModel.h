@@ -26,12 +26,25 @@ class QCUSTOMUI_EXPORT QCtmAbstractMultiPageItemModel : public QAbstractItemMode
 {
     Q_OBJECT
 public:
+    enum class PageChangeMode
+    {
+        FullUpdate,
+        BoundedRoles,
+        Reset
+    };
+    Q_ENUM(PageChangeMode)
+
     explicit QCtmAbstractMultiPageItemModel(QObject* parent = nullptr);
     ~QCtmAbstractMultiPageItemModel();
     int currentPage() const;
     int pageRowCount() const;
     virtual int pageCount() const = 0;
+    virtual bool isPageCountKnown() const;
     int offset() const;
+    void setPageChangeMode(PageChangeMode mode);
+    PageChangeMode pageChangeMode() const;
+    void setPageChangeRoles(const QVector<int>& roles);
+    const QVector<int>& pageChangeRoles() const;
 public slots:
     virtual void setCurrentPage(int page);
     virtual void setPageRowCount(int rowCount);
@@ -41,6 +54,9 @@ signals:
     void currentPageChanged(int page);
     void pageCountChanged(int count);
 
+protected:
+    bool resetCurrentPage();
+
 private:
     struct Impl;
     std::unique_ptr<Impl> m_impl;
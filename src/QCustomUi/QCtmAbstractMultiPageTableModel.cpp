@@ -19,7 +19,246 @@
 #include "QCtmAbstractMultiPageTableModel.h"
 
 #include <QDataStream>
+#include <QElapsedTimer>
 #include <QMimeData>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+
+namespace
+{
+constexpr int SyncSortLimit = 8192;  // 行数较少时直接在当前线程中排序
+constexpr int ReadChunk     = 16384; // 工作线程中每次读取的行数
+constexpr int NumericSample = 1024;  // 由前若干行判断排序列是否为数值
+constexpr int FilterChunk   = 65536;
+constexpr int SortChunk     = 65536; // 每个并行排序分块的最少行数
+
+// 进度分配: 读取 0-40, 筛选 40-50, 分块排序 50-70, 归并 70-95
+constexpr int ReadProgress   = 40;
+constexpr int FilterProgress = 50;
+constexpr int SortProgress   = 70;
+constexpr int MergeProgress  = 95;
+
+inline bool isNumeric(const QVariant& value)
+{
+    switch (value.userType())
+    {
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Double:
+    case QMetaType::Float:
+    case QMetaType::Short:
+    case QMetaType::UShort:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// 以第一个有效值的类型作为整列的类型
+inline bool isNumericColumn(const QVector<QVariant>& sample)
+{
+    auto it = std::find_if(sample.begin(), sample.end(), [](const QVariant& v) { return v.isValid(); });
+    return it != sample.end() && isNumeric(*it);
+}
+
+// 全量排序/筛选任务. 子类提供读取函数时键在工作线程中分块读取, 否则在 GUI 线程中取出快照
+struct SortJob
+{
+    using Reader = QCtmAbstractMultiPageTableModel::DataRowReader;
+
+    quint64 generation { 0 };
+    int rows { 0 };
+    int sortColumn { -1 };
+    Qt::SortOrder order { Qt::AscendingOrder };
+    Reader sortReader;
+    Reader filterReader;
+    bool numeric { false };
+    std::vector<double> numbers;
+    std::vector<QString> strings;
+    QRegularExpression filter;
+    std::vector<QString> filterTexts;
+    std::atomic_bool cancel { false };
+
+    // numeric 确定后分配键的存储
+    inline void allocateKeys()
+    {
+        if (numeric)
+            numbers.resize(rows);
+        else
+            strings.resize(rows);
+    }
+
+    inline void setKey(int row, const QVariant& value)
+    {
+        if (numeric)
+            numbers[row] = value.toDouble();
+        else
+            strings[row] = value.toString();
+    }
+
+    inline bool less(int a, int b) const
+    {
+        int c = 0;
+        if (numeric)
+            c = numbers[a] < numbers[b] ? -1 : (numbers[b] < numbers[a] ? 1 : 0);
+        else
+            c = strings[a].compare(strings[b]);
+        if (c == 0)
+            return a < b; // 相等时保持原有顺序
+        return order == Qt::AscendingOrder ? c < 0 : c > 0;
+    }
+};
+
+// 在线程池中执行 count 个分块并等待完成, 没有线程池时在当前线程中执行
+void parallelFor(QThreadPool* pool, int count, const std::function<void(int)>& func)
+{
+    if (!pool || count <= 1)
+    {
+        for (int i = 0; i < count; i++)
+            func(i);
+        return;
+    }
+    QSemaphore done;
+    for (int i = 0; i < count; i++)
+    {
+        pool->start(QRunnable::create(
+            [&func, &done, i]
+            {
+                func(i);
+                done.release();
+            }));
+    }
+    done.acquire(count);
+}
+
+// 由读取函数分块并行读取排序与筛选的键
+void readKeys(SortJob& job, QThreadPool* pool, const std::function<void(int)>& progress)
+{
+    if (job.sortReader)
+    {
+        QVector<QVariant> sample;
+        job.sortReader(0, std::min(job.rows, NumericSample), sample);
+        job.numeric = isNumericColumn(sample);
+        job.allocateKeys();
+    }
+    if (job.filterReader)
+        job.filterTexts.resize(job.rows);
+
+    const int chunks = (job.rows + ReadChunk - 1) / ReadChunk;
+    std::atomic_int finished { 0 };
+    parallelFor(pool,
+                chunks,
+                [&](int chunk)
+                {
+                    const int first = chunk * ReadChunk;
+                    const int count = std::min(ReadChunk, job.rows - first);
+                    QVector<QVariant> values;
+                    values.reserve(count);
+                    if (job.sortReader && !job.cancel.load(std::memory_order_relaxed))
+                    {
+                        job.sortReader(first, count, values);
+                        for (int i = 0; i < std::min<int>(count, values.size()); i++)
+                            job.setKey(first + i, values[i]);
+                    }
+                    if (job.filterReader && !job.cancel.load(std::memory_order_relaxed))
+                    {
+                        values.clear();
+                        job.filterReader(first, count, values);
+                        for (int i = 0; i < std::min<int>(count, values.size()); i++)
+                            job.filterTexts[first + i] = values[i].toString();
+                    }
+                    progress(ReadProgress * (finished.fetch_add(1, std::memory_order_relaxed) + 1) / chunks);
+                });
+}
+
+// 读取键后并行计算筛选位图, 再将通过的行分块并行排序, 最后逐轮两两归并
+std::vector<int> execute(SortJob& job, QThreadPool* pool, const std::function<void(int)>& progress)
+{
+    if (job.sortReader || job.filterReader)
+        readKeys(job, pool, progress);
+    if (job.cancel)
+        return {};
+
+    std::vector<quint8> accepted(job.rows, 1);
+    if (!job.filter.pattern().isEmpty())
+    {
+        const int chunks = (job.rows + FilterChunk - 1) / FilterChunk;
+        parallelFor(pool,
+                    chunks,
+                    [&](int chunk)
+                    {
+                        const int end = std::min(job.rows, (chunk + 1) * FilterChunk);
+                        for (int i = chunk * FilterChunk; i < end && !job.cancel.load(std::memory_order_relaxed); i++)
+                        {
+                            accepted[i] = job.filter.match(job.filterTexts[i]).hasMatch();
+                        }
+                    });
+    }
+    progress(FilterProgress);
+
+    std::vector<int> rows;
+    rows.reserve(job.rows);
+    for (int i = 0; i < job.rows; i++)
+    {
+        if (accepted[i])
+            rows.push_back(i);
+    }
+    if (job.sortColumn < 0 || job.cancel)
+        return rows;
+
+    const int size   = static_cast<int>(rows.size());
+    const int chunks = pool ? std::clamp(size / SortChunk, 1, std::max(pool->maxThreadCount(), 1)) : 1;
+    std::vector<int> bounds(chunks + 1);
+    for (int i = 0; i <= chunks; i++)
+    {
+        bounds[i] = static_cast<int>(static_cast<qint64>(size) * i / chunks);
+    }
+    auto less = [&job](int a, int b) { return job.less(a, b); };
+    parallelFor(pool, chunks, [&](int chunk) { std::sort(rows.begin() + bounds[chunk], rows.begin() + bounds[chunk + 1], less); });
+    progress(chunks > 1 ? SortProgress : MergeProgress);
+
+    int rounds = 0;
+    for (int width = 1; width < chunks; width *= 2)
+        rounds++;
+    for (int width = 1, round = 1; width < chunks && !job.cancel; width *= 2, round++)
+    {
+        const int pairs = (chunks + 2 * width - 1) / (2 * width);
+        parallelFor(pool,
+                    pairs,
+                    [&](int pair)
+                    {
+                        const int first  = pair * 2 * width;
+                        const int middle = std::min(first + width, chunks);
+                        const int last   = std::min(first + 2 * width, chunks);
+                        if (middle < last)
+                            std::inplace_merge(rows.begin() + bounds[first], rows.begin() + bounds[middle], rows.begin() + bounds[last], less);
+                    });
+        progress(SortProgress + (MergeProgress - SortProgress) * round / rounds);
+    }
+    return rows;
+}
+} // namespace
+
+struct QCtmAbstractMultiPageTableModel::Impl
+{
+    int sortColumn { -1 };
+    Qt::SortOrder sortOrder { Qt::AscendingOrder };
+    QRegularExpression filter;
+    int filterKeyColumn { 0 };
+    std::vector<int> order; // 排序、筛选后的数据行, active 为 false 时不使用
+    bool active { false };
+    quint64 generation { 0 };
+    std::shared_ptr<SortJob> job;
+    QThread* sorter { nullptr };
+    QThreadPool pool;
+};
 
 /*!
     \class      QCtmAbstractMultiPageTableModel
@@ -30,6 +269,35 @@
     \inheaderfile QCtmAbstractMultiPageTableModel.h
 */
 
+/*!
+    \fn         void QCtmAbstractMultiPageTableModel::sortProgress(int percent)
+    \brief      全量排序/筛选的进度 \a percent (0-100).
+    \sa         sort, setFilterRegularExpression
+*/
+
+/*!
+    \fn         void QCtmAbstractMultiPageTableModel::sortFinished(qint64 msecs)
+    \brief      全量排序/筛选完成并生效时发送该信号, \a msecs 为耗时 (毫秒).
+    \sa         sort, setFilterRegularExpression
+*/
+
+/*!
+    \brief      构造函数 \a parent.
+*/
+QCtmAbstractMultiPageTableModel::QCtmAbstractMultiPageTableModel(QObject* parent /* = nullptr */)
+    : QCtmAbstractMultiPageItemModel(parent), m_impl(std::make_unique<Impl>())
+{
+}
+
+/*!
+    \brief      析构函数.
+*/
+QCtmAbstractMultiPageTableModel::~QCtmAbstractMultiPageTableModel()
+{
+    cancelSortFilter();
+    m_impl->pool.waitForDone();
+}
+
 /*!
     \reimp
 */
@@ -129,3 +397,303 @@ bool QCtmAbstractMultiPageTableModel::hasChildren(const QModelIndex& parent) con
         return rowCount(parent) > 0 && columnCount(parent) > 0;
     return false;
 }
+
+/*!
+    \reimp
+                按第 \a column 列以 \a order 对全部数据排序, 而不只是当前页, \a column 为 -1 时恢复原有顺序.
+                排序在线程池中并行进行, 进度由 sortProgress 报告, 完成后 model 重置并回到第一页.
+                需要子类实现 dataRowCount 与 dataRowValue, 否则调用无效.
+    \sa         sortProgress, sortFinished, setFilterRegularExpression
+*/
+void QCtmAbstractMultiPageTableModel::sort(int column, Qt::SortOrder order /* = Qt::AscendingOrder */)
+{
+    m_impl->sortColumn = column;
+    m_impl->sortOrder  = order;
+    startSortFilter();
+}
+
+/*!
+    \brief      返回全量排序的列, -1 表示未排序.
+    \sa         sort
+*/
+int QCtmAbstractMultiPageTableModel::sortColumn() const
+{
+    return m_impl->sortColumn;
+}
+
+/*!
+    \brief      返回全量排序的顺序.
+    \sa         sort
+*/
+Qt::SortOrder QCtmAbstractMultiPageTableModel::sortOrder() const
+{
+    return m_impl->sortOrder;
+}
+
+/*!
+    \brief      设置筛选表达式 \a regularExpression, 只显示 filterKeyColumn 列匹配的行, 空表达式表示不筛选.
+                筛选对全部数据进行, 与排序在同一任务中完成.
+    \sa         filterRegularExpression, setFilterKeyColumn
+*/
+void QCtmAbstractMultiPageTableModel::setFilterRegularExpression(const QRegularExpression& regularExpression)
+{
+    m_impl->filter = regularExpression;
+    startSortFilter();
+}
+
+/*!
+    \brief      返回筛选表达式.
+    \sa         setFilterRegularExpression
+*/
+const QRegularExpression& QCtmAbstractMultiPageTableModel::filterRegularExpression() const
+{
+    return m_impl->filter;
+}
+
+/*!
+    \brief      设置筛选使用的列 \a column.
+    \sa         filterKeyColumn, setFilterRegularExpression
+*/
+void QCtmAbstractMultiPageTableModel::setFilterKeyColumn(int column)
+{
+    m_impl->filterKeyColumn = column;
+    if (!m_impl->filter.pattern().isEmpty())
+        startSortFilter();
+}
+
+/*!
+    \brief      返回筛选使用的列.
+    \sa         setFilterKeyColumn
+*/
+int QCtmAbstractMultiPageTableModel::filterKeyColumn() const
+{
+    return m_impl->filterKeyColumn;
+}
+
+/*!
+    \brief      返回是否有正在进行的全量排序/筛选.
+    \sa         sort, sortFinished
+*/
+bool QCtmAbstractMultiPageTableModel::isSorting() const
+{
+    return m_impl->job != nullptr;
+}
+
+/*!
+    \brief      返回当前页第 \a row 行对应的数据行. 未排序、筛选时为 offset() + \a row,
+                否则经过排序、筛选的结果映射, 子类在 data 中应使用该函数代替 offset() + \a row.
+    \sa         visibleRowCount
+*/
+int QCtmAbstractMultiPageTableModel::mapToDataRow(int row) const
+{
+    const auto position = offset() + row;
+    if (!m_impl->active)
+        return position;
+    if (position < 0 || position >= static_cast<int>(m_impl->order.size()))
+        return -1;
+    const auto dataRow = m_impl->order[position];
+    return dataRow < dataRowCount() ? dataRow : -1; // 数据在排序后减少
+}
+
+/*!
+    \brief      按当前的排序与筛选条件重新计算, 数据改变后由子类调用. 未排序且未筛选时不做任何事.
+    \sa         sort, setFilterRegularExpression
+*/
+void QCtmAbstractMultiPageTableModel::invalidateSortFilter()
+{
+    if (m_impl->active || m_impl->job)
+        startSortFilter();
+}
+
+/*!
+    \brief      返回全部数据的行数, 用于全量排序与筛选. 默认返回 -1, 表示不支持.
+    \sa         dataRowValue
+*/
+int QCtmAbstractMultiPageTableModel::dataRowCount() const
+{
+    return -1;
+}
+
+/*!
+    \brief      返回第 \a dataRow 行数据第 \a column 列用于排序与筛选的值. 数值类型按数值排序, 其余按字符串排序.
+    \sa         dataRowCount
+*/
+QVariant QCtmAbstractMultiPageTableModel::dataRowValue(int dataRow, int column) const
+{
+    Q_UNUSED(dataRow);
+    Q_UNUSED(column);
+    return {};
+}
+
+/*!
+    \brief      返回第 \a column 列的批量读取函数, 函数将数据行 first 起 count 行的值依次追加到 values 中.
+                返回的函数在工作线程中并发调用, 需要持有所需数据的快照, 不受 model 之后变化的影响.
+                默认返回空函数, 此时在 GUI 线程中通过 dataRowValue 逐行读取. 数据量较大或读取代价较高时
+                (如需要解码文件) 子类应实现该函数, 以免排序、筛选期间阻塞界面.
+    \sa         dataRowValue
+*/
+QCtmAbstractMultiPageTableModel::DataRowReader QCtmAbstractMultiPageTableModel::dataRowReader(int column) const
+{
+    Q_UNUSED(column);
+    return {};
+}
+
+/*!
+    \brief      返回排序、筛选后的总行数, 未排序、筛选时为 dataRowCount. 子类据此计算 rowCount 与 pageCount.
+    \sa         mapToDataRow
+*/
+int QCtmAbstractMultiPageTableModel::visibleRowCount() const
+{
+    return m_impl->active ? static_cast<int>(m_impl->order.size()) : dataRowCount();
+}
+
+/*!
+    \brief      返回当前显示的是否为排序、筛选后的结果, 此时各页的数据行不再连续.
+    \sa         mapToDataRow
+*/
+bool QCtmAbstractMultiPageTableModel::isSortFiltered() const
+{
+    return m_impl->active;
+}
+
+/*!
+    \brief      开始全量排序/筛选, 行数较少时直接完成, 否则在工作线程中完成.
+                子类提供 dataRowReader 时排序与筛选的键也在工作线程中读取, 否则在当前线程中取出快照.
+*/
+void QCtmAbstractMultiPageTableModel::startSortFilter()
+{
+    cancelSortFilter();
+    const auto rows = dataRowCount();
+    if (rows < 0)
+        return;
+    if (m_impl->sortColumn < 0 && m_impl->filter.pattern().isEmpty())
+    {
+        if (m_impl->active)
+            finishSortFilter(++m_impl->generation, {}, 0); // 恢复原有顺序
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    auto job        = std::make_shared<SortJob>();
+    job->generation = ++m_impl->generation;
+    job->rows       = rows;
+    job->sortColumn = m_impl->sortColumn;
+    job->order      = m_impl->sortOrder;
+    job->filter     = m_impl->filter;
+    const bool filtering = !job->filter.pattern().isEmpty();
+    if (job->sortColumn >= 0)
+        job->sortReader = dataRowReader(job->sortColumn);
+    if (filtering)
+        job->filterReader = dataRowReader(m_impl->filterKeyColumn);
+
+    // 子类不提供读取函数时只能在当前线程中逐行读取
+    const int snapshots = (job->sortColumn >= 0 && !job->sortReader) + (filtering && !job->filterReader);
+    int snapshot        = 0;
+    auto read           = [&](int column, const std::function<void(int, QVariant&&)>& store)
+    {
+        for (int i = 0; i < rows; i++)
+        {
+            store(i, dataRowValue(i, column));
+            if (rows > SyncSortLimit && (i & 0xffff) == 0xffff)
+                emit sortProgress(static_cast<int>(ReadProgress * (static_cast<qint64>(snapshot) * rows + i) / (snapshots * rows)));
+        }
+        snapshot++;
+    };
+    if (job->sortColumn >= 0 && !job->sortReader)
+    {
+        QVector<QVariant> sample;
+        for (int i = 0; i < std::min(rows, NumericSample); i++)
+            sample.push_back(dataRowValue(i, job->sortColumn));
+        job->numeric = isNumericColumn(sample);
+        job->allocateKeys();
+        read(job->sortColumn, [&job](int row, QVariant&& value) { job->setKey(row, value); });
+    }
+    if (filtering && !job->filterReader)
+    {
+        job->filterTexts.resize(rows);
+        read(m_impl->filterKeyColumn, [&job](int row, QVariant&& value) { job->filterTexts[row] = value.toString(); });
+    }
+
+    if (rows <= SyncSortLimit)
+    {
+        auto order = execute(*job, nullptr, [](int) {});
+        finishSortFilter(job->generation, std::move(order), timer.elapsed());
+        return;
+    }
+
+    m_impl->job    = job;
+    m_impl->sorter = QThread::create(
+        [this, job, timer]
+        {
+            auto order = execute(*job,
+                                 &m_impl->pool,
+                                 [this, job](int percent)
+                                 {
+                                     QMetaObject::invokeMethod(
+                                         this,
+                                         [this, job, percent]
+                                         {
+                                             if (job == m_impl->job)
+                                                 emit sortProgress(percent);
+                                         },
+                                         Qt::QueuedConnection);
+                                 });
+            if (job->cancel)
+                return;
+            const auto generation = job->generation;
+            const auto msecs      = timer.elapsed();
+            QMetaObject::invokeMethod(
+                this,
+                [this, generation, msecs, order = std::move(order)]() mutable
+                {
+                    finishSortFilter(generation, std::move(order), msecs);
+                },
+                Qt::QueuedConnection);
+        });
+    m_impl->sorter->setObjectName("QCtmMultiPageSorter");
+    m_impl->sorter->start(QThread::LowPriority);
+}
+
+/*!
+    \brief      取消正在进行的全量排序/筛选.
+*/
+void QCtmAbstractMultiPageTableModel::cancelSortFilter()
+{
+    if (m_impl->job)
+    {
+        m_impl->job->cancel = true;
+        m_impl->job.reset();
+    }
+    if (m_impl->sorter)
+    {
+        m_impl->sorter->wait(); // 最多等待一个分块排序完成
+        delete m_impl->sorter;
+        m_impl->sorter = nullptr;
+    }
+}
+
+/*!
+    \brief      排序、筛选结果 \a order 生效, \a msecs 为耗时. \a generation 与当前任务不一致时忽略.
+*/
+void QCtmAbstractMultiPageTableModel::finishSortFilter(quint64 generation, std::vector<int> order, qint64 msecs)
+{
+    if (generation != m_impl->generation)
+        return;
+    m_impl->job.reset();
+    if (m_impl->sorter)
+    {
+        m_impl->sorter->wait();
+        delete m_impl->sorter;
+        m_impl->sorter = nullptr;
+    }
+    beginResetModel();
+    m_impl->active     = m_impl->sortColumn >= 0 || !m_impl->filter.pattern().isEmpty();
+    m_impl->order      = std::move(order);
+    const bool changed = resetCurrentPage(); // 筛选结果为空时 setCurrentPage 不会改变页面
+    endResetModel();
+    if (changed)
+        emit currentPageChanged(0);
+    emit sortProgress(100);
+    emit sortFinished(msecs);
+}
@@ -20,17 +20,55 @@
 
 #include "QCtmAbstractMultiPageItemModel.h"
 
+#include <QRegularExpression>
+#include <QVector>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
 class QCUSTOMUI_EXPORT QCtmAbstractMultiPageTableModel : public QCtmAbstractMultiPageItemModel
 {
     Q_OBJECT
 public:
-    using QCtmAbstractMultiPageItemModel::QCtmAbstractMultiPageItemModel;
+    using DataRowReader = std::function<void(int first, int count, QVector<QVariant>& values)>;
+
+    explicit QCtmAbstractMultiPageTableModel(QObject* parent = nullptr);
+    ~QCtmAbstractMultiPageTableModel();
     QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
     QModelIndex sibling(int row, int column, const QModelIndex& idx) const override;
     bool dropMimeData(const QMimeData* data, Qt::DropAction action, int row, int column, const QModelIndex& parent) override;
     Qt::ItemFlags flags(const QModelIndex& index) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+    int sortColumn() const;
+    Qt::SortOrder sortOrder() const;
+    void setFilterRegularExpression(const QRegularExpression& regularExpression);
+    const QRegularExpression& filterRegularExpression() const;
+    void setFilterKeyColumn(int column);
+    int filterKeyColumn() const;
+    bool isSorting() const;
+    int mapToDataRow(int row) const;
+public slots:
+    void invalidateSortFilter();
+signals:
+    void sortProgress(int percent);
+    void sortFinished(qint64 msecs);
+
+protected:
+    virtual int dataRowCount() const;
+    virtual QVariant dataRowValue(int dataRow, int column) const;
+    virtual DataRowReader dataRowReader(int column) const;
+    int visibleRowCount() const;
+    bool isSortFiltered() const;
 
 private:
     QModelIndex parent(const QModelIndex& child) const override;
     bool hasChildren(const QModelIndex& parent) const override;
+    void startSortFilter();
+    void cancelSortFilter();
+    void finishSortFilter(quint64 generation, std::vector<int> order, qint64 msecs);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
 };
\ No newline at end of file
@@ -0,0 +1,69 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#include "QCtmAbstractPageProvider.h"
+
+/*!
+    \class      QCtmAbstractPageProvider
+    \brief      分页数据提供者基类, 为 QCtmAsyncMultiPageTableModel 按页提供数据.
+                rowCount 与 fetch 在 model 的工作线程中调用, 可以执行数据库查询等耗时操作,
+                columnCount 与 headerData 在 GUI 线程中调用.
+    \ingroup    QCustomUi
+    \inmodule   QCustomUi
+    \inheaderfile QCtmAbstractPageProvider.h
+    \sa         QCtmAsyncMultiPageTableModel
+*/
+
+/*!
+    \typedef    QCtmAbstractPageProvider::Row
+    \brief      一行数据, 每列一个值.
+*/
+
+/*!
+    \fn         int QCtmAbstractPageProvider::columnCount() const
+    \brief      返回列数量, 在 GUI 线程中调用.
+*/
+
+/*!
+    \fn         int QCtmAbstractPageProvider::rowCount()
+    \brief      返回数据的总行数, 在工作线程中调用.
+*/
+
+/*!
+    \fn         QVector<QCtmAbstractPageProvider::Row> QCtmAbstractPageProvider::fetch(int offset, int count)
+    \brief      返回从 \a offset 开始的至多 \a count 行数据, 在工作线程中调用.
+*/
+
+/*!
+    \brief      构造函数.
+*/
+QCtmAbstractPageProvider::QCtmAbstractPageProvider() {}
+
+/*!
+    \brief      析构函数.
+*/
+QCtmAbstractPageProvider::~QCtmAbstractPageProvider() {}
+
+/*!
+    \brief      返回 \a section 的表头数据 \a orientation, \a role, 在 GUI 线程中调用. 默认不提供表头.
+*/
+QVariant QCtmAbstractPageProvider::headerData(int section, Qt::Orientation orientation, int role /* = Qt::DisplayRole */) const
+{
+    return {};
+}
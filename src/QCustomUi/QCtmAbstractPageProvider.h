@@ -0,0 +1,43 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include "qcustomui_global.h"
+
+#include <QVariant>
+#include <QVector>
+
+#include <memory>
+
+class QCUSTOMUI_EXPORT QCtmAbstractPageProvider
+{
+public:
+    using Row = QVector<QVariant>;
+
+    QCtmAbstractPageProvider();
+    virtual ~QCtmAbstractPageProvider();
+
+    virtual int columnCount() const = 0;
+    virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+    virtual int rowCount() = 0;
+    virtual QVector<Row> fetch(int offset, int count) = 0;
+};
+
+using QCtmPageProviderPtr = std::shared_ptr<QCtmAbstractPageProvider>;
@@ -0,0 +1,368 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#include "QCtmAsyncMultiPageTableModel.h"
+#include "Private/QCtmPageFetcher_p.h"
+
+#include <QCache>
+
+#include <algorithm>
+
+using Rows = QVector<QCtmAbstractPageProvider::Row>;
+
+struct QCtmAsyncMultiPageTableModel::Impl
+{
+    QCtmPageProviderPtr provider;
+    std::unique_ptr<QCtmPageFetcher> fetcher;
+    QCache<int, Rows> cache;
+    int cacheSize { 16 };
+    bool prefetch { true };
+    QString placeholder;
+    int totalRows { 0 };
+    quint64 generation { 0 };
+
+    // 预取时至少保留当前页与前后两页, 避免预取的结果淘汰当前页
+    int effectiveCacheSize() const { return std::max(cacheSize, prefetch ? 3 : 1); }
+};
+
+/*!
+    \class      QCtmAsyncMultiPageTableModel
+    \brief      异步分页 TableModel, 数据由 QCtmAbstractPageProvider 在工作线程中按页读取.
+                最近访问的页面保存在 LRU 缓存中, 切换页面时同时预取前后两页, 页面读取完成前显示占位行,
+                适用于数据库等无法一次载入全部数据的数据源.
+    \inherits   QCtmAbstractMultiPageTableModel
+    \ingroup    QCustomUi
+    \inmodule   QCustomUi
+    \inheaderfile QCtmAsyncMultiPageTableModel.h
+    \sa         QCtmAbstractPageProvider
+*/
+
+/*!
+    \fn         void QCtmAsyncMultiPageTableModel::pageLoaded(int page)
+    \brief      页面 \a page 读取完成并加入缓存后发送该信号.
+*/
+
+/*!
+    \brief      构造函数 \a parent.
+*/
+QCtmAsyncMultiPageTableModel::QCtmAsyncMultiPageTableModel(QObject* parent /* = nullptr */)
+    : QCtmAbstractMultiPageTableModel(parent), m_impl(std::make_unique<Impl>())
+{
+    m_impl->placeholder = tr("Loading...");
+    m_impl->cache.setMaxCost(m_impl->effectiveCacheSize());
+    m_impl->fetcher = std::make_unique<QCtmPageFetcher>();
+}
+
+/*!
+    \brief      析构函数, 等待正在进行的读取返回.
+*/
+QCtmAsyncMultiPageTableModel::~QCtmAsyncMultiPageTableModel()
+{
+    m_impl->fetcher.reset();
+}
+
+/*!
+    \brief      设置数据提供者 \a provider, 总行数在工作线程中重新查询.
+    \sa         provider
+*/
+void QCtmAsyncMultiPageTableModel::setProvider(QCtmPageProviderPtr provider)
+{
+    beginResetModel();
+    m_impl->provider  = std::move(provider);
+    m_impl->totalRows = 0;
+    invalidate();
+    endResetModel();
+}
+
+/*!
+    \brief      返回数据提供者.
+    \sa         setProvider
+*/
+QCtmPageProviderPtr QCtmAsyncMultiPageTableModel::provider() const
+{
+    return m_impl->provider;
+}
+
+/*!
+    \brief      设置缓存的页面数量 \a pages.
+    \sa         cacheSize
+*/
+void QCtmAsyncMultiPageTableModel::setCacheSize(int pages)
+{
+    m_impl->cacheSize = std::max(pages, 1);
+    m_impl->cache.setMaxCost(m_impl->effectiveCacheSize());
+}
+
+/*!
+    \brief      返回缓存的页面数量.
+    \sa         setCacheSize
+*/
+int QCtmAsyncMultiPageTableModel::cacheSize() const
+{
+    return m_impl->cacheSize;
+}
+
+/*!
+    \brief      设置切换页面时是否预取前后两页 \a enable.
+    \sa         prefetchEnabled
+*/
+void QCtmAsyncMultiPageTableModel::setPrefetchEnabled(bool enable)
+{
+    m_impl->prefetch = enable;
+    m_impl->cache.setMaxCost(m_impl->effectiveCacheSize());
+    requestPages();
+}
+
+/*!
+    \brief      返回切换页面时是否预取前后两页.
+    \sa         setPrefetchEnabled
+*/
+bool QCtmAsyncMultiPageTableModel::prefetchEnabled() const
+{
+    return m_impl->prefetch;
+}
+
+/*!
+    \brief      设置页面读取完成前首列显示的文字 \a text.
+    \sa         placeholderText
+*/
+void QCtmAsyncMultiPageTableModel::setPlaceholderText(const QString& text)
+{
+    m_impl->placeholder = text;
+    if (!isPageLoaded(currentPage()) && rowCount() > 0)
+        emit dataChanged(index(0, 0), index(rowCount() - 1, 0), { Qt::DisplayRole });
+}
+
+/*!
+    \brief      返回页面读取完成前首列显示的文字.
+    \sa         setPlaceholderText
+*/
+const QString& QCtmAsyncMultiPageTableModel::placeholderText() const
+{
+    return m_impl->placeholder;
+}
+
+/*!
+    \brief      返回页面 \a page 是否已在缓存中.
+*/
+bool QCtmAsyncMultiPageTableModel::isPageLoaded(int page) const
+{
+    return m_impl->cache.contains(page);
+}
+
+/*!
+    \brief      返回数据的总行数.
+*/
+int QCtmAsyncMultiPageTableModel::totalRowCount() const
+{
+    return m_impl->totalRows;
+}
+
+/*!
+    \reimp
+*/
+int QCtmAsyncMultiPageTableModel::rowCount(const QModelIndex& parent /* = QModelIndex() */) const
+{
+    if (parent.isValid())
+        return 0;
+    return std::clamp(m_impl->totalRows - offset(), 0, pageRowCount());
+}
+
+/*!
+    \reimp
+*/
+int QCtmAsyncMultiPageTableModel::columnCount(const QModelIndex& parent /* = QModelIndex() */) const
+{
+    if (parent.isValid() || !m_impl->provider)
+        return 0;
+    return m_impl->provider->columnCount();
+}
+
+/*!
+    \reimp
+*/
+QVariant QCtmAsyncMultiPageTableModel::data(const QModelIndex& index, int role /* = Qt::DisplayRole */) const
+{
+    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::EditRole))
+        return {};
+    auto rows = m_impl->cache.object(currentPage());
+    if (!rows)
+        return index.column() == 0 && role == Qt::DisplayRole ? QVariant(m_impl->placeholder) : QVariant();
+    if (index.row() >= rows->size())
+        return {};
+    const auto& row = rows->at(index.row());
+    return index.column() < row.size() ? row.at(index.column()) : QVariant();
+}
+
+/*!
+    \reimp
+*/
+QVariant QCtmAsyncMultiPageTableModel::headerData(int section, Qt::Orientation orientation, int role /* = Qt::DisplayRole */) const
+{
+    if (m_impl->provider)
+    {
+        if (auto data = m_impl->provider->headerData(section, orientation, role); data.isValid())
+            return data;
+    }
+    return QCtmAbstractMultiPageTableModel::headerData(section, orientation, role);
+}
+
+/*!
+    \reimp
+*/
+int QCtmAsyncMultiPageTableModel::pageCount() const
+{
+    return m_impl->totalRows / pageRowCount() + static_cast<bool>(m_impl->totalRows % pageRowCount());
+}
+
+/*!
+    \reimp
+*/
+void QCtmAsyncMultiPageTableModel::setCurrentPage(int page)
+{
+    QCtmAbstractMultiPageTableModel::setCurrentPage(page);
+    requestPages();
+}
+
+/*!
+    \reimp
+*/
+void QCtmAsyncMultiPageTableModel::setPageRowCount(int rowCount)
+{
+    // 每页行数改变后缓存的页面全部失效, 总行数不变
+    m_impl->cache.clear();
+    m_impl->generation++;
+    resetFetcher(rowCount, false);
+    QCtmAbstractMultiPageTableModel::setPageRowCount(rowCount);
+    requestPages();
+}
+
+/*!
+    \brief      清空缓存并重新查询总行数与当前页面, 数据源内容改变后调用.
+*/
+void QCtmAsyncMultiPageTableModel::refresh()
+{
+    beginResetModel();
+    invalidate();
+    endResetModel();
+    requestPages();
+}
+
+/*!
+    \brief      请求当前页面, 开启预取时同时请求前后两页, 已缓存的页面不再读取.
+*/
+void QCtmAsyncMultiPageTableModel::requestPages()
+{
+    if (!m_impl->provider)
+        return;
+    QVector<int> pages;
+    auto want = [&](int page)
+    {
+        if (page >= 0 && page < pageCount() && !m_impl->cache.contains(page))
+            pages.push_back(page);
+    };
+    want(currentPage());
+    if (m_impl->prefetch)
+    {
+        want(currentPage() + 1);
+        want(currentPage() - 1);
+    }
+    m_impl->fetcher->request(pages);
+}
+
+/*!
+    \brief      丢弃缓存与未完成的请求并重新查询总行数.
+*/
+void QCtmAsyncMultiPageTableModel::invalidate()
+{
+    m_impl->cache.clear();
+    m_impl->generation++;
+    resetFetcher(pageRowCount(), true);
+}
+
+/*!
+    \brief      以每页 \a pageRowCount 行重新设置工作线程的读取任务, \a recount 为 true 时先查询总行数.
+                任务携带当前代数, 结果回到 GUI 线程后据此丢弃过期的数据.
+*/
+void QCtmAsyncMultiPageTableModel::resetFetcher(int pageRowCount, bool recount)
+{
+    auto provider = m_impl->provider;
+    if (!provider)
+    {
+        m_impl->fetcher->reset({});
+        return;
+    }
+    const auto generation = m_impl->generation;
+    QCtmPageFetcher::Job count;
+    if (recount)
+    {
+        count = [this, provider, generation]()
+        {
+            const auto rowCount = provider->rowCount();
+            QMetaObject::invokeMethod(
+                this,
+                [this, generation, rowCount]()
+                {
+                    onCountReady(generation, rowCount);
+                },
+                Qt::QueuedConnection);
+        };
+    }
+    m_impl->fetcher->reset(
+        [this, provider, generation, pageRowCount](int page)
+        {
+            auto rows = provider->fetch(page * pageRowCount, pageRowCount);
+            QMetaObject::invokeMethod(
+                this,
+                [this, generation, page, rows = std::move(rows)]() mutable
+                {
+                    onPageReady(generation, page, std::move(rows));
+                },
+                Qt::QueuedConnection);
+        },
+        std::move(count));
+}
+
+/*!
+    \brief      页面 \a page 读取完成 \a rows, 忽略代数 \a generation 过期的结果.
+*/
+void QCtmAsyncMultiPageTableModel::onPageReady(quint64 generation, int page, QVector<QCtmAbstractPageProvider::Row> rows)
+{
+    if (generation != m_impl->generation)
+        return;
+    m_impl->cache.insert(page, new Rows(std::move(rows)));
+    if (page == currentPage() && rowCount() > 0)
+        emit dataChanged(index(0, 0),
+                         index(rowCount() - 1, columnCount() - 1),
+                         pageChangeMode() == PageChangeMode::FullUpdate ? QVector<int>() : pageChangeRoles());
+    emit pageLoaded(page);
+}
+
+/*!
+    \brief      总行数 \a rowCount 查询完成, 忽略代数 \a generation 过期的结果.
+*/
+void QCtmAsyncMultiPageTableModel::onCountReady(quint64 generation, int rowCount)
+{
+    if (generation != m_impl->generation)
+        return;
+    beginResetModel();
+    m_impl->totalRows = rowCount;
+    endResetModel();
+    requestPages();
+}
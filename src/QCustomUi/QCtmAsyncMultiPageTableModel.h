@@ -0,0 +1,63 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include "QCtmAbstractMultiPageTableModel.h"
+#include "QCtmAbstractPageProvider.h"
+
+class QCUSTOMUI_EXPORT QCtmAsyncMultiPageTableModel : public QCtmAbstractMultiPageTableModel
+{
+    Q_OBJECT
+public:
+    explicit QCtmAsyncMultiPageTableModel(QObject* parent = nullptr);
+    ~QCtmAsyncMultiPageTableModel();
+    void setProvider(QCtmPageProviderPtr provider);
+    QCtmPageProviderPtr provider() const;
+    void setCacheSize(int pages);
+    int cacheSize() const;
+    void setPrefetchEnabled(bool enable);
+    bool prefetchEnabled() const;
+    void setPlaceholderText(const QString& text);
+    const QString& placeholderText() const;
+    bool isPageLoaded(int page) const;
+    int totalRowCount() const;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    int pageCount() const override;
+public slots:
+    void setCurrentPage(int page) override;
+    void setPageRowCount(int rowCount) override;
+    void refresh();
+signals:
+    void pageLoaded(int page);
+
+private:
+    void requestPages();
+    void invalidate();
+    void resetFetcher(int pageRowCount, bool recount);
+    void onPageReady(quint64 generation, int page, QVector<QCtmAbstractPageProvider::Row> rows);
+    void onCountReady(quint64 generation, int rowCount);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
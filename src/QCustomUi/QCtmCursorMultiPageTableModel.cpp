@@ -0,0 +1,381 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#include "QCtmCursorMultiPageTableModel.h"
+#include "Private/QCtmPageFetcher_p.h"
+
+#include <QCache>
+#include <QMutexLocker>
+
+#include <algorithm>
+
+using Rows = QVector<QCtmAbstractCursorPageProvider::Row>;
+
+struct QCtmCursorMultiPageTableModel::Impl
+{
+    QCtmCursorPageProviderPtr provider;
+    std::unique_ptr<QCtmPageFetcher> fetcher;
+    QCache<int, Rows> cache;
+    int cacheSize { 16 };
+    bool prefetch { true };
+    QString placeholder;
+    quint64 generation { 0 };
+
+    // cursors[i] 为第 i 页的起始游标, 由 GUI 线程追加, 工作线程读取
+    QMutex cursorMutex;
+    QVector<QVariant> cursors;
+    bool end { false };
+
+    int effectiveCacheSize() const { return std::max(cacheSize, prefetch ? 3 : 1); }
+};
+
+/*!
+    \class      QCtmCursorMultiPageTableModel
+    \brief      基于游标的异步分页 TableModel, 适用于总行数未知或统计代价过高的数据源.
+                每页由 QCtmAbstractCursorPageProvider 在工作线程中按上一页返回的游标读取,
+                页面数量随读取逐步发现, 读到没有下一页的游标前 isPageCountKnown 返回 false.
+                最近访问的页面保存在 LRU 缓存中, 页面读取完成前显示一行占位行.
+    \inherits   QCtmAbstractMultiPageTableModel
+    \ingroup    QCustomUi
+    \inmodule   QCustomUi
+    \inheaderfile QCtmCursorMultiPageTableModel.h
+    \sa         QCtmAbstractCursorPageProvider, QCtmAsyncMultiPageTableModel
+*/
+
+/*!
+    \fn         void QCtmCursorMultiPageTableModel::pageLoaded(int page)
+    \brief      页面 \a page 读取完成并加入缓存后发送该信号.
+*/
+
+/*!
+    \brief      构造函数 \a parent.
+*/
+QCtmCursorMultiPageTableModel::QCtmCursorMultiPageTableModel(QObject* parent /* = nullptr */)
+    : QCtmAbstractMultiPageTableModel(parent), m_impl(std::make_unique<Impl>())
+{
+    m_impl->placeholder = tr("Loading...");
+    m_impl->cache.setMaxCost(m_impl->effectiveCacheSize());
+    m_impl->fetcher = std::make_unique<QCtmPageFetcher>();
+}
+
+/*!
+    \brief      析构函数, 等待正在进行的读取返回.
+*/
+QCtmCursorMultiPageTableModel::~QCtmCursorMultiPageTableModel()
+{
+    m_impl->fetcher.reset();
+}
+
+/*!
+    \brief      设置数据提供者 \a provider, 从第一页重新开始读取.
+    \sa         provider
+*/
+void QCtmCursorMultiPageTableModel::setProvider(QCtmCursorPageProviderPtr provider)
+{
+    beginResetModel();
+    m_impl->provider = std::move(provider);
+    invalidate(pageRowCount());
+    endResetModel();
+    setCurrentPage(0);
+    requestPages();
+}
+
+/*!
+    \brief      返回数据提供者.
+    \sa         setProvider
+*/
+QCtmCursorPageProviderPtr QCtmCursorMultiPageTableModel::provider() const
+{
+    return m_impl->provider;
+}
+
+/*!
+    \brief      设置缓存的页面数量 \a pages. 被淘汰的页面再次访问时使用保存的游标重新读取.
+    \sa         cacheSize
+*/
+void QCtmCursorMultiPageTableModel::setCacheSize(int pages)
+{
+    m_impl->cacheSize = std::max(pages, 1);
+    m_impl->cache.setMaxCost(m_impl->effectiveCacheSize());
+}
+
+/*!
+    \brief      返回缓存的页面数量.
+    \sa         setCacheSize
+*/
+int QCtmCursorMultiPageTableModel::cacheSize() const
+{
+    return m_impl->cacheSize;
+}
+
+/*!
+    \brief      设置是否预取已知游标的前后两页 \a enable. 关闭时只在访问页面时读取.
+    \sa         prefetchEnabled
+*/
+void QCtmCursorMultiPageTableModel::setPrefetchEnabled(bool enable)
+{
+    m_impl->prefetch = enable;
+    m_impl->cache.setMaxCost(m_impl->effectiveCacheSize());
+    requestPages();
+}
+
+/*!
+    \brief      返回是否预取前后两页.
+    \sa         setPrefetchEnabled
+*/
+bool QCtmCursorMultiPageTableModel::prefetchEnabled() const
+{
+    return m_impl->prefetch;
+}
+
+/*!
+    \brief      设置页面读取完成前占位行显示的文字 \a text.
+    \sa         placeholderText
+*/
+void QCtmCursorMultiPageTableModel::setPlaceholderText(const QString& text)
+{
+    m_impl->placeholder = text;
+    if (!isPageLoaded(currentPage()) && rowCount() > 0)
+        emit dataChanged(index(0, 0), index(0, 0), { Qt::DisplayRole });
+}
+
+/*!
+    \brief      返回页面读取完成前占位行显示的文字.
+    \sa         setPlaceholderText
+*/
+const QString& QCtmCursorMultiPageTableModel::placeholderText() const
+{
+    return m_impl->placeholder;
+}
+
+/*!
+    \brief      返回页面 \a page 是否已在缓存中.
+*/
+bool QCtmCursorMultiPageTableModel::isPageLoaded(int page) const
+{
+    return m_impl->cache.contains(page);
+}
+
+/*!
+    \reimp
+*/
+int QCtmCursorMultiPageTableModel::rowCount(const QModelIndex& parent /* = QModelIndex() */) const
+{
+    if (parent.isValid() || currentPage() >= pageCount())
+        return 0;
+    if (auto rows = m_impl->cache.object(currentPage()))
+        return rows->size();
+    return 1; // 占位行
+}
+
+/*!
+    \reimp
+*/
+int QCtmCursorMultiPageTableModel::columnCount(const QModelIndex& parent /* = QModelIndex() */) const
+{
+    if (parent.isValid() || !m_impl->provider)
+        return 0;
+    return m_impl->provider->columnCount();
+}
+
+/*!
+    \reimp
+*/
+QVariant QCtmCursorMultiPageTableModel::data(const QModelIndex& index, int role /* = Qt::DisplayRole */) const
+{
+    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::EditRole))
+        return {};
+    auto rows = m_impl->cache.object(currentPage());
+    if (!rows)
+        return index.column() == 0 && role == Qt::DisplayRole ? QVariant(m_impl->placeholder) : QVariant();
+    if (index.row() >= rows->size())
+        return {};
+    const auto& row = rows->at(index.row());
+    return index.column() < row.size() ? row.at(index.column()) : QVariant();
+}
+
+/*!
+    \reimp
+*/
+QVariant QCtmCursorMultiPageTableModel::headerData(int section, Qt::Orientation orientation, int role /* = Qt::DisplayRole */) const
+{
+    if (m_impl->provider)
+    {
+        if (auto data = m_impl->provider->headerData(section, orientation, role); data.isValid())
+            return data;
+    }
+    return QCtmAbstractMultiPageTableModel::headerData(section, orientation, role);
+}
+
+/*!
+    \reimp
+                返回已发现的页面数量, 总数未知时包含下一页.
+*/
+int QCtmCursorMultiPageTableModel::pageCount() const
+{
+    return m_impl->cursors.size();
+}
+
+/*!
+    \reimp
+*/
+bool QCtmCursorMultiPageTableModel::isPageCountKnown() const
+{
+    return m_impl->end || !m_impl->provider;
+}
+
+/*!
+    \reimp
+*/
+void QCtmCursorMultiPageTableModel::setCurrentPage(int page)
+{
+    QCtmAbstractMultiPageTableModel::setCurrentPage(page);
+    requestPages();
+}
+
+/*!
+    \reimp
+                游标与每页行数相关, 改变后从第一页重新读取.
+*/
+void QCtmCursorMultiPageTableModel::setPageRowCount(int rowCount)
+{
+    beginResetModel();
+    invalidate(rowCount);
+    endResetModel();
+    QCtmAbstractMultiPageTableModel::setPageRowCount(rowCount);
+    setCurrentPage(0);
+    requestPages();
+}
+
+/*!
+    \brief      清空缓存与游标, 从第一页重新读取, 数据源内容改变后调用.
+*/
+void QCtmCursorMultiPageTableModel::refresh()
+{
+    beginResetModel();
+    invalidate(pageRowCount());
+    endResetModel();
+    setCurrentPage(0);
+    requestPages();
+}
+
+/*!
+    \brief      请求当前页面, 开启预取时同时请求游标已知的前后两页, 已缓存的页面不再读取.
+*/
+void QCtmCursorMultiPageTableModel::requestPages()
+{
+    if (!m_impl->provider)
+        return;
+    QVector<int> pages;
+    auto want = [&](int page)
+    {
+        if (page >= 0 && page < pageCount() && !m_impl->cache.contains(page))
+            pages.push_back(page);
+    };
+    want(currentPage());
+    if (m_impl->prefetch)
+    {
+        want(currentPage() + 1);
+        want(currentPage() - 1);
+    }
+    m_impl->fetcher->request(pages);
+}
+
+/*!
+    \brief      丢弃缓存、游标与未完成的请求, 以每页 \a pageRowCount 行重新设置读取任务.
+*/
+void QCtmCursorMultiPageTableModel::invalidate(int pageRowCount)
+{
+    m_impl->cache.clear();
+    m_impl->generation++;
+    {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        QMutexLocker locker(&m_impl->cursorMutex);
+#else
+        QMutexLocker<QMutex> locker(&m_impl->cursorMutex);
+#endif
+        m_impl->cursors.clear();
+        if (m_impl->provider)
+            m_impl->cursors.push_back(QVariant()); // 第一页
+        m_impl->end = false;
+    }
+
+    auto provider = m_impl->provider;
+    if (!provider)
+    {
+        m_impl->fetcher->reset({});
+        return;
+    }
+    const auto generation = m_impl->generation;
+    m_impl->fetcher->reset(
+        [this, provider, generation, pageRowCount](int page)
+        {
+            QVariant cursor;
+            {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+                QMutexLocker locker(&m_impl->cursorMutex);
+#else
+                QMutexLocker<QMutex> locker(&m_impl->cursorMutex);
+#endif
+                cursor = m_impl->cursors.value(page);
+            }
+            auto result = provider->fetch(cursor, pageRowCount);
+            QMetaObject::invokeMethod(
+                this,
+                [this, generation, page, result = std::move(result)]() mutable
+                {
+                    onPageReady(generation, page, std::move(result));
+                },
+                Qt::QueuedConnection);
+        });
+}
+
+/*!
+    \brief      页面 \a page 读取完成 \a result, 记录下一页的游标, 忽略代数 \a generation 过期的结果.
+*/
+void QCtmCursorMultiPageTableModel::onPageReady(quint64 generation, int page, QCtmAbstractCursorPageProvider::Page result)
+{
+    if (generation != m_impl->generation)
+        return;
+    // 当前页由占位行变为实际数据, 行数可能改变, 以重置通知视图; 页面数量改变时由基类在重置后发送 pageCountChanged
+    const bool current = page == currentPage();
+    if (current)
+        beginResetModel();
+    const auto beforeCount = pageCount();
+    const auto beforeEnd   = m_impl->end;
+    if (page + 1 == m_impl->cursors.size())
+    {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        QMutexLocker locker(&m_impl->cursorMutex);
+#else
+        QMutexLocker<QMutex> locker(&m_impl->cursorMutex);
+#endif
+        if (result.next.isValid())
+            m_impl->cursors.push_back(std::move(result.next));
+        else
+            m_impl->end = true;
+    }
+    m_impl->cache.insert(page, new Rows(std::move(result.rows)));
+    if (current)
+        endResetModel();
+    if ((!current && pageCount() != beforeCount) || (m_impl->end != beforeEnd && pageCount() == beforeCount))
+        emit pageCountChanged(pageCount()); // 发现新页面或总数已确定
+    emit pageLoaded(page);
+    requestPages(); // 新发现的下一页可以预取
+}
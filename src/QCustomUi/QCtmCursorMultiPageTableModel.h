@@ -0,0 +1,61 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include "QCtmAbstractCursorPageProvider.h"
+#include "QCtmAbstractMultiPageTableModel.h"
+
+class QCUSTOMUI_EXPORT QCtmCursorMultiPageTableModel : public QCtmAbstractMultiPageTableModel
+{
+    Q_OBJECT
+public:
+    explicit QCtmCursorMultiPageTableModel(QObject* parent = nullptr);
+    ~QCtmCursorMultiPageTableModel();
+    void setProvider(QCtmCursorPageProviderPtr provider);
+    QCtmCursorPageProviderPtr provider() const;
+    void setCacheSize(int pages);
+    int cacheSize() const;
+    void setPrefetchEnabled(bool enable);
+    bool prefetchEnabled() const;
+    void setPlaceholderText(const QString& text);
+    const QString& placeholderText() const;
+    bool isPageLoaded(int page) const;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    int pageCount() const override;
+    bool isPageCountKnown() const override;
+public slots:
+    void setCurrentPage(int page) override;
+    void setPageRowCount(int rowCount) override;
+    void refresh();
+signals:
+    void pageLoaded(int page);
+
+private:
+    void requestPages();
+    void invalidate(int pageRowCount);
+    void onPageReady(quint64 generation, int page, QCtmAbstractCursorPageProvider::Page result);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
@@ -18,6 +18,8 @@
 **********************************************************************************/
 
 #include "QCtmLogData.h"
+#include "Private/QCtmLogLocation_p.h"
+#include "Private/QCtmLogPool_p.h"
 
 /*!
     \class      QCtmLogData
@@ -37,15 +39,23 @@
 */
 
 /*!
-    \brief      构造函数 \a type, \a context, \a msg.
+    \brief      构造函数 \a type, \a context, \a msg, 日志时间为当前时间.
 */
 QCtmLogData::QCtmLogData(QtMsgType type, const QMessageLogContext& context, const QString& msg)
-    : m_type(type), m_msg(msg), m_dateTime(QDateTime::currentDateTime())
+    : m_msecs(QDateTime::currentMSecsSinceEpoch())
+    , m_location(QCtmLogLocation::intern(context))
+    , m_type(static_cast<quint8>(type))
+    , m_msg(msg)
+{
+}
+
+/*!
+    \brief      构造函数 \a type, 驻留的上下文编号 \a location, \a msg, 日志时间 \a msecsSinceEpoch.
+    \sa         internLocation
+*/
+QCtmLogData::QCtmLogData(QtMsgType type, quint32 location, const QString& msg, qint64 msecsSinceEpoch)
+    : m_msecs(msecsSinceEpoch), m_location(location), m_type(static_cast<quint8>(type)), m_msg(msg)
 {
-    m_context.category = context.category;
-    m_context.file     = context.file;
-    m_context.line     = context.line;
-    m_context.function = context.function;
 }
 
 /*!
@@ -53,15 +63,44 @@ QCtmLogData::QCtmLogData(QtMsgType type, const QMessageLogContext& context, cons
 */
 QCtmLogData::~QCtmLogData() {}
 
+/*!
+    \brief      从日志内存池创建日志 \a type, \a context, \a msg, 日志时间为当前时间.
+*/
+QCtmLogDataPtr QCtmLogData::create(QtMsgType type, const QMessageLogContext& context, const QString& msg)
+{
+    return std::allocate_shared<QCtmLogData>(QCtmLogPoolAllocator<QCtmLogData>(), type, context, msg);
+}
+
+/*!
+    \overload
+                从日志内存池创建日志 \a type, \a location, \a msg, \a msecsSinceEpoch.
+*/
+QCtmLogDataPtr QCtmLogData::create(QtMsgType type, quint32 location, const QString& msg, qint64 msecsSinceEpoch)
+{
+    return std::allocate_shared<QCtmLogData>(QCtmLogPoolAllocator<QCtmLogData>(), type, location, msg, msecsSinceEpoch);
+}
+
+/*!
+    \brief      驻留日志上下文 \a context 并返回其编号, 相同的文件、行号、函数和分类返回相同的编号.
+    \sa         location, context
+*/
+quint32 QCtmLogData::internLocation(const QMessageLogContext& context) { return QCtmLogLocation::intern(context); }
+
 /*!
     \brief      返回日志类型.
 */
-QtMsgType QCtmLogData::type() const { return m_type; }
+QtMsgType QCtmLogData::type() const { return static_cast<QtMsgType>(m_type); }
 
 /*!
     \brief      返回日志上下文.
 */
-const QMessageLogContext& QCtmLogData::context() const { return m_context; }
+const QMessageLogContext& QCtmLogData::context() const { return QCtmLogLocation::context(m_location); }
+
+/*!
+    \brief      返回日志上下文的驻留编号.
+    \sa         internLocation
+*/
+quint32 QCtmLogData::location() const { return m_location; }
 
 /*!
     \brief      返回日志内容.
@@ -71,4 +110,21 @@ const QString& QCtmLogData::msg() const { return m_msg; }
 /*!
     \brief      返回日志时间.
 */
-const QDateTime& QCtmLogData::dateTime() const { return m_dateTime; }
+QDateTime QCtmLogData::dateTime() const { return QDateTime::fromMSecsSinceEpoch(m_msecs); }
+
+/*!
+    \brief      返回日志时间, 自 1970-01-01T00:00:00 UTC 起的毫秒数.
+*/
+qint64 QCtmLogData::msecsSinceEpoch() const { return m_msecs; }
+
+/*!
+    \brief      设置日志的重复次数 \a count, 去重后的摘要日志记录被合并的日志数量.
+    \sa         repeatCount, QCtmLogManager::setDeduplicationWindow
+*/
+void QCtmLogData::setRepeatCount(quint32 count) { m_repeat = count; }
+
+/*!
+    \brief      返回日志的重复次数, 普通日志为 1.
+    \sa         setRepeatCount
+*/
+quint32 QCtmLogData::repeatCount() const { return m_repeat; }
@@ -34,17 +34,26 @@ public:
         DESC
     };
     QCtmLogData(QtMsgType type, const QMessageLogContext& context, const QString& msg);
+    QCtmLogData(QtMsgType type, quint32 location, const QString& msg, qint64 msecsSinceEpoch);
     ~QCtmLogData();
+    static std::shared_ptr<QCtmLogData> create(QtMsgType type, const QMessageLogContext& context, const QString& msg);
+    static std::shared_ptr<QCtmLogData> create(QtMsgType type, quint32 location, const QString& msg, qint64 msecsSinceEpoch);
+    static quint32 internLocation(const QMessageLogContext& context);
     QtMsgType type() const;
     const QMessageLogContext& context() const;
+    quint32 location() const;
     const QString& msg() const;
-    const QDateTime& dateTime() const;
+    QDateTime dateTime() const;
+    qint64 msecsSinceEpoch() const;
+    void setRepeatCount(quint32 count);
+    quint32 repeatCount() const;
 
 private:
-    QtMsgType m_type;
-    QMessageLogContext m_context;
+    qint64 m_msecs;
+    quint32 m_location;
+    quint32 m_repeat { 1 };
+    quint8 m_type;
     QString m_msg;
-    QDateTime m_dateTime;
 };
 
 using QCtmLogDataPtr = std::shared_ptr<QCtmLogData>;
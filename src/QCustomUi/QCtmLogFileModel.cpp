@@ -0,0 +1,727 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#include "QCtmLogFileModel.h"
+#include "Private/QCtmLogArchiver_p.h"
+#include "Private/QCtmLogLineParser_p.h"
+
+#include <QCache>
+#include <QFile>
+#include <QTemporaryFile>
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+enum class Column
+{
+    Level,
+    DateTime,
+    Message
+};
+
+constexpr size_t IndexBatch = 64 * 1024;
+
+inline QString msgLimit(const QString& msg) { return msg.size() > 512 ? msg.left(512) + "..." : msg; }
+
+// 记录的内容与首行中各字段的位置
+struct Fields
+{
+    const char* data;
+    qint64 size; // 不含行尾换行符
+    QCtmLogLineParser::Record record;
+};
+
+Fields splitRecord(const QCtmLogLineParser& parser, const char* data, const std::vector<qint64>& offsets, qint64 indexedEnd, size_t record)
+{
+    const auto begin = offsets[record];
+    const auto end   = record + 1 < offsets.size() ? offsets[record + 1] : indexedEnd;
+    const char* p    = data + begin;
+    qint64 size      = end - begin;
+    while (size > 0 && (p[size - 1] == '\n' || p[size - 1] == '\r'))
+        size--;
+    Fields fields { p, size, {} };
+    auto newline  = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(size)));
+    auto lineSize = newline ? newline - p : size;
+    if (lineSize > 0 && p[lineSize - 1] == '\r')
+        lineSize--;
+    if (!parser.match(p, lineSize, fields.record))
+        fields.record = {}; // 文件开头不符合格式的内容整体作为消息
+    return fields;
+}
+
+inline QString messageOf(const Fields& fields)
+{
+    return QString::fromUtf8(fields.data + fields.record.message, static_cast<int>(fields.size - fields.record.message));
+}
+} // namespace
+
+struct QCtmLogFileModel::Impl
+{
+    struct File
+    {
+        QString name;
+        bool compressed { false };
+        std::shared_ptr<QFile> file; // 压缩的日志文件为后台解压的临时文件, 后台查询期间由查询任务共同持有映射
+        const char* data { nullptr };
+        qint64 size { 0 };
+        qint64 indexedEnd { 0 };
+        std::vector<qint64> offsets; // 每条记录的起始位置
+        std::vector<quint8> types;
+    };
+
+    // 仅为可见行解析的显示内容
+    struct Row
+    {
+        QString dateTime;
+        QString msg;
+        QString display; // 截断后的显示文本
+    };
+
+    std::vector<File> files;
+    std::vector<int> firstRows; // 每个文件首条记录的全局行号
+    int rows { 0 };
+    QList<QString> headers;
+    QIcon infoIcon;
+    QIcon warningIcon;
+    QIcon errorIcon;
+    int errorCount { 0 };
+    int warningCount { 0 };
+    int infoCount { 0 };
+    QCtmLogLineParser parser;
+
+    QThread* indexer { nullptr };
+    std::atomic_bool cancel { false };
+    quint64 generation { 0 };
+    bool indexing { false };
+    qint64 totalBytes { 0 };
+    qint64 indexedBytes { 0 };
+    mutable QCache<int, Row> cache { 4096 };
+
+    inline std::pair<const File*, size_t> locate(int row) const
+    {
+        auto it         = std::upper_bound(firstRows.begin(), firstRows.end(), row) - 1;
+        const auto file = static_cast<size_t>(it - firstRows.begin());
+        return { &files[file], static_cast<size_t>(row - *it) };
+    }
+
+    inline void count(quint8 type)
+    {
+        switch (type)
+        {
+        case QtMsgType::QtInfoMsg:
+            infoCount++;
+            break;
+        case QtMsgType::QtWarningMsg:
+            warningCount++;
+            break;
+        case QtMsgType::QtCriticalMsg:
+            errorCount++;
+            break;
+        default:
+            break;
+        }
+    }
+
+    const Row* parse(int row) const
+    {
+        if (auto cached = cache.object(row))
+            return cached;
+        auto [file, record] = locate(row);
+        const auto fields   = splitRecord(parser, file->data, file->offsets, file->indexedEnd, record);
+        auto parsed         = new Row;
+        if (fields.record.time >= 0)
+            parsed->dateTime = QString::fromUtf8(fields.data + fields.record.time, static_cast<int>(fields.record.displaySize));
+        parsed->msg     = messageOf(fields);
+        parsed->display     = msgLimit(parsed->msg);
+        cache.insert(row, parsed);
+        return parsed;
+    }
+};
+
+/*!
+    \class      QCtmLogFileModel
+    \brief      日志文件 model, 以内存映射的方式浏览 QCtmLogManager 输出的日志文件.
+                文件的记录索引在后台线程中建立, 索引完成的部分立即可见, 时间与消息只在访问时解析.
+                记录按 setLogPattern 设置的行格式识别, 不符合格式的行属于上一条记录的多行消息.
+    \inherits   QCtmAbstractLogModel
+    \ingroup    QCustomUi
+    \inmodule   QCustomUi
+    \inheaderfile QCtmLogFileModel.h
+    \sa         QCtmLogWidget::openLogFiles
+*/
+
+/*!
+    \fn         void QCtmLogFileModel::indexingProgress(qint64 indexed, qint64 total)
+    \brief      索引进度变化时发送该信号, \a indexed 为已索引的字节数, \a total 为文件总字节数.
+*/
+
+/*!
+    \fn         void QCtmLogFileModel::indexingFinished()
+    \brief      索引完成时发送该信号.
+*/
+
+/*!
+    \brief      构造函数 \a parent.
+*/
+QCtmLogFileModel::QCtmLogFileModel(QObject* parent) : QCtmAbstractLogModel(QString(), false, parent), m_impl(std::make_unique<Impl>())
+{
+    m_impl->headers << tr("Lv") << tr("DateTime") << tr("Description");
+}
+
+/*!
+    \brief      析构函数.
+*/
+QCtmLogFileModel::~QCtmLogFileModel()
+{
+    stopIndexing();
+}
+
+/*!
+    \brief      打开日志文件 \a files, 多个文件按给定的顺序连续显示. 压缩的日志文件 (.log.qz) 在后台索引线程中解压到临时文件,
+                解压失败的文件不显示记录.
+    \return     所有文件均映射成功返回 true, 映射失败的文件被忽略.
+    \sa         files
+*/
+bool QCtmLogFileModel::setFiles(const QStringList& files)
+{
+    stopIndexing();
+    beginResetModel();
+    m_impl->files.clear();
+    m_impl->firstRows.clear();
+    m_impl->cache.clear();
+    m_impl->rows         = 0;
+    m_impl->infoCount    = 0;
+    m_impl->warningCount = 0;
+    m_impl->errorCount   = 0;
+    m_impl->totalBytes   = 0;
+    m_impl->indexedBytes = 0;
+    bool ok              = true;
+    for (const auto& fileName : files)
+    {
+        Impl::File file;
+        file.name = fileName;
+        if (fileName.endsWith(QCtmLogArchiver::Suffix))
+        {
+            file.compressed = true; // 解压与映射由索引线程完成
+        }
+        else
+        {
+            file.file = std::make_shared<QFile>(fileName);
+            if (!file.file->open(QFile::ReadOnly))
+            {
+                ok = false;
+                continue;
+            }
+            file.size = file.file->size();
+            if (file.size > 0)
+            {
+                file.data = reinterpret_cast<const char*>(file.file->map(0, file.size));
+                if (!file.data)
+                {
+                    ok = false;
+                    continue;
+                }
+            }
+        }
+        m_impl->totalBytes += file.size;
+        m_impl->files.push_back(std::move(file));
+        m_impl->firstRows.push_back(0);
+    }
+    endResetModel();
+    startIndexing();
+    return ok;
+}
+
+/*!
+    \brief      返回打开的日志文件.
+    \sa         setFiles
+*/
+QStringList QCtmLogFileModel::files() const
+{
+    QStringList list;
+    for (const auto& file : m_impl->files)
+    {
+        list << file.name;
+    }
+    return list;
+}
+
+/*!
+    \brief      设置日志文件的行格式 \a pattern, 格式与 QCtmLogManager::setLogPattern 相同, 已打开的文件按新格式重新索引.
+                {msg} 必须恰好出现一次且之后只能有 {repeat}, {msg} 之前不能换行, {file} {function} {category}
+                不能位于行首且其后必须紧跟文本.
+    \return     格式有效返回 true, 否则保持原格式并返回 false.
+    \sa         logPattern
+*/
+bool QCtmLogFileModel::setLogPattern(const QString& pattern)
+{
+    if (pattern == m_impl->parser.pattern())
+        return true;
+    if (!m_impl->parser.setPattern(pattern))
+        return false;
+    if (!m_impl->files.empty())
+        setFiles(files());
+    return true;
+}
+
+/*!
+    \brief      返回日志文件的行格式, 默认与 QCtmLogManager 的默认格式相同.
+    \sa         setLogPattern
+*/
+QString QCtmLogFileModel::logPattern() const
+{
+    return m_impl->parser.pattern();
+}
+
+/*!
+    \brief      返回是否正在建立索引.
+    \sa         indexingProgress, indexingFinished
+*/
+bool QCtmLogFileModel::isIndexing() const
+{
+    return m_impl->indexing;
+}
+
+/*!
+    \brief      关闭所有日志文件.
+*/
+void QCtmLogFileModel::clear()
+{
+    setFiles({});
+}
+
+/*!
+    \reimp
+                直接从映射的文件中解析消息, 不经过也不占用显示内容的缓存.
+*/
+QString QCtmLogFileModel::messageAt(int row) const
+{
+    if (row < 0 || row >= m_impl->rows)
+        return {};
+    if (auto cached = m_impl->cache.object(row))
+        return cached->msg;
+    auto [file, record] = m_impl->locate(row);
+    return messageOf(splitRecord(m_impl->parser, file->data, file->offsets, file->indexedEnd, record));
+}
+
+/*!
+    \reimp
+                返回的函数持有文件映射与当前记录索引的快照, 在工作线程中直接从映射的文件中解析消息.
+*/
+QCtmAbstractLogModel::MessageReader QCtmLogFileModel::messageReader() const
+{
+    struct Snapshot
+    {
+        struct File
+        {
+            std::shared_ptr<QFile> file; // 保持映射有效
+            const char* data;
+            std::vector<qint64> offsets;
+            qint64 indexedEnd;
+        };
+        std::vector<File> files;
+        std::vector<int> firstRows;
+        int rows;
+        QCtmLogLineParser parser;
+    };
+    auto snapshot = std::make_shared<Snapshot>();
+    for (const auto& file : m_impl->files)
+    {
+        snapshot->files.push_back({ file.file, file.data, file.offsets, file.indexedEnd });
+    }
+    snapshot->firstRows = m_impl->firstRows;
+    snapshot->rows      = m_impl->rows;
+    snapshot->parser    = m_impl->parser;
+    return [snapshot](int row) -> QString
+    {
+        if (row < 0 || row >= snapshot->rows)
+            return {};
+        const auto& firstRows = snapshot->firstRows;
+        auto it               = std::upper_bound(firstRows.begin(), firstRows.end(), row) - 1;
+        const auto& file      = snapshot->files[static_cast<size_t>(it - firstRows.begin())];
+        return messageOf(splitRecord(snapshot->parser, file.data, file.offsets, file.indexedEnd, static_cast<size_t>(row - *it)));
+    };
+}
+
+/*!
+    \reimp
+*/
+QVariant QCtmLogFileModel::data(const QModelIndex& index, int role /* = Qt::DisplayRole */) const
+{
+    if (!index.isValid() || index.row() >= m_impl->rows)
+        return QVariant();
+    if (role == TypeRole || role == Qt::DecorationRole)
+    {
+        auto [file, record] = m_impl->locate(index.row());
+        const auto type     = file->types[record];
+        if (role == TypeRole)
+            return int(type);
+        if (index.column() == 0)
+        {
+            switch (type)
+            {
+            case QtMsgType::QtInfoMsg:
+                return m_impl->infoIcon;
+            case QtMsgType::QtWarningMsg:
+                return m_impl->warningIcon;
+            case QtMsgType::QtCriticalMsg:
+                return m_impl->errorIcon;
+            default:
+                break;
+            }
+        }
+        return QVariant();
+    }
+    if (role == TimeRole)
+    {
+        auto [file, record] = m_impl->locate(index.row());
+        const auto fields   = splitRecord(m_impl->parser, file->data, file->offsets, file->indexedEnd, record);
+        qint64 msecs;
+        if (m_impl->parser.parseTime(fields.data, fields.record, msecs))
+            return msecs;
+        return QVariant();
+    }
+    if (role != Qt::DisplayRole && role != Qt::ToolTipRole && role != CopyMessageRole)
+        return QVariant();
+
+    const auto row = m_impl->parse(index.row());
+    switch (static_cast<Column>(index.column()))
+    {
+    case Column::DateTime:
+        return role == Qt::ToolTipRole ? QVariant() : row->dateTime;
+    case Column::Message:
+        return role == CopyMessageRole ? row->msg : row->display;
+    default:
+        break;
+    }
+    return QVariant();
+}
+
+/*!
+    \reimp
+*/
+QVariant QCtmLogFileModel::headerData(int section, Qt::Orientation orientation, int role /* = Qt::DisplayRole */) const
+{
+    if (role == Qt::DisplayRole && orientation == Qt::Horizontal)
+    {
+        return m_impl->headers[section];
+    }
+    return QVariant();
+}
+
+/*!
+    \reimp
+*/
+int QCtmLogFileModel::rowCount([[maybe_unused]] const QModelIndex& parent /*= QModelIndex()*/) const
+{
+    return m_impl->rows;
+}
+
+/*!
+    \reimp
+*/
+int QCtmLogFileModel::columnCount([[maybe_unused]] const QModelIndex& parent /*= QModelIndex()*/) const
+{
+    return m_impl->headers.size();
+}
+
+/*!
+    \brief      设置 Info 等级日志图标 \a icon.
+    \sa         infoIcon()
+*/
+void QCtmLogFileModel::setInfoIcon(const QIcon& icon)
+{
+    m_impl->infoIcon = icon;
+}
+
+/*!
+    \brief      返回 Info 等级日志图标.
+    \sa         setInfoIcon
+*/
+const QIcon& QCtmLogFileModel::infoIcon() const
+{
+    return m_impl->infoIcon;
+}
+
+/*!
+    \brief      设置 Warning 等级日志图标 \a icon.
+    \sa         warningIcon()
+*/
+void QCtmLogFileModel::setWarningIcon(const QIcon& icon)
+{
+    m_impl->warningIcon = icon;
+}
+
+/*!
+    \brief      返回 Warning 等级日志图标.
+    \sa         setWarningIcon
+*/
+const QIcon& QCtmLogFileModel::warningIcon() const
+{
+    return m_impl->warningIcon;
+}
+
+/*!
+    \brief      设置 Error 等级日志图标 \a icon.
+    \sa         errorIcon()
+*/
+void QCtmLogFileModel::setErrorIcon(const QIcon& icon)
+{
+    m_impl->errorIcon = icon;
+}
+
+/*!
+    \brief      返回 Error 等级日志图标.
+    \sa         setErrorIcon
+*/
+const QIcon& QCtmLogFileModel::errorIcon() const
+{
+    return m_impl->errorIcon;
+}
+
+/*!
+    \brief      返回已索引的 Warning 等级日志数量.
+*/
+int QCtmLogFileModel::warningCount() const
+{
+    return m_impl->warningCount;
+}
+
+/*!
+    \brief      返回已索引的 Info 等级日志数量.
+*/
+int QCtmLogFileModel::infoCount() const
+{
+    return m_impl->infoCount;
+}
+
+/*!
+    \brief      返回已索引的 Error 等级日志数量.
+*/
+int QCtmLogFileModel::errorCount() const
+{
+    return m_impl->errorCount;
+}
+
+/*!
+    \brief      日志文件 model 只显示文件内容, 忽略实时日志 \a log.
+*/
+void QCtmLogFileModel::onLog([[maybe_unused]] QCtmLogDataPtr log)
+{
+}
+
+/*!
+    \reimp
+*/
+void QCtmLogFileModel::retranslateUi()
+{
+    m_impl->headers.clear();
+    m_impl->headers << tr("Lv") << tr("DateTime") << tr("Description");
+}
+
+/*!
+    \brief      在后台线程中解压并映射压缩的文件, 建立记录索引, 每索引一批记录即追加到 model 中.
+*/
+void QCtmLogFileModel::startIndexing()
+{
+    struct Source
+    {
+        QString name;
+        bool compressed;
+        const char* data;
+        qint64 size;
+    };
+    std::vector<Source> sources;
+    for (const auto& file : m_impl->files)
+    {
+        sources.push_back({ file.name, file.compressed, file.data, file.size });
+    }
+    if (sources.empty())
+        return;
+
+    const auto generation = ++m_impl->generation;
+    m_impl->indexing      = true;
+    m_impl->indexer       = QThread::create(
+        [this, generation, sources = std::move(sources), parser = m_impl->parser]
+        {
+            for (int i = 0; i < static_cast<int>(sources.size()); i++)
+            {
+                const auto* data = sources[i].data;
+                auto size        = sources[i].size;
+                if (sources[i].compressed)
+                {
+                    auto file = decompress(sources[i].name, data, size);
+                    if (!file)
+                        continue;
+                    QMetaObject::invokeMethod(
+                        this, [this, generation, i, file, data, size] { attachFile(generation, i, file, data, size); }, Qt::QueuedConnection);
+                }
+                std::vector<qint64> offsets;
+                std::vector<quint8> types;
+                QCtmLogLineParser::Record record;
+                qint64 pos = 0;
+                auto post  = [&]
+                {
+                    QMetaObject::invokeMethod(
+                        this,
+                        [this, generation, i, offsets = std::move(offsets), types = std::move(types), pos]
+                        { appendIndex(generation, i, offsets, types, pos); },
+                        Qt::QueuedConnection);
+                    offsets = {};
+                    types   = {};
+                };
+                while (pos < size)
+                {
+                    if (m_impl->cancel.load(std::memory_order_relaxed))
+                        return;
+                    const auto* line = data + pos;
+                    const auto rest  = size - pos;
+                    auto next        = static_cast<const char*>(std::memchr(line, '\n', static_cast<size_t>(rest)));
+                    auto lineSize    = next ? next - line : rest;
+                    if (lineSize > 0 && line[lineSize - 1] == '\r')
+                        lineSize--;
+                    const auto matched = parser.match(line, lineSize, record);
+                    if (pos == 0 || matched)
+                    {
+                        if (offsets.size() >= IndexBatch)
+                            post();
+                        offsets.push_back(pos);
+                        types.push_back(matched ? record.type : quint8(QtMsgType::QtInfoMsg));
+                    }
+                    pos = next ? next - data + 1 : size;
+                }
+                post();
+            }
+            QMetaObject::invokeMethod(
+                this,
+                [this, generation]
+                {
+                    if (generation != m_impl->generation)
+                        return;
+                    m_impl->indexing = false;
+                    emit indexingFinished();
+                },
+                Qt::QueuedConnection);
+        });
+    m_impl->indexer->setObjectName("QCtmLogFileIndexer");
+    m_impl->indexer->start(QThread::LowPriority);
+}
+
+/*!
+    \brief      在索引线程中将压缩的日志文件 \a fileName 解压到临时文件并映射, \a data 与 \a size 返回映射的内容.
+    \return     失败返回空指针.
+*/
+std::shared_ptr<QFile> QCtmLogFileModel::decompress(const QString& fileName, const char*& data, qint64& size) const
+{
+    auto temp = std::make_shared<QTemporaryFile>();
+    if (!temp->open())
+        return nullptr;
+    temp->close(); // 只需创建文件, 解压时另行打开
+    if (!QCtmLogArchiver::decompressFile(fileName, temp->fileName()))
+        return nullptr;
+    std::shared_ptr<QFile> file = std::move(temp);
+    if (!file->open(QFile::ReadOnly))
+        return nullptr;
+    size = file->size();
+    data = nullptr;
+    if (size > 0)
+    {
+        data = reinterpret_cast<const char*>(file->map(0, size));
+        if (!data)
+            return nullptr;
+    }
+    file->moveToThread(thread()); // 由 model 所在的线程持有与释放
+    return file;
+}
+
+/*!
+    \brief      将索引线程解压并映射的第 \a index 个文件 \a file 交给 model, \a data 与 \a size 为映射的内容.
+                \a generation 与当前索引不一致时忽略.
+*/
+void QCtmLogFileModel::attachFile(quint64 generation, int index, const std::shared_ptr<QFile>& file, const char* data, qint64 size)
+{
+    if (generation != m_impl->generation)
+        return;
+    auto& target = m_impl->files[index];
+    target.file  = file;
+    target.data  = data;
+    target.size  = size;
+    m_impl->totalBytes += size;
+    emit indexingProgress(m_impl->indexedBytes, m_impl->totalBytes);
+}
+
+/*!
+    \brief      停止后台索引.
+*/
+void QCtmLogFileModel::stopIndexing()
+{
+    if (!m_impl->indexer)
+        return;
+    m_impl->cancel = true;
+    m_impl->indexer->wait();
+    delete m_impl->indexer;
+    m_impl->indexer  = nullptr;
+    m_impl->cancel   = false;
+    m_impl->indexing = false;
+    ++m_impl->generation; // 丢弃已投递但尚未处理的索引
+}
+
+/*!
+    \brief      将第 \a file 个文件新索引的记录 \a offsets 与等级 \a types 追加到 model, \a end 为已索引的位置.
+                \a generation 与当前索引不一致时忽略.
+*/
+void QCtmLogFileModel::appendIndex(quint64 generation,
+                                   int file,
+                                   const std::vector<qint64>& offsets,
+                                   const std::vector<quint8>& types,
+                                   qint64 end)
+{
+    if (generation != m_impl->generation)
+        return;
+    auto& target = m_impl->files[file];
+    // 上一批的最后一条记录随索引推进而变长
+    if (!target.offsets.empty())
+        m_impl->cache.remove(m_impl->firstRows[file] + static_cast<int>(target.offsets.size()) - 1);
+    m_impl->indexedBytes += end - target.indexedEnd;
+    target.indexedEnd = end;
+    if (!offsets.empty())
+    {
+        const auto count = static_cast<int>(offsets.size());
+        const auto first = m_impl->firstRows[file] + static_cast<int>(target.offsets.size());
+        beginInsertRows(QModelIndex(), first, first + count - 1);
+        target.offsets.insert(target.offsets.end(), offsets.begin(), offsets.end());
+        target.types.insert(target.types.end(), types.begin(), types.end());
+        for (auto type : types)
+        {
+            m_impl->count(type);
+        }
+        for (size_t i = file + 1; i < m_impl->firstRows.size(); i++)
+        {
+            m_impl->firstRows[i] += count;
+        }
+        m_impl->rows += count;
+        endInsertRows();
+    }
+    emit indexingProgress(m_impl->indexedBytes, m_impl->totalBytes);
+}
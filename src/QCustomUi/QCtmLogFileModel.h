@@ -0,0 +1,80 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include "QCtmAbstractLogModel.h"
+
+#include <QIcon>
+
+#include <memory>
+
+class QFile;
+
+class QCUSTOMUI_EXPORT QCtmLogFileModel : public QCtmAbstractLogModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QIcon infoIcon READ infoIcon WRITE setInfoIcon)
+    Q_PROPERTY(QIcon warningIcon READ warningIcon WRITE setWarningIcon)
+    Q_PROPERTY(QIcon errorIcon READ errorIcon WRITE setErrorIcon)
+public:
+    explicit QCtmLogFileModel(QObject* parent = nullptr);
+    ~QCtmLogFileModel();
+
+    bool setFiles(const QStringList& files);
+    QStringList files() const;
+    bool setLogPattern(const QString& pattern);
+    QString logPattern() const;
+    bool isIndexing() const;
+    void clear() override;
+    QString messageAt(int row) const override;
+    MessageReader messageReader() const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    void setInfoIcon(const QIcon& icon);
+    const QIcon& infoIcon() const;
+    void setWarningIcon(const QIcon& icon);
+    const QIcon& warningIcon() const;
+    void setErrorIcon(const QIcon& icon);
+    const QIcon& errorIcon() const;
+    int warningCount() const;
+    int infoCount() const;
+    int errorCount() const;
+signals:
+    void indexingProgress(qint64 indexed, qint64 total);
+    void indexingFinished();
+public slots:
+    void onLog(QCtmLogDataPtr log) override;
+
+protected:
+    void retranslateUi() override;
+
+private:
+    void startIndexing();
+    void stopIndexing();
+    std::shared_ptr<QFile> decompress(const QString& fileName, const char*& data, qint64& size) const;
+    void attachFile(quint64 generation, int index, const std::shared_ptr<QFile>& file, const char* data, qint64 size);
+    void appendIndex(quint64 generation, int file, const std::vector<qint64>& offsets, const std::vector<quint8>& types, qint64 end);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
@@ -0,0 +1,248 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#include "QCtmLogFileSink.h"
+#include "Private/QCtmLogFormatter_p.h"
+#include "QCtmLogData.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <algorithm>
+
+struct QCtmLogFileSink::Impl
+{
+    QString fileName;
+    QFile file;
+    qint64 fileSize { 0 };
+    qint64 maxFileSize { 0 };
+    int maxBackupCount { 5 };
+    QCtmLogFormatter formatter;
+    QByteArray buffer;
+    mutable QMutex mutex;
+
+    bool open()
+    {
+        if (file.isOpen())
+            return true;
+        QDir().mkpath(QFileInfo(fileName).absolutePath());
+        file.setFileName(fileName);
+        if (!file.open(QFile::WriteOnly | QFile::Append | QFile::Unbuffered))
+            return false;
+        fileSize = file.size();
+        return true;
+    }
+
+    // file.log -> file.log.1 -> ... -> file.log.N, 超出数量的备份被删除
+    void rotate()
+    {
+        file.close();
+        QFile::remove(QString("%1.%2").arg(fileName).arg(maxBackupCount));
+        for (int i = maxBackupCount - 1; i >= 1; i--)
+        {
+            QFile::rename(QString("%1.%2").arg(fileName).arg(i), QString("%1.%2").arg(fileName).arg(i + 1));
+        }
+        if (maxBackupCount > 0)
+            QFile::rename(fileName, fileName + ".1");
+        else
+            QFile::remove(fileName);
+    }
+};
+
+/*!
+    \class      QCtmLogFileSink
+    \brief      写入单个日志文件的输出目标, 设置文件大小上限后按大小轮转.
+    \inherits   QCtmAbstractLogSink
+    \ingroup    QCustomUi
+    \inmodule   QCustomUi
+    \inheaderfile QCtmLogFileSink.h
+    \sa         QCtmLogManager::addSink
+*/
+
+/*!
+    \brief      构造一个写入文件 \a fileName 的输出目标, 文件在第一次写入时打开.
+*/
+QCtmLogFileSink::QCtmLogFileSink(const QString& fileName) : m_impl(std::make_unique<Impl>())
+{
+    m_impl->fileName = fileName;
+}
+
+/*!
+    \brief      析构函数.
+*/
+QCtmLogFileSink::~QCtmLogFileSink() {}
+
+/*!
+    \brief      返回日志文件名.
+*/
+QString QCtmLogFileSink::fileName() const
+{
+    return m_impl->fileName;
+}
+
+/*!
+    \brief      设置日志行格式 \a pattern, 格式与 QCtmLogManager::setLogPattern 相同.
+    \return     格式有效返回 true, 否则保持原格式并返回 false.
+    \sa         pattern
+*/
+bool QCtmLogFileSink::setPattern(const QString& pattern)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    return m_impl->formatter.setPattern(pattern);
+}
+
+/*!
+    \brief      返回日志行格式.
+    \sa         setPattern
+*/
+QString QCtmLogFileSink::pattern() const
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    return m_impl->formatter.pattern();
+}
+
+/*!
+    \brief      设置文件大小上限 \a bytes, 超出后轮转, 0 表示不轮转, 默认为 0.
+    \sa         maxFileSize, setMaxBackupCount
+*/
+void QCtmLogFileSink::setMaxFileSize(qint64 bytes)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    m_impl->maxFileSize = std::max<qint64>(bytes, 0);
+}
+
+/*!
+    \brief      返回文件大小上限.
+    \sa         setMaxFileSize
+*/
+qint64 QCtmLogFileSink::maxFileSize() const
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    return m_impl->maxFileSize;
+}
+
+/*!
+    \brief      设置轮转时保留的备份文件数量 \a count, 默认为 5.
+    \sa         maxBackupCount, setMaxFileSize
+*/
+void QCtmLogFileSink::setMaxBackupCount(int count)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    m_impl->maxBackupCount = std::max(count, 0);
+}
+
+/*!
+    \brief      返回轮转时保留的备份文件数量.
+    \sa         setMaxBackupCount
+*/
+int QCtmLogFileSink::maxBackupCount() const
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    return m_impl->maxBackupCount;
+}
+
+/*!
+    \reimp
+*/
+void QCtmLogFileSink::write(const QVector<QCtmLogDataPtr>& logs)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    if (!m_impl->open())
+    {
+        addDroppedCount(logs.size());
+        return;
+    }
+    for (int i = 0; i < logs.size(); i++)
+    {
+        const auto before = m_impl->buffer.size();
+        m_impl->formatter.format(*logs[i], m_impl->buffer);
+        m_impl->fileSize += m_impl->buffer.size() - before;
+        if (m_impl->maxFileSize > 0 && m_impl->fileSize >= m_impl->maxFileSize)
+        {
+            m_impl->file.write(m_impl->buffer);
+            m_impl->buffer.resize(0);
+            m_impl->rotate();
+            if (!m_impl->open())
+            {
+                addDroppedCount(logs.size() - i - 1); // 轮转后无法打开新文件, 本批剩余的日志丢弃
+                return;
+            }
+        }
+    }
+    m_impl->file.write(m_impl->buffer);
+    m_impl->buffer.resize(0);
+}
+
+/*!
+    \reimp
+*/
+void QCtmLogFileSink::flush()
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    if (m_impl->file.isOpen())
+        m_impl->file.flush();
+}
+
+/*!
+    \reimp
+*/
+void QCtmLogFileSink::close()
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    m_impl->file.close();
+}
@@ -18,34 +18,181 @@
 **********************************************************************************/
 
 #include "QCtmLogManager.h"
+#include "Private/QCtmLogArchiver_p.h"
+#include "Private/QCtmLogFormatter_p.h"
+#include "Private/QCtmLogQueue_p.h"
+#include "Private/QCtmLogSinkWorker_p.h"
+#include "Private/QCtmLogThrottle_p.h"
 #include "QCtmAbstractLogModel.h"
+#include "QCtmAbstractLogSink.h"
 #include "QCtmLogData.h"
 
+#include <QCoreApplication>
 #include <QDateTime>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
+#include <QHash>
 #include <QMutex>
 #include <QMutexLocker>
-#include <QRegularExpression>
+#include <QReadWriteLock>
 #include <QThread>
+#include <QWaitCondition>
 
-Q_CONSTEXPR int OneDay         = 60 * 60 * 24;
-Q_CONSTEXPR const char* objExp = "#\\w+\\b";
+#include <algorithm>
+#include <atomic>
+#include <functional>
+
+#ifdef Q_OS_UNIX
+#include <csignal>
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+Q_CONSTEXPR int OneDay             = 60 * 60 * 24;
+Q_CONSTEXPR int AsyncBatchSize     = 256;
+Q_CONSTEXPR int EmergencyWaitMsecs = 2000;
 
 void qtMessageHandle(QtMsgType type, const QMessageLogContext& context, const QString& msg);
 
 struct QCtmLogManager::Impl
 {
+    // 异步模式下队列中的日志记录, 上下文在生产线程中驻留, 只保存编号
+    struct Record
+    {
+        QtMsgType type { QtMsgType::QtDebugMsg };
+        quint32 location { 0 };
+        QString msg;
+        qint64 msecs { 0 };
+        quint32 repeat { 1 };
+    };
+
     QString logPath;
     LogSavePolicy policy { Size };
     QVector<QCtmAbstractLogModel*> models;
+    QHash<QString, QVector<QCtmAbstractLogModel*>> modelIndex;
+    QReadWriteLock modelLock;
+    std::atomic<bool> hasModels { false };
+    std::vector<std::unique_ptr<QCtmLogSinkWorker>> sinks;
+    QReadWriteLock sinkLock;
+    std::atomic<bool> hasSinks { false };
     bool saveLogs[QtMsgType::QtInfoMsg + 1];
     QDateTime datetime;
     qint64 logSize { 4 * 1024 * 1024 };
     QFile logFile;
     QMutex mutex;
+    QCtmLogArchiver archiver;
+
+    QCtmLogFormatter formatter;
+    QByteArray writeBuffer;
+    qint64 fileSize { 0 };
+    std::atomic<qint64> flushThreshold { 64 * 1024 };
+    std::atomic_int flushInterval { 1000 };
+    QElapsedTimer lastFlush;
+
+    std::atomic_bool async { false };
+    int asyncCapacity { 8192 };
+    std::atomic<AsyncOverflowPolicy> overflowPolicy { Block };
+    std::unique_ptr<QCtmLogQueue<Record>> queue;
+    QThread* writer { nullptr };
+    std::atomic_bool running { false };
+    std::atomic_int producers { 0 }; // 已通过 async 检查、正在写入队列的线程数
+    std::atomic_bool writerWaiting { false };
+    QMutex wakeMutex;
+    QWaitCondition wakeCondition;
+    QWaitCondition flushedCondition;
+    std::atomic<quint64> flushRequested { 0 }; // flush() 请求写线程刷新的序号
+    std::atomic<quint64> flushServed { 0 };
+    std::atomic<quint64> dropped[QtMsgType::QtInfoMsg + 1] {};
+
+    // 运行指标, 写文件相关的计数在 mutex 内更新, 读取时不加锁
+    std::atomic<quint64> acceptedCount[QtMsgType::QtInfoMsg + 1] {};
+    std::atomic<int> queueHighWater { 0 };
+    std::atomic<quint64> bytesWritten { 0 };
+    std::atomic<quint64> flushCount { 0 };
+    std::atomic<quint64> rotationCount { 0 };
+    std::atomic<qint64> writeNsecs { 0 };
+    std::atomic<qint64> maxWriteNsecs { 0 };
+    bool fileOpened { false };
+
+    // 崩溃时信号处理函数只读取以下原子量, 直接写入文件描述符
+    inline static std::atomic<int> fileHandle { -1 };
+    inline static std::atomic<const char*> pendingData { nullptr };
+    inline static std::atomic<int> pendingSize { 0 };
+    bool crashHandler { false };
+    QCtmLogThrottle throttle;
+
+    // 等级开关快照, 每一位对应一个 QtMsgType, 修改时发布新的快照, 旧快照不释放以保证无锁读取
+    struct Gate
+    {
+        quint8 types { 0x1f };
+        QHash<QByteArray, quint8> categories; // 单独设置的分类
+    };
+    Gate initialGate;
+    std::atomic<const Gate*> gate { &initialGate };
+    std::vector<std::unique_ptr<Gate>> gates;
+    QMutex gateMutex;
 
     inline static decltype(&qtMessageHandle) oldHandle;
+
+    QCtmLogDataPtr deliver(QtMsgType type, quint32 location, const QString& msg, qint64 msecs, quint32 repeat);
+    void dispatch(QtMsgType type, quint32 location, const QString& msg, qint64 msecs, quint32 repeat);
+    bool enqueue(Record&& record);
+    void emitSummaries(std::vector<QCtmLogThrottle::Summary>& summaries);
+    void collectRepeats(bool all);
+    void updateGate(const std::function<void(Gate&)>& change);
+
+    static inline bool accepted(const Gate& gate, QtMsgType type, const char* category)
+    {
+        if (!(gate.types & (1u << type)))
+            return false;
+        if (gate.categories.isEmpty() || !category)
+            return true;
+        auto it = gate.categories.constFind(QByteArray::fromRawData(category, static_cast<int>(qstrlen(category))));
+        return it == gate.categories.constEnd() || (*it & (1u << type));
+    }
+
+    void wakeWriter();
+    void writerLoop();
+    void serveFlush();
+    void waitForWriter();
+    void processBatch(QVector<Record>& records);
+    void drain();
+    void emergencyDrain();
+    void startWriter();
+    void stopWriter();
+    void rebuildModelIndex();
+    bool openFile(const QString& fileName);
+    void closeFile();
+    void publishPending();
+    void retractPending();
+    void stopSinks(unsigned long msecs);
+    void scheduleArchive();
+    void flushBuffer();
+    void flushIfDue();
+    static void shutdown();
+#ifdef Q_OS_UNIX
+    static void crashSignalHandler(int sig);
+    static void installCrashHandler(bool install);
+#endif
+
+    // 日志等级由低到高: Debug < Info < Warning < Critical < Fatal
+    static inline int severity(QtMsgType type)
+    {
+        switch (type)
+        {
+        case QtMsgType::QtDebugMsg:
+            return 0;
+        case QtMsgType::QtInfoMsg:
+            return 1;
+        case QtMsgType::QtWarningMsg:
+            return 2;
+        case QtMsgType::QtCriticalMsg:
+            return 3;
+        default:
+            return 4;
+        }
+    }
 };
 
 /*!
@@ -65,6 +212,17 @@ struct QCtmLogManager::Impl
                 按大小保存.
 */
 
+/*!
+    \enum       QCtmLogManager::AsyncOverflowPolicy
+                异步模式下队列已满时的处理策略.
+    \value      Block
+                阻塞生产线程直到队列有空位, 不丢失日志.
+    \value      DropLowestLevel
+                优先丢弃低等级日志, 队列占用越高, 能进入队列的最低日志等级越高.
+    \value      DropNewest
+                丢弃新到达的日志.
+*/
+
 /*!
     \brief      在 qApp 初始化之前调用该函数重定向日志句柄，如果在初始化之后调用则无法获取日志.
 */
@@ -155,31 +313,1068 @@ qint64 QCtmLogManager::logSizeLimit() const
     return m_impl->logSize;
 }
 
+/*!
+    \brief      设置是否启用异步日志 \a enable.
+                启用后日志线程只将日志放入无锁队列并立即返回, 由独立的写入线程批量分发到 model 并写入文件.
+    \sa         asyncEnabled, setAsyncOverflowPolicy
+*/
+void QCtmLogManager::setAsyncEnabled(bool enable)
+{
+    if (enable == m_impl->async.load())
+        return;
+    if (enable)
+        m_impl->startWriter();
+    else
+        m_impl->stopWriter();
+}
+
+/*!
+    \brief      返回是否启用异步日志.
+    \sa         setAsyncEnabled
+*/
+bool QCtmLogManager::asyncEnabled() const
+{
+    return m_impl->async.load();
+}
+
+/*!
+    \brief      设置是否压缩轮转后的日志文件 \a enable, 默认关闭.
+                压缩日志目录中按日志文件命名规则命名的已关闭文件 (包括之前运行时留下的文件), 目录中的其他文件不受影响. 压缩在低优先级的后台线程中进行,
+                压缩后的文件扩展名为 .log.qz, 可以使用 extractLogArchive 解压, 也可以直接由 QCtmLogFileModel 打开.
+    \sa         logCompressionEnabled, extractLogArchive
+*/
+void QCtmLogManager::setLogCompressionEnabled(bool enable)
+{
+    m_impl->archiver.setCompressionEnabled(enable);
+    m_impl->scheduleArchive();
+}
+
+/*!
+    \brief      返回是否压缩轮转后的日志文件.
+    \sa         setLogCompressionEnabled
+*/
+bool QCtmLogManager::logCompressionEnabled() const
+{
+    return m_impl->archiver.compressionEnabled();
+}
+
+/*!
+    \brief      设置最多保留的日志文件数量 \a count, 包含当前写入的文件, 0 表示不限制.
+                超出时由后台线程删除日志目录中按日志文件命名规则命名的最旧的文件 (包括之前运行时留下的文件), 目录中的其他文件不会被删除.
+    \sa         logRetentionCount, setLogRetentionSize, setLogRetentionDays
+*/
+void QCtmLogManager::setLogRetentionCount(int count)
+{
+    auto retention     = m_impl->archiver.retention();
+    retention.maxFiles = std::max(count, 0);
+    m_impl->archiver.setRetention(retention);
+    m_impl->scheduleArchive();
+}
+
+/*!
+    \brief      返回日志目录中最多保留的文件数量.
+    \sa         setLogRetentionCount
+*/
+int QCtmLogManager::logRetentionCount() const
+{
+    return m_impl->archiver.retention().maxFiles;
+}
+
+/*!
+    \brief      设置日志文件的最大总大小 \a bytes, 包含当前写入的文件, 0 表示不限制.
+                超出时由后台线程删除日志目录中按日志文件命名规则命名的最旧的文件 (包括之前运行时留下的文件), 目录中的其他文件不会被删除.
+    \sa         logRetentionSize, setLogRetentionCount, setLogRetentionDays
+*/
+void QCtmLogManager::setLogRetentionSize(qint64 bytes)
+{
+    auto retention     = m_impl->archiver.retention();
+    retention.maxBytes = std::max<qint64>(bytes, 0);
+    m_impl->archiver.setRetention(retention);
+    m_impl->scheduleArchive();
+}
+
+/*!
+    \brief      返回日志目录中文件的最大总大小.
+    \sa         setLogRetentionSize
+*/
+qint64 QCtmLogManager::logRetentionSize() const
+{
+    return m_impl->archiver.retention().maxBytes;
+}
+
+/*!
+    \brief      设置日志文件的最长保留天数 \a days, 0 表示不限制.
+                按修改时间删除日志目录中按日志文件命名规则命名的过期文件, 当前写入的文件与目录中的其他文件不会被删除.
+    \sa         logRetentionDays, setLogRetentionCount, setLogRetentionSize
+*/
+void QCtmLogManager::setLogRetentionDays(int days)
+{
+    auto retention    = m_impl->archiver.retention();
+    retention.maxDays = std::max(days, 0);
+    m_impl->archiver.setRetention(retention);
+    m_impl->scheduleArchive();
+}
+
+/*!
+    \brief      返回日志文件的最长保留天数.
+    \sa         setLogRetentionDays
+*/
+int QCtmLogManager::logRetentionDays() const
+{
+    return m_impl->archiver.retention().maxDays;
+}
+
+/*!
+    \brief      将压缩的日志文件 \a archive 解压到 \a fileName.
+    \return     成功返回 true.
+    \sa         setLogCompressionEnabled
+*/
+bool QCtmLogManager::extractLogArchive(const QString& archive, const QString& fileName)
+{
+    return QCtmLogArchiver::decompressFile(archive, fileName);
+}
+
+/*!
+    \brief      设置异步队列容量 \a capacity, 实际容量向上取整为2的幂, 在下次启用异步日志时生效.
+    \sa         asyncQueueCapacity
+*/
+void QCtmLogManager::setAsyncQueueCapacity(int capacity)
+{
+    m_impl->asyncCapacity = std::max(capacity, 2);
+}
+
+/*!
+    \brief      返回异步队列容量.
+    \sa         setAsyncQueueCapacity
+*/
+int QCtmLogManager::asyncQueueCapacity() const
+{
+    return m_impl->asyncCapacity;
+}
+
+/*!
+    \brief      设置异步队列已满时的处理策略 \a policy.
+    \sa         asyncOverflowPolicy
+*/
+void QCtmLogManager::setAsyncOverflowPolicy(AsyncOverflowPolicy policy)
+{
+    m_impl->overflowPolicy = policy;
+}
+
+/*!
+    \brief      返回异步队列已满时的处理策略.
+    \sa         setAsyncOverflowPolicy
+*/
+QCtmLogManager::AsyncOverflowPolicy QCtmLogManager::asyncOverflowPolicy() const
+{
+    return m_impl->overflowPolicy;
+}
+
+/*!
+    \brief      返回异步队列中等待写入的日志数量.
+*/
+int QCtmLogManager::asyncQueueDepth() const
+{
+    return m_impl->queue ? static_cast<int>(m_impl->queue->size()) : 0;
+}
+
+/*!
+    \brief      返回类型为 \a type 的日志因队列已满被丢弃的数量.
+    \sa         asyncOverflowPolicy
+*/
+quint64 QCtmLogManager::droppedCount(QtMsgType type) const
+{
+    return m_impl->dropped[type].load(std::memory_order_relaxed);
+}
+
+/*!
+    \overload
+                返回因队列已满被丢弃的日志总数.
+*/
+quint64 QCtmLogManager::droppedCount() const
+{
+    quint64 count = 0;
+    for (const auto& dropped : m_impl->dropped)
+        count += dropped.load(std::memory_order_relaxed);
+    return count;
+}
+
+/*!
+    \brief      设置是否处理 \a type 类型的日志 \a enable, 默认全部处理.
+                关闭的类型在消息处理函数的入口直接返回, 不写入文件、不投递到 model, 也不转发给之前的消息处理函数.
+                开关以快照的形式发布, 读取时不加锁. Fatal 日志总是处理.
+    \sa         messageTypeEnabled, setCategoryEnabled, setLogTypeEnable
+*/
+void QCtmLogManager::setMessageTypeEnabled(QtMsgType type, bool enable)
+{
+    m_impl->updateGate(
+        [=](Impl::Gate& gate)
+        {
+            if (enable)
+                gate.types |= 1u << type;
+            else
+                gate.types &= ~(1u << type);
+        });
+}
+
+/*!
+    \brief      返回是否处理 \a type 类型的日志.
+    \sa         setMessageTypeEnabled
+*/
+bool QCtmLogManager::messageTypeEnabled(QtMsgType type) const
+{
+    return m_impl->gate.load(std::memory_order_acquire)->types & (1u << type);
+}
+
+/*!
+    \brief      设置是否处理分类 \a category 中 \a type 类型的日志 \a enable, 在 setMessageTypeEnabled 的基础上进一步筛选.
+                分类即 QLoggingCategory 的名称, qDebug 等未指定分类的日志属于 "default" 分类.
+    \sa         categoryEnabled, setMessageTypeEnabled
+*/
+void QCtmLogManager::setCategoryEnabled(const QString& category, QtMsgType type, bool enable)
+{
+    m_impl->updateGate(
+        [&](Impl::Gate& gate)
+        {
+            auto it = gate.categories.find(category.toUtf8());
+            if (it == gate.categories.end())
+                it = gate.categories.insert(category.toUtf8(), 0x1f);
+            if (enable)
+                *it |= 1u << type;
+            else
+                *it &= ~(1u << type);
+        });
+}
+
+/*!
+    \brief      返回是否处理分类 \a category 中 \a type 类型的日志.
+    \sa         setCategoryEnabled
+*/
+bool QCtmLogManager::categoryEnabled(const QString& category, QtMsgType type) const
+{
+    const auto name = category.toUtf8();
+    return Impl::accepted(*m_impl->gate.load(std::memory_order_acquire), type, name.constData());
+}
+
+/*!
+    \brief      设置日志去重的时间窗口 \a msec, 0 表示不去重, 默认为 0.
+                窗口内等级、位置与内容均相同的日志只记录第一条, 窗口结束后记录一条带重复次数的摘要,
+                摘要在 QCtmLogModel 中显示为 "×次数", 在日志文件中由格式字段 {repeat} 输出.
+    \sa         deduplicationWindow, suppressedCount, setRateLimit
+*/
+void QCtmLogManager::setDeduplicationWindow(int msec)
+{
+    m_impl->throttle.setWindow(msec);
+}
+
+/*!
+    \brief      返回日志去重的时间窗口.
+    \sa         setDeduplicationWindow
+*/
+int QCtmLogManager::deduplicationWindow() const
+{
+    return m_impl->throttle.window();
+}
+
+/*!
+    \brief      设置每个日志位置 (文件与行号) 每秒最多记录的日志数量 \a perSecond, 0 表示不限制, 默认为 0.
+                超出的日志被丢弃并计入 rateLimitedCount, Fatal 日志不受限制.
+    \sa         rateLimit, setRateLimitBurst, rateLimitedCount
+*/
+void QCtmLogManager::setRateLimit(int perSecond)
+{
+    m_impl->throttle.setRate(perSecond);
+}
+
+/*!
+    \brief      返回每个日志位置每秒最多记录的日志数量.
+    \sa         setRateLimit
+*/
+int QCtmLogManager::rateLimit() const
+{
+    return m_impl->throttle.rate();
+}
+
+/*!
+    \brief      设置限流允许的突发数量 \a count, 即令牌桶的容量, 最小为 1.
+    \sa         rateLimitBurst, setRateLimit
+*/
+void QCtmLogManager::setRateLimitBurst(int count)
+{
+    m_impl->throttle.setBurst(count);
+}
+
+/*!
+    \brief      返回限流允许的突发数量.
+    \sa         setRateLimitBurst
+*/
+int QCtmLogManager::rateLimitBurst() const
+{
+    return m_impl->throttle.burst();
+}
+
+/*!
+    \brief      返回因去重被合并的日志总数.
+    \sa         setDeduplicationWindow
+*/
+quint64 QCtmLogManager::suppressedCount() const
+{
+    return m_impl->throttle.suppressedCount();
+}
+
+/*!
+    \brief      返回因限流被丢弃的日志总数.
+    \sa         setRateLimit
+*/
+quint64 QCtmLogManager::rateLimitedCount() const
+{
+    return m_impl->throttle.rateLimitedCount();
+}
+
 void qtMessageHandle(QtMsgType type, const QMessageLogContext& context, const QString& msg)
+{
+    auto& impl = *QCtmLogManager::instance().m_impl;
+    if (!QCtmLogManager::Impl::accepted(*impl.gate.load(std::memory_order_acquire), type, context.category))
+        return; // 关闭的日志不做任何处理
+    const bool throttled = impl.throttle.enabled();
+    quint32 location     = 0;
+    qint64 msecs         = 0;
+    if (throttled)
+    {
+        // 限流先于只转发的快速路径, 没有接收者时同样生效
+        location = QCtmLogData::internLocation(context);
+        msecs    = QDateTime::currentMSecsSinceEpoch();
+        std::vector<QCtmLogThrottle::Summary> summaries;
+        const bool admitted = impl.throttle.admit(type, location, msg, msecs, summaries);
+        impl.emitSummaries(summaries);
+        if (impl.throttle.collectDue(msecs))
+            impl.collectRepeats(false);
+        if (!admitted)
+            return;
+    }
+    if (!impl.saveLogs[type] && !impl.hasModels.load(std::memory_order_relaxed) && !impl.hasSinks.load(std::memory_order_relaxed) &&
+        type != QtMsgType::QtFatalMsg)
+    {
+        // 既不写入文件也没有 model 与输出目标接收, 只转发给之前的消息处理函数
+        if (!impl.oldHandle)
+            return;
+        if (msg.contains(QLatin1Char('#')))
+        {
+            QString message = msg;
+            QCtmLogManager::parseObjectNames(message);
+            impl.oldHandle(type, context, message);
+        }
+        else
+            impl.oldHandle(type, context, msg);
+        impl.acceptedCount[type].fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (!throttled)
+    {
+        location = QCtmLogData::internLocation(context);
+        msecs    = QDateTime::currentMSecsSinceEpoch();
+    }
+    impl.acceptedCount[type].fetch_add(1, std::memory_order_relaxed);
+    impl.dispatch(type, location, msg, msecs, 1);
+}
+
+QCtmLogDataPtr QCtmLogManager::Impl::deliver(QtMsgType type, quint32 location, const QString& msg, qint64 msecs, quint32 repeat)
 {
     QString message    = msg;
     const auto objList = QCtmLogManager::parseObjectNames(message);
-    auto data          = std::make_shared<QCtmLogData>(type, context, message);
+    auto data          = QCtmLogData::create(type, location, message, msecs);
+    if (repeat > 1)
+        data->setRepeatCount(repeat);
 
-    for (auto model : QCtmLogManager::instance().m_impl->models)
+    if (!objList.isEmpty())
     {
-        if (objList.contains(model->objectName()))
+        QReadLocker locker(&modelLock);
+        for (auto it = objList.begin(); it != objList.end(); ++it)
         {
-            QMetaObject::invokeMethod(model, "onLog", Q_ARG(QCtmLogDataPtr, data));
+            if (std::find(objList.begin(), it, *it) != it) // 重复的标签只投递一次
+                continue;
+            auto models = modelIndex.constFind(*it);
+            if (models == modelIndex.constEnd())
+                continue;
+            for (auto model : *models)
+            {
+                model->post(data);
+            }
         }
     }
 
-    QCtmLogManager::Impl::oldHandle(type, context, message);
+    if (hasSinks.load(std::memory_order_relaxed))
+    {
+        QReadLocker locker(&sinkLock);
+        for (const auto& sink : sinks)
+        {
+            sink->post(data);
+        }
+    }
+
+    oldHandle(type, data->context(), message);
+    return data;
+}
+
+void QCtmLogManager::Impl::dispatch(QtMsgType type, quint32 location, const QString& msg, qint64 msecs, quint32 repeat)
+{
+    if (async.load(std::memory_order_acquire) && type != QtMsgType::QtFatalMsg && QThread::currentThread() != writer)
+    {
+        // 先登记再确认 async, stopWriter 关闭 async 后等待登记的线程全部离开, 之后的日志都同步处理
+        producers.fetch_add(1);
+        const bool queued = async.load() && enqueue({ type, location, msg, msecs, repeat });
+        producers.fetch_sub(1, std::memory_order_release);
+        if (queued)
+            return;
+    }
+    if (type == QtMsgType::QtFatalMsg)
+        emergencyDrain();
 
+    auto data = deliver(type, location, msg, msecs, repeat);
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    QMutexLocker locker(&QCtmLogManager::instance().m_impl->mutex);
+    QMutexLocker locker(&mutex);
 #else
-    QMutexLocker<QMutex> locker(&QCtmLogManager::instance().m_impl->mutex);
+    QMutexLocker<QMutex> locker(&mutex);
 #endif
-    if (QCtmLogManager::instance().m_impl->saveLogs[type])
+    if (saveLogs[type])
     {
         QCtmLogManager::instance().writeLog(data);
     }
+    if (type == QtMsgType::QtFatalMsg)
+    {
+        flushBuffer(); // 进程即将终止, 写出缓冲区中的全部日志
+        stopSinks(EmergencyWaitMsecs);
+    }
+}
+
+void QCtmLogManager::Impl::emitSummaries(std::vector<QCtmLogThrottle::Summary>& summaries)
+{
+    for (auto& summary : summaries)
+    {
+        dispatch(summary.type, summary.location, summary.msg, summary.msecs, summary.repeat);
+    }
+    summaries.clear();
+}
+
+void QCtmLogManager::Impl::updateGate(const std::function<void(Gate&)>& change)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&gateMutex);
+#else
+    QMutexLocker<QMutex> locker(&gateMutex);
+#endif
+    auto next = std::make_unique<Gate>(*gate.load(std::memory_order_relaxed));
+    change(*next);
+    // Fatal 日志总是记录
+    next->types |= 1u << QtMsgType::QtFatalMsg;
+    for (auto& mask : next->categories)
+    {
+        mask |= 1u << QtMsgType::QtFatalMsg;
+    }
+    gate.store(next.get(), std::memory_order_release);
+    gates.push_back(std::move(next));
+}
+
+void QCtmLogManager::Impl::collectRepeats(bool all)
+{
+    std::vector<QCtmLogThrottle::Summary> summaries;
+    throttle.collect(QDateTime::currentMSecsSinceEpoch(), summaries, all);
+    emitSummaries(summaries);
+}
+
+// 返回 false 表示异步已关闭, 日志未入队, 由调用方同步处理
+bool QCtmLogManager::Impl::enqueue(Record&& record)
+{
+    const auto type   = record.type;
+    const auto policy = overflowPolicy.load(std::memory_order_relaxed);
+    if (policy == DropLowestLevel)
+    {
+        // 按等级分配可用的队列比例: Debug 1/2, Info 5/8, Warning 3/4, Critical 全部
+        const auto level = severity(type);
+        const auto limit = level >= 3 ? queue->capacity() : queue->capacity() * (4 + level) / 8;
+        if (queue->size() >= limit)
+        {
+            dropped[type].fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    while (!queue->tryPush(std::move(record)))
+    {
+        if (policy != Block)
+        {
+            dropped[type].fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        if (!async.load(std::memory_order_acquire))
+            return false; // 写线程即将停止, 不再等待队列空位
+        wakeWriter();
+        QThread::yieldCurrentThread();
+    }
+    const auto depth = static_cast<int>(queue->size());
+    auto high        = queueHighWater.load(std::memory_order_relaxed);
+    while (depth > high && !queueHighWater.compare_exchange_weak(high, depth, std::memory_order_relaxed))
+        ;
+    wakeWriter();
+    return true;
+}
+
+void QCtmLogManager::Impl::wakeWriter()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (writerWaiting.load(std::memory_order_relaxed))
+    {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        QMutexLocker locker(&wakeMutex);
+#else
+        QMutexLocker<QMutex> locker(&wakeMutex);
+#endif
+        wakeCondition.wakeOne();
+    }
+}
+
+void QCtmLogManager::Impl::writerLoop()
+{
+    QVector<Record> records;
+    records.reserve(AsyncBatchSize);
+    Record record;
+    for (;;)
+    {
+        while (records.size() < AsyncBatchSize && queue->tryPop(record))
+            records.push_back(std::move(record));
+        if (!records.isEmpty())
+        {
+            processBatch(records);
+            continue;
+        }
+        serveFlush(); // 队列已空, 响应 flush() 的请求
+        if (!running.load(std::memory_order_acquire))
+            break;
+
+        {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+            QMutexLocker locker(&wakeMutex);
+#else
+            QMutexLocker<QMutex> locker(&wakeMutex);
+#endif
+            writerWaiting.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (queue->empty() && running.load(std::memory_order_acquire) && flushServed.load() == flushRequested.load())
+                wakeCondition.wait(&wakeMutex, static_cast<unsigned long>(std::max(flushInterval.load(), 1)));
+            writerWaiting.store(false, std::memory_order_relaxed);
+        }
+        flushIfDue(); // 空闲时也按时间间隔刷新缓冲区
+        if (throttle.enabled() && throttle.collectDue(QDateTime::currentMSecsSinceEpoch()))
+            collectRepeats(false); // 输出已结束窗口的重复摘要
+    }
+}
+
+void QCtmLogManager::Impl::serveFlush()
+{
+    const auto requested = flushRequested.load();
+    if (flushServed.load() == requested)
+        return;
+    {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        QMutexLocker locker(&mutex);
+#else
+        QMutexLocker<QMutex> locker(&mutex);
+#endif
+        flushBuffer();
+    }
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&wakeMutex);
+#else
+    QMutexLocker<QMutex> locker(&wakeMutex);
+#endif
+    flushServed.store(requested);
+    flushedCondition.wakeAll();
+}
+
+// 唤醒写线程并等待其处理完队列中的日志并刷新缓冲区, 写线程停止后不再等待
+void QCtmLogManager::Impl::waitForWriter()
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&wakeMutex);
+#else
+    QMutexLocker<QMutex> locker(&wakeMutex);
+#endif
+    const auto ticket = ++flushRequested;
+    wakeCondition.wakeOne();
+    while (flushServed.load() < ticket && running.load(std::memory_order_acquire))
+        flushedCondition.wait(&wakeMutex, static_cast<unsigned long>(std::max(flushInterval.load(), 1)));
+}
+
+void QCtmLogManager::Impl::processBatch(QVector<Record>& records)
+{
+    QVector<QCtmLogDataPtr> datas;
+    datas.reserve(records.size());
+    for (const auto& record : records)
+    {
+        datas.push_back(deliver(record.type, record.location, record.msg, record.msecs, record.repeat));
+    }
+    records.clear();
+
+    // 整批日志只加锁一次
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&mutex);
+#else
+    QMutexLocker<QMutex> locker(&mutex);
+#endif
+    for (const auto& data : datas)
+    {
+        if (saveLogs[data->type()])
+            QCtmLogManager::instance().writeLog(data);
+    }
+}
+
+void QCtmLogManager::Impl::drain()
+{
+    if (!queue)
+        return;
+    QVector<Record> records;
+    Record record;
+    while (queue->tryPop(record))
+        records.push_back(std::move(record));
+    if (!records.isEmpty())
+        processBatch(records);
+}
+
+// Fatal 日志之后进程即将终止: 让写线程处理完手中的批次与队列后退出, 写线程阻塞超时后由当前线程同步写出剩余的日志
+void QCtmLogManager::Impl::emergencyDrain()
+{
+    async.store(false, std::memory_order_release);
+    if (writer && QThread::currentThread() != writer)
+    {
+        running.store(false, std::memory_order_release);
+        {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+            QMutexLocker locker(&wakeMutex);
+#else
+            QMutexLocker<QMutex> locker(&wakeMutex);
+#endif
+            wakeCondition.wakeOne();
+        }
+        writer->wait(EmergencyWaitMsecs);
+    }
+    drain();
+}
+
+void QCtmLogManager::Impl::startWriter()
+{
+    if (!queue || queue->capacity() < static_cast<size_t>(asyncCapacity))
+    {
+        drain(); // 替换前写出旧队列中残留的日志
+        queue = std::make_unique<QCtmLogQueue<Record>>(asyncCapacity);
+    }
+    running = true;
+    writer  = QThread::create([this] { writerLoop(); });
+    writer->setObjectName("QCtmLogWriter");
+    writer->start(QThread::LowPriority);
+    async.store(true, std::memory_order_release);
+}
+
+void QCtmLogManager::Impl::stopWriter()
+{
+    async.store(false);
+    if (!writer)
+        return;
+    // 等待已通过 async 检查的线程完成入队, 写线程仍在运行, 阻塞策略下的线程可以得到空位
+    while (producers.load() != 0)
+        QThread::yieldCurrentThread();
+    running.store(false, std::memory_order_release);
+    {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        QMutexLocker locker(&wakeMutex);
+#else
+        QMutexLocker<QMutex> locker(&wakeMutex);
+#endif
+        wakeCondition.wakeOne();
+    }
+    writer->wait();
+    delete writer;
+    writer = nullptr;
+    drain(); // 写线程退出前已处理完队列, 之后也不再有线程入队, 此处只作兜底
+}
+
+bool QCtmLogManager::Impl::openFile(const QString& fileName)
+{
+    logFile.setFileName(fileName);
+    if (!logFile.open(QFile::WriteOnly | QFile::Append | QFile::Unbuffered)) // 由 writeBuffer 缓冲
+        return false;
+    fileHandle.store(logFile.handle(), std::memory_order_release);
+    fileSize = logFile.size();
+    if (fileOpened)
+        rotationCount.fetch_add(1, std::memory_order_relaxed);
+    fileOpened = true;
+    archiver.schedule(fileName); // 压缩轮转出的文件并执行保留策略
+    return true;
+}
+
+void QCtmLogManager::Impl::stopSinks(unsigned long msecs)
+{
+    QReadLocker locker(&sinkLock);
+    for (const auto& sink : sinks)
+    {
+        sink->stop(msecs);
+    }
+}
+
+void QCtmLogManager::Impl::closeFile()
+{
+    flushBuffer();
+    fileHandle.store(-1, std::memory_order_release);
+    logFile.close();
+}
+
+// 发布已格式化但尚未写入文件的日志, 供崩溃时的信号处理函数写出
+void QCtmLogManager::Impl::publishPending()
+{
+    pendingData.store(writeBuffer.constData(), std::memory_order_relaxed);
+    pendingSize.store(static_cast<int>(writeBuffer.size()), std::memory_order_release);
+}
+
+// 撤回已发布的缓冲区, 在可能重新分配 writeBuffer 的追加或写出之前调用, 避免信号处理函数读取已释放的内存
+void QCtmLogManager::Impl::retractPending()
+{
+    pendingSize.store(0, std::memory_order_release);
+    pendingData.store(nullptr, std::memory_order_release);
+}
+
+void QCtmLogManager::Impl::scheduleArchive()
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&mutex);
+#else
+    QMutexLocker<QMutex> locker(&mutex);
+#endif
+    if (logFile.isOpen())
+        archiver.schedule(logFile.fileName());
+}
+
+void QCtmLogManager::Impl::flushBuffer()
+{
+    if (!writeBuffer.isEmpty() && logFile.isOpen())
+    {
+        QElapsedTimer timer;
+        timer.start();
+        const auto written = logFile.write(writeBuffer);
+        const auto nsecs   = timer.nsecsElapsed();
+        if (written > 0)
+            bytesWritten.fetch_add(static_cast<quint64>(written), std::memory_order_relaxed);
+        flushCount.fetch_add(1, std::memory_order_relaxed);
+        writeNsecs.fetch_add(nsecs, std::memory_order_relaxed);
+        if (nsecs > maxWriteNsecs.load(std::memory_order_relaxed))
+            maxWriteNsecs.store(nsecs, std::memory_order_relaxed);
+    }
+    writeBuffer.resize(0);
+    publishPending(); // 保留已分配的空间
+    lastFlush.restart();
+}
+
+void QCtmLogManager::Impl::flushIfDue()
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&mutex);
+#else
+    QMutexLocker<QMutex> locker(&mutex);
+#endif
+    if (!writeBuffer.isEmpty() && lastFlush.hasExpired(flushInterval.load(std::memory_order_relaxed)))
+        flushBuffer();
+}
+
+void QCtmLogManager::Impl::shutdown()
+{
+    auto& ins = QCtmLogManager::instance();
+    if (ins.m_impl->throttle.enabled())
+        ins.m_impl->collectRepeats(true);
+    ins.m_impl->stopWriter();
+    ins.flush();
+    ins.m_impl->stopSinks(ULONG_MAX);
+    ins.m_impl->archiver.stop();
+}
+
+#ifdef Q_OS_UNIX
+namespace
+{
+constexpr int CrashSignals[] = { SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL };
+struct sigaction previousActions[sizeof(CrashSignals) / sizeof(int)];
+
+// 只使用异步信号安全的调用
+void writeAll(int fd, const char* data, int size)
+{
+    while (size > 0)
+    {
+        const auto written = ::write(fd, data, static_cast<size_t>(size));
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        data += written;
+        size -= static_cast<int>(written);
+    }
+}
+} // namespace
+
+void QCtmLogManager::Impl::crashSignalHandler(int sig)
+{
+    const int fd = fileHandle.load(std::memory_order_acquire);
+    if (fd >= 0)
+    {
+        const int size   = pendingSize.exchange(0, std::memory_order_acq_rel);
+        const char* data = pendingData.load(std::memory_order_relaxed);
+        if (data && size > 0)
+            writeAll(fd, data, size);
+
+        // 在栈上的预分配缓冲区中拼接 "[crash] signal N\n"
+        char line[32]   = "[crash] signal ";
+        int len         = 15;
+        char digits[12] = {};
+        int count       = 0;
+        for (int n = sig; n > 0 && count < 11; n /= 10)
+            digits[count++] = static_cast<char>('0' + n % 10);
+        while (count > 0)
+            line[len++] = digits[--count];
+        line[len++] = '\n';
+        writeAll(fd, line, len);
+    }
+
+    // 恢复之前的处理函数并重新触发信号, 保留默认的 core dump 或其他崩溃处理程序
+    for (size_t i = 0; i < sizeof(CrashSignals) / sizeof(int); i++)
+    {
+        if (CrashSignals[i] == sig)
+            sigaction(sig, &previousActions[i], nullptr);
+    }
+    raise(sig);
+}
+
+void QCtmLogManager::Impl::installCrashHandler(bool install)
+{
+    for (size_t i = 0; i < sizeof(CrashSignals) / sizeof(int); i++)
+    {
+        if (install)
+        {
+            struct sigaction action = {};
+            action.sa_handler       = &Impl::crashSignalHandler;
+            sigemptyset(&action.sa_mask);
+            action.sa_flags = SA_RESETHAND;
+            sigaction(CrashSignals[i], &action, &previousActions[i]);
+        }
+        else
+            sigaction(CrashSignals[i], &previousActions[i], nullptr);
+    }
+}
+#endif
+
+/*!
+    \brief      设置日志缓冲区的刷新阈值 \a bytes, 缓冲的日志达到该大小时写入文件, 默认为 64KB.
+                Critical 与 Fatal 日志总是立即写入文件.
+    \sa         flushThreshold, setFlushInterval
+*/
+void QCtmLogManager::setFlushThreshold(qint64 bytes)
+{
+    m_impl->flushThreshold = std::max<qint64>(bytes, 0);
+}
+
+/*!
+    \brief      返回日志缓冲区的刷新阈值.
+    \sa         setFlushThreshold
+*/
+qint64 QCtmLogManager::flushThreshold() const
+{
+    return m_impl->flushThreshold;
+}
+
+/*!
+    \brief      设置日志缓冲区的最长刷新间隔 \a msec, 默认为 1000 毫秒.
+                异步模式下写入线程空闲时也会按该间隔刷新, 同步模式下在下一条日志写入时检查.
+    \sa         flushInterval, setFlushThreshold
+*/
+void QCtmLogManager::setFlushInterval(int msec)
+{
+    m_impl->flushInterval = std::max(msec, 0);
+}
+
+/*!
+    \brief      返回日志缓冲区的最长刷新间隔.
+    \sa         setFlushInterval
+*/
+int QCtmLogManager::flushInterval() const
+{
+    return m_impl->flushInterval;
+}
+
+/*!
+    \brief      立即将缓冲的日志写入文件. 异步模式下等待写线程处理完队列中已有的日志后返回.
+*/
+void QCtmLogManager::flush()
+{
+    if (m_impl->throttle.enabled())
+        m_impl->collectRepeats(false);
+    if (m_impl->async.load(std::memory_order_acquire) && m_impl->writer && QThread::currentThread() != m_impl->writer)
+        m_impl->waitForWriter();
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    m_impl->flushBuffer();
+}
+
+/*!
+    \brief      添加日志输出目标 \a sink, 输出目标在独立的线程中接收此后的所有日志, 与日志文件和 model 互不影响.
+    \sa         removeSink, sinks, QCtmLogFileSink, QCtmLogMemorySink, QCtmLogSocketSink
+*/
+void QCtmLogManager::addSink(QCtmLogSinkPtr sink)
+{
+    if (!sink)
+        return;
+    QWriteLocker locker(&m_impl->sinkLock);
+    for (const auto& worker : m_impl->sinks)
+    {
+        if (worker->sink() == sink)
+            return;
+    }
+    m_impl->sinks.push_back(std::make_unique<QCtmLogSinkWorker>(std::move(sink)));
+    m_impl->hasSinks.store(true, std::memory_order_relaxed);
+}
+
+/*!
+    \brief      移除日志输出目标 \a sink, 等待其写出已接收的日志后返回.
+    \sa         addSink
+*/
+void QCtmLogManager::removeSink(const QCtmLogSinkPtr& sink)
+{
+    std::unique_ptr<QCtmLogSinkWorker> worker;
+    {
+        QWriteLocker locker(&m_impl->sinkLock);
+        auto it = std::find_if(m_impl->sinks.begin(), m_impl->sinks.end(), [&](const auto& w) { return w->sink() == sink; });
+        if (it == m_impl->sinks.end())
+            return;
+        worker = std::move(*it);
+        m_impl->sinks.erase(it);
+        m_impl->hasSinks.store(!m_impl->sinks.empty(), std::memory_order_relaxed);
+    }
+    worker->stop();
+}
+
+/*!
+    \brief      返回所有日志输出目标.
+    \sa         addSink
+*/
+QVector<QCtmLogSinkPtr> QCtmLogManager::sinks() const
+{
+    QReadLocker locker(&m_impl->sinkLock);
+    QVector<QCtmLogSinkPtr> list;
+    for (const auto& worker : m_impl->sinks)
+    {
+        list.push_back(worker->sink());
+    }
+    return list;
+}
+
+/*!
+    \brief      设置是否在进程崩溃时写出缓冲区中的日志 \a enable, 默认关闭.
+                开启后为 SIGSEGV、SIGABRT、SIGBUS、SIGFPE 与 SIGILL 安装处理函数, 只使用异步信号安全的调用,
+                将已格式化但尚未写入的日志与崩溃信号直接写入当前日志文件, 然后交还给之前的处理函数.
+                异步队列中尚未格式化的日志无法在信号处理函数中安全写出; Fatal 日志不依赖此开关, 总是同步写出队列中的全部日志.
+                仅在 Unix 平台有效.
+    \sa         crashHandlerEnabled
+*/
+void QCtmLogManager::setCrashHandlerEnabled(bool enable)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    if (m_impl->crashHandler == enable)
+        return;
+    m_impl->crashHandler = enable;
+#ifdef Q_OS_UNIX
+    Impl::installCrashHandler(enable);
+#endif
+}
+
+/*!
+    \brief      返回是否在进程崩溃时写出缓冲区中的日志.
+    \sa         setCrashHandlerEnabled
+*/
+bool QCtmLogManager::crashHandlerEnabled() const
+{
+    return m_impl->crashHandler;
+}
+
+/*!
+    \brief      返回日志系统当前的运行指标快照, 所有计数自程序启动起累计, 读取时不阻塞日志写入.
+                快照包含各等级接收与丢弃的数量、异步队列深度与最高水位、写入文件的字节数、
+                写文件次数与耗时、轮转次数以及每个 model 尚未投递的日志数量和最早一条的延迟.
+    \sa         QCtmLogMetricsMonitor
+*/
+QCtmLogMetrics QCtmLogManager::metrics() const
+{
+    QCtmLogMetrics metrics;
+    metrics.timestamp = QDateTime::currentMSecsSinceEpoch();
+    for (int i = 0; i <= QtMsgType::QtInfoMsg; i++)
+    {
+        metrics.accepted[i] = m_impl->acceptedCount[i].load(std::memory_order_relaxed);
+        metrics.dropped[i]  = m_impl->dropped[i].load(std::memory_order_relaxed);
+    }
+    metrics.suppressed        = m_impl->throttle.suppressedCount();
+    metrics.rateLimited       = m_impl->throttle.rateLimitedCount();
+    metrics.queueDepth        = asyncQueueDepth();
+    metrics.queueHighWater    = m_impl->queueHighWater.load(std::memory_order_relaxed);
+    metrics.bytesWritten      = m_impl->bytesWritten.load(std::memory_order_relaxed);
+    metrics.flushCount        = m_impl->flushCount.load(std::memory_order_relaxed);
+    metrics.rotationCount     = m_impl->rotationCount.load(std::memory_order_relaxed);
+    metrics.averageWriteNsecs = metrics.flushCount ? m_impl->writeNsecs.load(std::memory_order_relaxed) / static_cast<qint64>(metrics.flushCount) : 0;
+    metrics.maxWriteNsecs     = m_impl->maxWriteNsecs.load(std::memory_order_relaxed);
+
+    QReadLocker locker(&m_impl->modelLock);
+    metrics.models.reserve(m_impl->models.size());
+    for (auto model : m_impl->models)
+    {
+        QCtmLogMetrics::ModelLag lag;
+        qint64 oldest  = 0;
+        lag.objectName = model->objectName();
+        lag.pending    = model->pendingCount(&oldest);
+        lag.lagMsecs   = lag.pending > 0 ? std::max<qint64>(0, metrics.timestamp - oldest) : 0;
+        metrics.models.push_back(lag);
+    }
+    return metrics;
+}
+
+/*!
+    \brief      设置日志文件的行格式 \a pattern, 格式在设置时解析一次, 写入时不再解析.
+                支持的字段: {time[:格式]} {level} {file} {line} {function} {category} {msg}, 使用 {{ 与 }} 输出花括号.
+                时间格式支持 %Y %y %m %d %H %M %S %e(毫秒) %F %T, 默认格式为
+                "[{time:%Y-%m-%d %H:%M:%S:%e}] [{level}] [{file}:{line}] {msg}", 日志文件以 UTF-8 编码写入.
+    \return     格式有效返回 true, 否则保持原格式并返回 false.
+    \sa         logPattern
+*/
+bool QCtmLogManager::setLogPattern(const QString& pattern)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    return m_impl->formatter.setPattern(pattern);
+}
+
+/*!
+    \brief      返回日志文件的行格式.
+    \sa         setLogPattern
+*/
+QString QCtmLogManager::logPattern() const
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    return m_impl->formatter.pattern();
 }
 
 /*!
@@ -198,6 +1393,9 @@ QCtmLogManager::QCtmLogManager() : m_impl(std::make_unique<Impl>())
     {
         m_impl->saveLogs[i] = true;
     }
+    m_impl->writeBuffer.reserve(m_impl->flushThreshold + 4096);
+    m_impl->lastFlush.start();
+    qAddPostRoutine(&Impl::shutdown);
 }
 
 /*!
@@ -205,6 +1403,13 @@ QCtmLogManager::QCtmLogManager() : m_impl(std::make_unique<Impl>())
 */
 QCtmLogManager::~QCtmLogManager()
 {
+#ifdef Q_OS_UNIX
+    if (m_impl->crashHandler)
+        Impl::installCrashHandler(false);
+#endif
+    m_impl->stopWriter();
+    flush();
+    Impl::fileHandle.store(-1, std::memory_order_release);
 }
 
 /*!
@@ -212,35 +1417,19 @@ QCtmLogManager::~QCtmLogManager()
 */
 void QCtmLogManager::writeLog(QCtmLogDataPtr data)
 {
-    QString level;
-    switch (data->type())
-    {
-    case QtMsgType::QtInfoMsg:
-        level = "Info";
-        break;
-    case QtMsgType::QtWarningMsg:
-        level = "Warn";
-        break;
-    case QtMsgType::QtCriticalMsg:
-        level = "Error";
-        break;
-    case QtMsgType::QtFatalMsg:
-        level = "Abort";
-        break;
-    case QtMsgType::QtDebugMsg:
-        level = "Debug";
-        break;
-    }
     if (checkFile())
     {
-        auto log = QString("[%1] [%4] [%2:%3] %5\n")
-                       .arg(data->dateTime().toString("yyyy-MM-dd hh:mm:ss:zzz"))
-                       .arg(data->context().file)
-                       .arg(data->context().line)
-                       .arg(level)
-                       .arg(data->msg());
-        m_impl->logFile.write(log.toLocal8Bit());
-        m_impl->logFile.flush();
+        const auto before = m_impl->writeBuffer.size();
+        m_impl->retractPending(); // format 可能使 writeBuffer 重新分配
+        m_impl->formatter.format(*data, m_impl->writeBuffer);
+        m_impl->fileSize += m_impl->writeBuffer.size() - before;
+        m_impl->publishPending();
+        if (data->type() == QtMsgType::QtCriticalMsg || data->type() == QtMsgType::QtFatalMsg ||
+            m_impl->writeBuffer.size() >= m_impl->flushThreshold.load(std::memory_order_relaxed) ||
+            m_impl->lastFlush.hasExpired(m_impl->flushInterval.load(std::memory_order_relaxed)))
+        {
+            m_impl->flushBuffer();
+        }
     }
     else
     {
@@ -254,7 +1443,19 @@ void QCtmLogManager::writeLog(QCtmLogDataPtr data)
 */
 void QCtmLogManager::registerModel(QCtmAbstractLogModel* model)
 {
-    m_impl->models.push_back(model);
+    {
+        QWriteLocker locker(&m_impl->modelLock);
+        m_impl->models.push_back(model);
+        m_impl->modelIndex[model->objectName()].push_back(model);
+        m_impl->hasModels.store(true, std::memory_order_relaxed);
+    }
+    QObject::connect(model,
+                     &QObject::objectNameChanged,
+                     model,
+                     [this]()
+                     {
+                         m_impl->rebuildModelIndex();
+                     });
 }
 
 /*!
@@ -263,33 +1464,70 @@ void QCtmLogManager::registerModel(QCtmAbstractLogModel* model)
 */
 void QCtmLogManager::unRegisterModel(QCtmAbstractLogModel* model)
 {
+    QWriteLocker locker(&m_impl->modelLock);
     m_impl->models.removeOne(model);
+    auto it = m_impl->modelIndex.find(model->objectName());
+    if (it != m_impl->modelIndex.end())
+    {
+        it->removeOne(model);
+        if (it->isEmpty())
+            m_impl->modelIndex.erase(it);
+    }
+    m_impl->hasModels.store(!m_impl->models.isEmpty(), std::memory_order_relaxed);
+}
+
+void QCtmLogManager::Impl::rebuildModelIndex()
+{
+    QWriteLocker locker(&modelLock);
+    modelIndex.clear();
+    for (auto model : models)
+    {
+        modelIndex[model->objectName()].push_back(model);
+    }
 }
 
 /*!
-    \brief      解析日志 \a msg.
+    \brief      解析日志 \a msg 中的 #对象名 标签, 将标签从 \a msg 中移除并返回对象名列表.
 */
 QList<QString> QCtmLogManager::parseObjectNames(QString& msg)
 {
-    QRegularExpression rx(objExp);
-    QRegularExpressionMatchIterator i = rx.globalMatch(msg);
-    QStringList list;
-
-    while (i.hasNext())
+    // 等价于正则 "#\w+\b", \w 为 ASCII 字母、数字及下划线
+    const auto isWordChar = [](QChar c)
     {
-        auto match      = i.next();
-        const auto& str = match.captured();
-        list << str.right(str.size() - 1);
-    }
+        const auto u = c.unicode();
+        return (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') || (u >= '0' && u <= '9') || u == '_';
+    };
 
-    if (!list.isEmpty())
+    QList<QString> list;
+    auto pos = msg.indexOf(QLatin1Char('#'));
+    if (pos < 0)
+        return list;
+
+    const auto size   = msg.size();
+    const auto* chars = msg.constData();
+    QString stripped;
+    decltype(pos) copied = 0;
+    while (pos >= 0)
     {
-        for (const auto& objName : list)
+        auto end = pos + 1;
+        while (end < size && isWordChar(chars[end]))
+            ++end;
+        if (end > pos + 1)
         {
-            msg.replace("#" + objName, "");
+            if (list.isEmpty())
+                stripped.reserve(size);
+            list << QString(chars + pos + 1, end - pos - 1);
+            stripped.append(chars + copied, pos - copied);
+            copied = end;
         }
+        pos = end < size ? msg.indexOf(QLatin1Char('#'), end) : -1;
     }
 
+    if (!list.isEmpty())
+    {
+        stripped.append(chars + copied, size - copied);
+        msg = std::move(stripped);
+    }
     return list;
 }
 
@@ -301,23 +1539,21 @@ bool QCtmLogManager::checkFile()
     switch (QCtmLogManager::instance().m_impl->policy)
     {
     case Date:
-        if (m_impl->datetime.daysTo(QDateTime::currentDateTime()) >= 1 || !m_impl->logFile.isOpen())
+        if (m_impl->datetime.date() != QDate::currentDate() || !m_impl->logFile.isOpen()) // 按自然日轮转
         {
             m_impl->datetime = QDateTime::currentDateTime();
             if (m_impl->logFile.isOpen())
-                m_impl->logFile.close();
-            m_impl->logFile.setFileName(m_impl->logPath + "/" + QDateTime::currentDateTime().toString("yyyy-MM-dd hh.mm.ss") + ".log");
-            return m_impl->logFile.open(QFile::WriteOnly | QFile::Append);
+                m_impl->closeFile();
+            return m_impl->openFile(m_impl->logPath + "/" + QDateTime::currentDateTime().toString("yyyy-MM-dd hh.mm.ss") + ".log");
         }
         break;
     case Size:
-        if (!m_impl->logFile.isOpen() || m_impl->logFile.size() >= m_impl->logSize)
+        if (!m_impl->logFile.isOpen() || m_impl->fileSize >= m_impl->logSize) // 文件大小由写入量累计, 不查询文件系统
         {
             if (m_impl->logFile.isOpen())
-                m_impl->logFile.close();
+                m_impl->closeFile();
             const auto& file = m_impl->logPath + "/" + QDateTime::currentDateTime().toString("yyyy-MM-dd hh.mm.ss.zzz") + ".log";
-            m_impl->logFile.setFileName(file);
-            return m_impl->logFile.open(QFile::WriteOnly | QFile::Append);
+            return m_impl->openFile(file);
         }
         break;
     }
@@ -21,12 +21,41 @@
 
 #include "qcustomui_global.h"
 
+#include <QMetaType>
 #include <QString>
+#include <QVector>
 
 #include <memory>
 
 class QCtmAbstractLogModel;
+class QCtmAbstractLogSink;
 using QCtmLogDataPtr = std::shared_ptr<class QCtmLogData>;
+using QCtmLogSinkPtr = std::shared_ptr<QCtmAbstractLogSink>;
+
+struct QCtmLogMetrics
+{
+    struct ModelLag
+    {
+        QString objectName;
+        int pending { 0 };
+        qint64 lagMsecs { 0 };
+    };
+
+    qint64 timestamp { 0 };
+    quint64 accepted[QtMsgType::QtInfoMsg + 1] {};
+    quint64 dropped[QtMsgType::QtInfoMsg + 1] {};
+    quint64 suppressed { 0 };
+    quint64 rateLimited { 0 };
+    int queueDepth { 0 };
+    int queueHighWater { 0 };
+    quint64 bytesWritten { 0 };
+    quint64 flushCount { 0 };
+    quint64 rotationCount { 0 };
+    qint64 averageWriteNsecs { 0 };
+    qint64 maxWriteNsecs { 0 };
+    QVector<ModelLag> models;
+};
+Q_DECLARE_METATYPE(QCtmLogMetrics)
 
 class QCUSTOMUI_EXPORT QCtmLogManager
 {
@@ -37,6 +66,13 @@ public:
         Size
     };
 
+    enum AsyncOverflowPolicy
+    {
+        Block,
+        DropLowestLevel,
+        DropNewest
+    };
+
     static void initBeforeApp();
     static QCtmLogManager& instance();
     void setLogFilePath(const QString& path);
@@ -47,6 +83,49 @@ public:
     bool logTypeEnable(QtMsgType type) const;
     void setLogSizeLimit(qint64 size);
     qint64 logSizeLimit() const;
+    void setLogCompressionEnabled(bool enable);
+    bool logCompressionEnabled() const;
+    void setLogRetentionCount(int count);
+    int logRetentionCount() const;
+    void setLogRetentionSize(qint64 bytes);
+    qint64 logRetentionSize() const;
+    void setLogRetentionDays(int days);
+    int logRetentionDays() const;
+    static bool extractLogArchive(const QString& archive, const QString& fileName);
+    void setAsyncEnabled(bool enable);
+    bool asyncEnabled() const;
+    void setAsyncQueueCapacity(int capacity);
+    int asyncQueueCapacity() const;
+    void setAsyncOverflowPolicy(AsyncOverflowPolicy policy);
+    AsyncOverflowPolicy asyncOverflowPolicy() const;
+    int asyncQueueDepth() const;
+    quint64 droppedCount(QtMsgType type) const;
+    quint64 droppedCount() const;
+    void setMessageTypeEnabled(QtMsgType type, bool enable);
+    bool messageTypeEnabled(QtMsgType type) const;
+    void setCategoryEnabled(const QString& category, QtMsgType type, bool enable);
+    bool categoryEnabled(const QString& category, QtMsgType type) const;
+    void setDeduplicationWindow(int msec);
+    int deduplicationWindow() const;
+    void setRateLimit(int perSecond);
+    int rateLimit() const;
+    void setRateLimitBurst(int count);
+    int rateLimitBurst() const;
+    quint64 suppressedCount() const;
+    quint64 rateLimitedCount() const;
+    void setFlushThreshold(qint64 bytes);
+    qint64 flushThreshold() const;
+    void setFlushInterval(int msec);
+    int flushInterval() const;
+    void flush();
+    void addSink(QCtmLogSinkPtr sink);
+    void removeSink(const QCtmLogSinkPtr& sink);
+    QVector<QCtmLogSinkPtr> sinks() const;
+    void setCrashHandlerEnabled(bool enable);
+    bool crashHandlerEnabled() const;
+    QCtmLogMetrics metrics() const;
+    bool setLogPattern(const QString& pattern);
+    QString logPattern() const;
 
 protected:
     QCtmLogManager();
@@ -0,0 +1,147 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#include "QCtmLogMemorySink.h"
+#include "Private/QCtmLogRingBuffer_p.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+
+struct QCtmLogMemorySink::Impl
+{
+    QCtmLogRingBuffer<QCtmLogDataPtr> logs;
+    mutable QMutex mutex;
+};
+
+/*!
+    \class      QCtmLogMemorySink
+    \brief      在内存中保留最近日志的输出目标, 超出容量时丢弃最旧的日志, 可用于崩溃报告或诊断界面.
+    \inherits   QCtmAbstractLogSink
+    \ingroup    QCustomUi
+    \inmodule   QCustomUi
+    \inheaderfile QCtmLogMemorySink.h
+    \sa         QCtmLogManager::addSink
+*/
+
+/*!
+    \brief      构造一个最多保留 \a capacity 条日志的输出目标.
+*/
+QCtmLogMemorySink::QCtmLogMemorySink(int capacity /* = 10000 */) : m_impl(std::make_unique<Impl>())
+{
+    m_impl->logs.setCapacity(capacity);
+}
+
+/*!
+    \brief      析构函数.
+*/
+QCtmLogMemorySink::~QCtmLogMemorySink() {}
+
+/*!
+    \brief      设置保留的日志数量 \a capacity, 超出部分丢弃最旧的日志.
+    \sa         capacity
+*/
+void QCtmLogMemorySink::setCapacity(int capacity)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    m_impl->logs.setCapacity(capacity);
+}
+
+/*!
+    \brief      返回保留的日志数量上限.
+    \sa         setCapacity
+*/
+int QCtmLogMemorySink::capacity() const
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    return m_impl->logs.capacity();
+}
+
+/*!
+    \brief      返回当前保留的日志数量.
+*/
+int QCtmLogMemorySink::size() const
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    return m_impl->logs.size();
+}
+
+/*!
+    \brief      返回保留的日志, 由旧到新排列.
+*/
+QVector<QCtmLogDataPtr> QCtmLogMemorySink::logs() const
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    QVector<QCtmLogDataPtr> logs;
+    logs.reserve(m_impl->logs.size());
+    for (int i = 0; i < m_impl->logs.size(); i++)
+    {
+        logs.push_back(m_impl->logs[i]);
+    }
+    return logs;
+}
+
+/*!
+    \brief      清空保留的日志.
+*/
+void QCtmLogMemorySink::clear()
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    m_impl->logs.clear();
+}
+
+/*!
+    \reimp
+*/
+void QCtmLogMemorySink::write(const QVector<QCtmLogDataPtr>& logs)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    auto& buffer = m_impl->logs;
+    if (buffer.capacity() <= 0)
+        return;
+    for (const auto& log : logs)
+    {
+        if (buffer.isFull())
+            buffer.popFront(1);
+        buffer.pushBack(QCtmLogDataPtr(log));
+    }
+}
@@ -0,0 +1,41 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include "QCtmAbstractLogSink.h"
+
+class QCUSTOMUI_EXPORT QCtmLogMemorySink : public QCtmAbstractLogSink
+{
+public:
+    explicit QCtmLogMemorySink(int capacity = 10000);
+    ~QCtmLogMemorySink();
+
+    void setCapacity(int capacity);
+    int capacity() const;
+    int size() const;
+    QVector<QCtmLogDataPtr> logs() const;
+    void clear();
+
+    void write(const QVector<QCtmLogDataPtr>& logs) override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
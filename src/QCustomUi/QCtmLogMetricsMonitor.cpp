@@ -0,0 +1,119 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#include "QCtmLogMetricsMonitor.h"
+
+#include <QTimer>
+
+struct QCtmLogMetricsMonitor::Impl
+{
+    QTimer* timer { nullptr };
+    QCtmLogMetrics metrics;
+};
+
+/*!
+    \class      QCtmLogMetricsMonitor
+    \brief      定时采集日志系统的运行指标, 用于诊断界面显示或在日志本身成为瓶颈时报警.
+    \inherits   QObject
+    \ingroup    QCustomUi
+    \inmodule   QCustomUi
+    \inheaderfile QCtmLogMetricsMonitor.h
+    \sa         QCtmLogManager::metrics
+*/
+
+/*!
+    \fn         void QCtmLogMetricsMonitor::metricsUpdated(const QCtmLogMetrics& metrics);
+    \brief      每个采集周期发送一次最新的指标快照 \a metrics.
+*/
+
+/*!
+    \brief      构造一个指标监视器, 父对象为 \a parent, 默认周期为 1000 毫秒, 需调用 start 开始采集.
+*/
+QCtmLogMetricsMonitor::QCtmLogMetricsMonitor(QObject* parent /* = nullptr */) : QObject(parent), m_impl(std::make_unique<Impl>())
+{
+    m_impl->timer = new QTimer(this);
+    m_impl->timer->setInterval(1000);
+    connect(m_impl->timer,
+            &QTimer::timeout,
+            this,
+            [this]()
+            {
+                m_impl->metrics = QCtmLogManager::instance().metrics();
+                emit metricsUpdated(m_impl->metrics);
+            });
+}
+
+/*!
+    \brief      析构函数.
+*/
+QCtmLogMetricsMonitor::~QCtmLogMetricsMonitor() {}
+
+/*!
+    \brief      设置采集周期 \a msec.
+    \sa         interval
+*/
+void QCtmLogMetricsMonitor::setInterval(int msec)
+{
+    m_impl->timer->setInterval(msec);
+}
+
+/*!
+    \brief      返回采集周期.
+    \sa         setInterval
+*/
+int QCtmLogMetricsMonitor::interval() const
+{
+    return m_impl->timer->interval();
+}
+
+/*!
+    \brief      返回是否正在采集.
+    \sa         start, stop
+*/
+bool QCtmLogMetricsMonitor::isActive() const
+{
+    return m_impl->timer->isActive();
+}
+
+/*!
+    \brief      返回最近一次采集的指标.
+    \sa         metricsUpdated
+*/
+const QCtmLogMetrics& QCtmLogMetricsMonitor::lastMetrics() const
+{
+    return m_impl->metrics;
+}
+
+/*!
+    \brief      开始周期性采集.
+    \sa         stop
+*/
+void QCtmLogMetricsMonitor::start()
+{
+    m_impl->timer->start();
+}
+
+/*!
+    \brief      停止采集.
+    \sa         start
+*/
+void QCtmLogMetricsMonitor::stop()
+{
+    m_impl->timer->stop();
+}
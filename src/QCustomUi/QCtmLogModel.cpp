@@ -18,10 +18,15 @@
 **********************************************************************************/
 
 #include "QCtmLogModel.h"
+#include "Private/QCtmLogRingBuffer_p.h"
+#include "Private/QCtmLogTrigramIndex_p.h"
 #include "QCtmLogData.h"
 
 #include <QDebug>
 
+#include <algorithm>
+#include <limits>
+
 enum class Column
 {
     Level,
@@ -29,9 +34,39 @@ enum class Column
     Message
 };
 
+inline QString msgLimit(const QString& msg)
+{
+    return msg.size() > 512 ? msg.left(512) + "..." : msg;
+}
+
+// 去重后的摘要日志附加重复次数
+inline QString withRepeat(const QString& msg, quint32 repeat)
+{
+    return repeat > 1 ? msg + QLatin1Char(' ') + QChar(0x00d7) + QString::number(repeat) : msg;
+}
+
 struct QCtmLogModel::Impl
 {
-    QList<QCtmLogMessage> datas;
+    // 显示文本在首次访问时生成并缓存, 重绘与滚动时直接返回共享的字符串
+    struct Row : QCtmLogMessage
+    {
+        mutable QString time;
+        mutable QString limited;
+        mutable QString display;
+        mutable bool rendered { false };
+
+        inline void render() const
+        {
+            if (rendered)
+                return;
+            time     = dateTime.toString("yyyy-MM-dd hh:mm:ss");
+            limited  = msgLimit(msg);
+            display  = withRepeat(limited, repeatCount);
+            rendered = true;
+        }
+    };
+
+    QCtmLogRingBuffer<Row> datas { 10000 };
     QList<QString> headers;
     QIcon infoIcon;
     QIcon warningIcon;
@@ -43,6 +78,85 @@ struct QCtmLogModel::Impl
     int infoCount { 0 };
 
     QCtmLogData::LogInsertPolicy logInsertPolicy { QCtmLogData::LogInsertPolicy::ASC };
+    std::unique_ptr<QCtmLogTrigramIndex> index;
+
+    // 行号到缓冲区下标的映射, 逆序插入时最新的日志位于首行
+    inline const Row& at(int row) const
+    {
+        return logInsertPolicy == QCtmLogData::LogInsertPolicy::ASC ? datas[row] : datas[datas.size() - 1 - row];
+    }
+
+    // 移除缓冲区中最旧的 n 条日志前调用, 更新计数与索引
+    inline void evict(int n)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            count(datas[i].type, -1);
+            if (index)
+                index->removeFront(datas[i].msg);
+        }
+    }
+
+    inline void append(Row&& msg)
+    {
+        count(msg.type, 1);
+        if (index)
+        {
+            if (index->nextId() == std::numeric_limits<quint32>::max())
+                rebuildIndex(); // 行号即将回绕
+            index->add(msg.msg);
+        }
+        datas.pushBack(std::move(msg));
+    }
+
+    inline void rebuildIndex()
+    {
+        index->clear();
+        for (int i = 0; i < datas.size(); i++)
+        {
+            index->add(datas[i].msg);
+        }
+    }
+
+    // 缓冲区中第一条时间不早于 (upper 为晚于) msecs 的日志下标, 日志按时间顺序到达
+    inline int timeBound(qint64 msecs, bool upper) const
+    {
+        int first = 0;
+        int count = datas.size();
+        while (count > 0)
+        {
+            const int step = count / 2;
+            const auto t   = datas[first + step].dateTime.toMSecsSinceEpoch();
+            if (upper ? t <= msecs : t < msecs)
+            {
+                first += step + 1;
+                count -= step + 1;
+            }
+            else
+            {
+                count = step;
+            }
+        }
+        return first;
+    }
+
+    inline void count(QtMsgType type, int delta)
+    {
+        switch (type)
+        {
+        case QtMsgType::QtInfoMsg:
+            infoCount += delta;
+            break;
+        case QtMsgType::QtWarningMsg:
+            warningCount += delta;
+            break;
+        case QtMsgType::QtCriticalMsg:
+            errorCount += delta;
+            break;
+        default:
+            break;
+        }
+    }
 };
 
 /*!
@@ -78,15 +192,21 @@ void QCtmLogModel::clear()
 {
     beginResetModel();
     m_impl->datas.clear();
+    if (m_impl->index)
+        m_impl->index->clear();
     m_impl->infoCount    = 0;
     m_impl->errorCount   = 0;
     m_impl->warningCount = 0;
     endResetModel();
 }
 
-inline QString msgLimit(const QString& msg)
+/*!
+    \reimp
+*/
+QString QCtmLogModel::messageAt(int row) const
 {
-    return msg.size() > 512 ? msg.left(512) + "..." : msg;
+    const auto& msg = m_impl->at(row);
+    return withRepeat(msg.msg, msg.repeatCount);
 }
 
 /*!
@@ -94,15 +214,16 @@ inline QString msgLimit(const QString& msg)
 */
 QVariant QCtmLogModel::data(const QModelIndex& index, int role /* = Qt::DisplayRole */) const
 {
-    auto& msg = m_impl->datas[index.row()];
+    const auto& msg = m_impl->at(index.row());
     if (role == Qt::DisplayRole)
     {
+        msg.render();
         switch (static_cast<Column>(index.column()))
         {
         case Column::DateTime:
-            return msg.dateTime.toString("yyyy-MM-dd hh:mm:ss");
+            return msg.time;
         case Column::Message:
-            return msgLimit(msg.msg);
+            return msg.display;
         default:
             break;
         }
@@ -111,6 +232,10 @@ QVariant QCtmLogModel::data(const QModelIndex& index, int role /* = Qt::DisplayR
     {
         return msg.type;
     }
+    else if (role == TimeRole)
+    {
+        return msg.dateTime.toMSecsSinceEpoch();
+    }
     else if (role == Qt::DecorationRole)
     {
         if (index.column() == 0)
@@ -132,7 +257,8 @@ QVariant QCtmLogModel::data(const QModelIndex& index, int role /* = Qt::DisplayR
     {
         if (index.column() == 2)
         {
-            return msgLimit(msg.msg);
+            msg.render();
+            return msg.limited;
         }
     }
     else if (role == CopyMessageRole)
@@ -140,9 +266,10 @@ QVariant QCtmLogModel::data(const QModelIndex& index, int role /* = Qt::DisplayR
         switch (static_cast<Column>(index.column()))
         {
         case Column::DateTime:
-            return msg.dateTime.toString("yyyy-MM-dd hh:mm:ss");
+            msg.render();
+            return msg.time;
         case Column::Message:
-            return msg.msg;
+            return withRepeat(msg.msg, msg.repeatCount);
         default:
             break;
         }
@@ -194,7 +321,20 @@ int QCtmLogModel::columnCount([[maybe_unused]] const QModelIndex& parent /*= QMo
 */
 void QCtmLogModel::setMaximumCount(int count)
 {
-    m_impl->maxCount = count;
+    m_impl->maxCount   = count;
+    const int overflow = m_impl->datas.size() - std::max(count, 0);
+    if (overflow > 0)
+    {
+        const int first = m_impl->logInsertPolicy == QCtmLogData::LogInsertPolicy::ASC ? 0 : m_impl->datas.size() - overflow;
+        beginRemoveRows(QModelIndex(), first, first + overflow - 1);
+        m_impl->evict(overflow);
+        m_impl->datas.setCapacity(count);
+        endRemoveRows();
+    }
+    else
+    {
+        m_impl->datas.setCapacity(count);
+    }
 }
 
 /*!
@@ -212,7 +352,11 @@ int QCtmLogModel::maximumCount() const
 */
 void QCtmLogModel::setLogInsertPolicy(QCtmLogData::LogInsertPolicy policy)
 {
+    if (m_impl->logInsertPolicy == policy)
+        return;
+    beginResetModel();
     m_impl->logInsertPolicy = policy;
+    endResetModel();
 }
 
 /*!
@@ -303,61 +447,155 @@ int QCtmLogModel::errorCount() const
 }
 
 /*!
-    \reimp
+    \brief      设置是否为日志消息建立全文索引 \a enable, 默认关闭.
+                索引随日志的插入与移除增量维护, 开启后 findRows 与 QCtmLogWidget 的查询使用索引,
+                长度不小于3个字符的关键字可以快速定位, 索引占用的内存可以通过 fullTextIndexMemoryUsage 查询.
+    \sa         fullTextIndexEnabled, fullTextIndexMemoryUsage, findRows
 */
-void QCtmLogModel::onLog(QCtmLogDataPtr log)
+void QCtmLogModel::setFullTextIndexEnabled(bool enable)
+{
+    if (enable == fullTextIndexEnabled())
+        return;
+    if (!enable)
+    {
+        m_impl->index.reset();
+        return;
+    }
+    m_impl->index = std::make_unique<QCtmLogTrigramIndex>();
+    m_impl->rebuildIndex();
+}
+
+/*!
+    \brief      返回是否为日志消息建立全文索引.
+    \sa         setFullTextIndexEnabled
+*/
+bool QCtmLogModel::fullTextIndexEnabled() const
+{
+    return m_impl->index != nullptr;
+}
+
+/*!
+    \brief      返回全文索引占用内存的估计值, 单位为字节, 未开启索引时返回 0.
+    \sa         setFullTextIndexEnabled
+*/
+qint64 QCtmLogModel::fullTextIndexMemoryUsage() const
 {
-    while (m_impl->datas.size() >= m_impl->maxCount && !m_impl->datas.isEmpty())
+    return m_impl->index ? m_impl->index->memoryUsage() : 0;
+}
+
+/*!
+    \brief      查询消息同时包含 \a keywords 中全部关键字的行, 关键字以空白分隔, 不区分大小写.
+                开启全文索引时先由索引筛选候选行, 否则逐行比较.
+    \return     按升序排列的行号.
+    \sa         setFullTextIndexEnabled
+*/
+QVector<int> QCtmLogModel::findRows(const QString& keywords) const
+{
+    QVector<int> rows;
+    const auto terms = QCtmLogTrigramIndex::terms(keywords);
+    if (terms.isEmpty())
+        return rows;
+    auto matches = [&](int i)
     {
-        const auto& msg = m_impl->datas.front();
-        switch (msg.type)
+        const auto& msg = m_impl->datas[i].msg;
+        return std::all_of(terms.begin(), terms.end(), [&](const QString& term) { return msg.contains(term, Qt::CaseInsensitive); });
+    };
+    const bool asc = m_impl->logInsertPolicy == QCtmLogData::LogInsertPolicy::ASC;
+    const int size = m_impl->datas.size();
+    std::vector<quint32> candidates;
+    if (m_impl->index && m_impl->index->candidates(terms, candidates))
+    {
+        for (auto id : candidates)
         {
-        case QtMsgType::QtInfoMsg:
-            m_impl->infoCount--;
-            break;
-        case QtMsgType::QtWarningMsg:
-            m_impl->warningCount--;
-            break;
-        case QtMsgType::QtCriticalMsg:
-            m_impl->errorCount--;
-            break;
-        default:
-            return;
+            const int i = static_cast<int>(id - m_impl->index->firstId());
+            if (matches(i))
+                rows.push_back(asc ? i : size - 1 - i);
         }
-        beginRemoveRows(QModelIndex(), 0, 0);
-        if (m_impl->logInsertPolicy == QCtmLogData::LogInsertPolicy::ASC)
-            m_impl->datas.removeFirst();
-        else
-            m_impl->datas.removeLast();
-        endRemoveRows();
     }
+    else
+    {
+        for (int i = 0; i < size; i++)
+        {
+            if (matches(i))
+                rows.push_back(asc ? i : size - 1 - i);
+        }
+    }
+    if (!asc)
+        std::reverse(rows.begin(), rows.end());
+    return rows;
+}
 
-    if (m_impl->maxCount <= 0)
+/*!
+    \brief      返回时间不早于 \a time 的第一条日志所在的行, 没有这样的日志时返回最新日志所在的行, 没有日志时返回 -1.
+                日志按到达顺序存储, 以二分查找定位. 逆序插入时返回的行同样对应时间上的第一条日志.
+    \sa         rowsForTimeRange
+*/
+int QCtmLogModel::rowForTime(const QDateTime& time) const
+{
+    const int size = m_impl->datas.size();
+    if (size == 0)
+        return -1;
+    const int i = std::min(m_impl->timeBound(time.toMSecsSinceEpoch(), false), size - 1);
+    return m_impl->logInsertPolicy == QCtmLogData::LogInsertPolicy::ASC ? i : size - 1 - i;
+}
+
+/*!
+    \brief      返回时间在 \a from 与 \a to 之间 (包含两端) 的日志所在的行范围, 没有这样的日志时返回 (-1, -1).
+    \sa         rowForTime
+*/
+QPair<int, int> QCtmLogModel::rowsForTimeRange(const QDateTime& from, const QDateTime& to) const
+{
+    const int first = m_impl->timeBound(from.toMSecsSinceEpoch(), false);
+    const int last  = m_impl->timeBound(to.toMSecsSinceEpoch(), true) - 1;
+    if (first > last)
+        return { -1, -1 };
+    if (m_impl->logInsertPolicy == QCtmLogData::LogInsertPolicy::ASC)
+        return { first, last };
+    const int size = m_impl->datas.size();
+    return { size - 1 - last, size - 1 - first };
+}
+
+/*!
+    \reimp
+*/
+void QCtmLogModel::onLog(QCtmLogDataPtr log)
+{
+    onLogBatch({ log });
+}
+
+/*!
+    \reimp
+*/
+void QCtmLogModel::onLogBatch(const QVector<QCtmLogDataPtr>& logs)
+{
+    if (m_impl->maxCount <= 0 || logs.isEmpty())
         return;
 
-    QCtmLogMessage msg;
-    msg.dateTime = log->dateTime();
-    msg.msg      = log->msg();
-    msg.type     = log->type();
-    switch (msg.type)
+    // 超出容量的部分只保留本批中最新的日志
+    const int incoming = std::min<int>(logs.size(), m_impl->maxCount);
+    const int overflow = std::min<int>(m_impl->datas.size() + incoming - m_impl->maxCount, m_impl->datas.size());
+    const bool asc     = m_impl->logInsertPolicy == QCtmLogData::LogInsertPolicy::ASC;
+    if (overflow > 0)
     {
-    case QtMsgType::QtInfoMsg:
-        m_impl->infoCount++;
-        break;
-    case QtMsgType::QtWarningMsg:
-        m_impl->warningCount++;
-        break;
-    case QtMsgType::QtCriticalMsg:
-        m_impl->errorCount++;
-        break;
-    default:
-        break;
+        const int first = asc ? 0 : m_impl->datas.size() - overflow;
+        beginRemoveRows(QModelIndex(), first, first + overflow - 1);
+        m_impl->evict(overflow);
+        m_impl->datas.popFront(overflow);
+        endRemoveRows();
+    }
+
+    const int first = asc ? m_impl->datas.size() : 0;
+    beginInsertRows(QModelIndex(), first, first + incoming - 1);
+    for (auto it = logs.end() - incoming; it != logs.end(); ++it)
+    {
+        const auto& log = *it;
+        Impl::Row msg;
+        msg.dateTime    = log->dateTime();
+        msg.msg         = log->msg();
+        msg.type        = log->type();
+        msg.repeatCount = log->repeatCount();
+        m_impl->append(std::move(msg));
     }
-    beginInsertRows(QModelIndex(), m_impl->datas.size(), m_impl->datas.size());
-    if (m_impl->logInsertPolicy == QCtmLogData::LogInsertPolicy::ASC)
-        m_impl->datas.push_back(msg);
-    else
-        m_impl->datas.push_front(msg);
     endInsertRows();
 }
 
@@ -32,6 +32,7 @@ struct QCUSTOMUI_EXPORT QCtmLogMessage
     QString msg;
     QDateTime dateTime;
     QtMsgType type;
+    quint32 repeatCount { 1 };
 };
 
 class QCUSTOMUI_EXPORT QCtmLogModel : public QCtmAbstractLogModel
@@ -41,16 +42,11 @@ class QCUSTOMUI_EXPORT QCtmLogModel : public QCtmAbstractLogModel
     Q_PROPERTY(QIcon warningIcon READ warningIcon WRITE setWarningIcon)
     Q_PROPERTY(QIcon errorIcon READ errorIcon WRITE setErrorIcon)
 public:
-    enum
-    {
-        TypeRole = Qt::UserRole + 1,
-        CopyMessageRole
-    };
-
     explicit QCtmLogModel(const QString& objectName, QObject* parent = nullptr);
     ~QCtmLogModel();
 
     void clear() override;
+    QString messageAt(int row) const override;
     QVariant data(const QModelIndex& index, int role /* = Qt::DisplayRole */) const override;
     bool setData(const QModelIndex& index, const QVariant& value, int role /* = Qt::EditRole */) override;
     QVariant headerData(int section, Qt::Orientation orientation, int role /* = Qt::DisplayRole */) const override;
@@ -69,8 +65,15 @@ public:
     int warningCount() const;
     int infoCount() const;
     int errorCount() const;
+    void setFullTextIndexEnabled(bool enable);
+    bool fullTextIndexEnabled() const;
+    qint64 fullTextIndexMemoryUsage() const;
+    QVector<int> findRows(const QString& keywords) const;
+    int rowForTime(const QDateTime& time) const;
+    QPair<int, int> rowsForTimeRange(const QDateTime& from, const QDateTime& to) const;
 public slots:
     void onLog(QCtmLogDataPtr log) override;
+    void onLogBatch(const QVector<QCtmLogDataPtr>& logs) override;
 
 protected:
     void retranslateUi() override;
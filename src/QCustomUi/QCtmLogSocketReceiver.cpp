@@ -0,0 +1,235 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#include "QCtmLogSocketReceiver.h"
+#include "Private/QCtmLogStream_p.h"
+#include "QCtmAbstractLogModel.h"
+
+#include <QHash>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QPointer>
+
+struct QCtmLogSocketReceiver::Impl
+{
+    struct Connection
+    {
+        QByteArray buffer;
+        QString source;
+    };
+
+    QLocalServer* server { nullptr };
+    QHash<QLocalSocket*, Connection> connections;
+    QPointer<QCtmAbstractLogModel> model;
+    bool sourcePrefix { true };
+};
+
+/*!
+    \class      QCtmLogSocketReceiver
+    \brief      接收 QCtmLogSocketSink 发送的日志, 并投递到指定的日志 model, 可同时接收多个进程的日志.
+    \inherits   QObject
+    \ingroup    QCustomUi
+    \inmodule   QCustomUi
+    \inheaderfile QCtmLogSocketReceiver.h
+    \sa         QCtmLogSocketSink
+*/
+
+/*!
+    \fn         void QCtmLogSocketReceiver::logsReceived(const QString& source, const QVector<QCtmLogDataPtr>& logs);
+    \brief      收到来源 \a source 的一批日志 \a logs 时发送此信号.
+*/
+
+/*!
+    \brief      构造一个接收器, 父对象为 \a parent.
+*/
+QCtmLogSocketReceiver::QCtmLogSocketReceiver(QObject* parent /* = nullptr */) : QObject(parent), m_impl(std::make_unique<Impl>())
+{
+    m_impl->server = new QLocalServer(this);
+    connect(m_impl->server, &QLocalServer::newConnection, this, &QCtmLogSocketReceiver::onNewConnection);
+}
+
+/*!
+    \brief      析构函数.
+*/
+QCtmLogSocketReceiver::~QCtmLogSocketReceiver()
+{
+    close();
+}
+
+/*!
+    \brief      在本地服务名称 \a serverName 上开始接收, 同名的残留服务会被移除.
+    \return     成功返回 true.
+    \sa         close, errorString
+*/
+bool QCtmLogSocketReceiver::listen(const QString& serverName)
+{
+    close();
+    QLocalServer::removeServer(serverName);
+    return m_impl->server->listen(serverName);
+}
+
+/*!
+    \brief      停止接收并断开所有连接.
+    \sa         listen
+*/
+void QCtmLogSocketReceiver::close()
+{
+    m_impl->server->close();
+    const auto sockets = m_impl->connections.keys();
+    m_impl->connections.clear();
+    for (auto socket : sockets)
+    {
+        socket->disconnect(this);
+        socket->abort();
+        socket->deleteLater();
+    }
+}
+
+/*!
+    \brief      返回是否正在接收.
+*/
+bool QCtmLogSocketReceiver::isListening() const
+{
+    return m_impl->server->isListening();
+}
+
+/*!
+    \brief      返回本地服务名称.
+*/
+QString QCtmLogSocketReceiver::serverName() const
+{
+    return m_impl->server->serverName();
+}
+
+/*!
+    \brief      返回最近一次错误的描述.
+*/
+QString QCtmLogSocketReceiver::errorString() const
+{
+    return m_impl->server->errorString();
+}
+
+/*!
+    \brief      设置接收日志的 \a model, 收到的日志通过 QCtmAbstractLogModel::onLogBatch 插入.
+    \sa         model
+*/
+void QCtmLogSocketReceiver::setModel(QCtmAbstractLogModel* model)
+{
+    m_impl->model = model;
+}
+
+/*!
+    \brief      返回接收日志的 model.
+    \sa         setModel
+*/
+QCtmAbstractLogModel* QCtmLogSocketReceiver::model() const
+{
+    return m_impl->model;
+}
+
+/*!
+    \brief      设置是否在日志内容前附加 "[来源] " \a enable, 默认开启.
+    \sa         sourcePrefixEnabled
+*/
+void QCtmLogSocketReceiver::setSourcePrefixEnabled(bool enable)
+{
+    m_impl->sourcePrefix = enable;
+}
+
+/*!
+    \brief      返回是否在日志内容前附加来源.
+    \sa         setSourcePrefixEnabled
+*/
+bool QCtmLogSocketReceiver::sourcePrefixEnabled() const
+{
+    return m_impl->sourcePrefix;
+}
+
+/*!
+    \brief      返回当前的连接数量.
+*/
+int QCtmLogSocketReceiver::connectionCount() const
+{
+    return m_impl->connections.size();
+}
+
+void QCtmLogSocketReceiver::onNewConnection()
+{
+    while (auto socket = m_impl->server->nextPendingConnection())
+    {
+        m_impl->connections.insert(socket, {});
+        connect(socket,
+                &QLocalSocket::readyRead,
+                this,
+                [this, socket]()
+                {
+                    onReadyRead(socket);
+                });
+        connect(socket,
+                &QLocalSocket::disconnected,
+                this,
+                [this, socket]()
+                {
+                    onReadyRead(socket); // 处理断开前到达的数据
+                    m_impl->connections.remove(socket);
+                    socket->deleteLater();
+                });
+        if (socket->bytesAvailable() > 0)
+            onReadyRead(socket);
+    }
+}
+
+void QCtmLogSocketReceiver::onReadyRead(QLocalSocket* socket)
+{
+    auto it = m_impl->connections.find(socket);
+    if (it == m_impl->connections.end())
+        return;
+    it->buffer.append(socket->readAll());
+
+    QCtmLogStream::Frame frame;
+    bool error = false;
+    for (;;)
+    {
+        const auto prefix = m_impl->sourcePrefix && !it->source.isEmpty() ? QString("[%1] ").arg(it->source) : QString();
+        if (!QCtmLogStream::decode(it->buffer, prefix, frame, error))
+            break;
+        if (frame.kind == QCtmLogStream::Hello)
+        {
+            it->source = frame.source;
+        }
+        else if (frame.kind == QCtmLogStream::Records && !frame.logs.isEmpty())
+        {
+            if (m_impl->model)
+                m_impl->model->onLogBatch(frame.logs);
+            const auto source = it->source;
+            emit logsReceived(source, frame.logs);
+            it = m_impl->connections.find(socket); // 槽函数中可能关闭了接收器
+            if (it == m_impl->connections.end())
+                return;
+        }
+        frame = {};
+    }
+    if (error)
+    {
+        m_impl->connections.erase(it);
+        socket->disconnect(this);
+        socket->abort();
+        socket->deleteLater();
+    }
+}
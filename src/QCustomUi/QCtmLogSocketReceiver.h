@@ -0,0 +1,60 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include "qcustomui_global.h"
+
+#include <QObject>
+#include <QVector>
+
+#include <memory>
+
+using QCtmLogDataPtr = std::shared_ptr<class QCtmLogData>;
+class QCtmAbstractLogModel;
+class QLocalSocket;
+
+class QCUSTOMUI_EXPORT QCtmLogSocketReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QCtmLogSocketReceiver(QObject* parent = nullptr);
+    ~QCtmLogSocketReceiver();
+
+    bool listen(const QString& serverName);
+    void close();
+    bool isListening() const;
+    QString serverName() const;
+    QString errorString() const;
+    void setModel(QCtmAbstractLogModel* model);
+    QCtmAbstractLogModel* model() const;
+    void setSourcePrefixEnabled(bool enable);
+    bool sourcePrefixEnabled() const;
+    int connectionCount() const;
+signals:
+    void logsReceived(const QString& source, const QVector<QCtmLogDataPtr>& logs);
+
+private:
+    void onNewConnection();
+    void onReadyRead(QLocalSocket* socket);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
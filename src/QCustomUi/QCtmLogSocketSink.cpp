@@ -0,0 +1,221 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#include "QCtmLogSocketSink.h"
+#include "Private/QCtmLogStream_p.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QLocalSocket>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <atomic>
+
+namespace
+{
+constexpr int ConnectTimeoutMsecs = 100;
+constexpr int WriteTimeoutMsecs   = 1000;
+constexpr qint64 MaxPendingBytes  = 16 * 1024 * 1024; // 接收端停止读取时断开连接
+} // namespace
+
+struct QCtmLogSocketSink::Impl
+{
+    QString serverName;
+    QString sourceName;
+    std::atomic<int> reconnectInterval { 1000 };
+    std::atomic<bool> connected { false };
+    mutable QMutex mutex;
+
+    // 以下成员只在输出目标的线程中访问
+    std::unique_ptr<QLocalSocket> socket;
+    QElapsedTimer lastAttempt;
+
+    bool ensureConnected()
+    {
+        if (socket && socket->state() == QLocalSocket::ConnectedState)
+            return true;
+        connected = false;
+        if (lastAttempt.isValid() && !lastAttempt.hasExpired(reconnectInterval.load(std::memory_order_relaxed)))
+            return false;
+        lastAttempt.start();
+        if (!socket)
+            socket = std::make_unique<QLocalSocket>();
+        socket->abort();
+        socket->connectToServer(serverName);
+        if (!socket->waitForConnected(ConnectTimeoutMsecs))
+        {
+            socket->abort();
+            return false;
+        }
+        QString source;
+        {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+            QMutexLocker locker(&mutex);
+#else
+            QMutexLocker<QMutex> locker(&mutex);
+#endif
+            source = sourceName;
+        }
+        socket->write(QCtmLogStream::encodeHello(source));
+        connected = true;
+        return true;
+    }
+};
+
+/*!
+    \class      QCtmLogSocketSink
+    \brief      通过 QLocalSocket 将日志流发送到 QCtmLogSocketReceiver 的输出目标, 用于将多个进程的日志汇总到同一个界面.
+                连接在第一次写入时建立, 断开后按重连间隔重试, 未连接期间的日志被丢弃并计入 droppedCount.
+    \inherits   QCtmAbstractLogSink
+    \ingroup    QCustomUi
+    \inmodule   QCustomUi
+    \inheaderfile QCtmLogSocketSink.h
+    \sa         QCtmLogSocketReceiver, QCtmLogManager::addSink
+*/
+
+/*!
+    \brief      构造一个连接到本地服务 \a serverName 的输出目标, 来源名称默认为 "程序名:进程号".
+*/
+QCtmLogSocketSink::QCtmLogSocketSink(const QString& serverName) : m_impl(std::make_unique<Impl>())
+{
+    m_impl->serverName = serverName;
+    m_impl->sourceName = QString("%1:%2").arg(QCoreApplication::applicationName()).arg(QCoreApplication::applicationPid());
+}
+
+/*!
+    \brief      析构函数.
+*/
+QCtmLogSocketSink::~QCtmLogSocketSink() {}
+
+/*!
+    \brief      返回本地服务名称.
+*/
+QString QCtmLogSocketSink::serverName() const
+{
+    return m_impl->serverName;
+}
+
+/*!
+    \brief      设置来源名称 \a name, 在下一次连接时发送给接收端.
+    \sa         sourceName
+*/
+void QCtmLogSocketSink::setSourceName(const QString& name)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    m_impl->sourceName = name;
+}
+
+/*!
+    \brief      返回来源名称.
+    \sa         setSourceName
+*/
+QString QCtmLogSocketSink::sourceName() const
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker locker(&m_impl->mutex);
+#else
+    QMutexLocker<QMutex> locker(&m_impl->mutex);
+#endif
+    return m_impl->sourceName;
+}
+
+/*!
+    \brief      设置断开后的重连间隔 \a msec, 默认为 1000 毫秒.
+    \sa         reconnectInterval
+*/
+void QCtmLogSocketSink::setReconnectInterval(int msec)
+{
+    m_impl->reconnectInterval.store(std::max(msec, 0), std::memory_order_relaxed);
+}
+
+/*!
+    \brief      返回断开后的重连间隔.
+    \sa         setReconnectInterval
+*/
+int QCtmLogSocketSink::reconnectInterval() const
+{
+    return m_impl->reconnectInterval.load(std::memory_order_relaxed);
+}
+
+/*!
+    \brief      返回是否已连接到接收端.
+*/
+bool QCtmLogSocketSink::isConnected() const
+{
+    return m_impl->connected.load(std::memory_order_relaxed);
+}
+
+/*!
+    \reimp
+*/
+void QCtmLogSocketSink::write(const QVector<QCtmLogDataPtr>& logs)
+{
+    if (!m_impl->ensureConnected())
+    {
+        addDroppedCount(logs.size());
+        return;
+    }
+    auto& socket = *m_impl->socket;
+    socket.write(QCtmLogStream::encodeRecords(logs));
+    socket.flush(); // 没有事件循环, 主动写出
+    while (socket.bytesToWrite() > MaxPendingBytes && socket.waitForBytesWritten(WriteTimeoutMsecs))
+        ;
+    if (socket.bytesToWrite() > MaxPendingBytes || socket.state() != QLocalSocket::ConnectedState)
+    {
+        socket.abort();
+        m_impl->connected = false;
+    }
+}
+
+/*!
+    \reimp
+*/
+void QCtmLogSocketSink::flush()
+{
+    if (m_impl->socket && m_impl->socket->state() == QLocalSocket::ConnectedState)
+    {
+        m_impl->socket->flush();
+        if (m_impl->socket->bytesToWrite() > 0)
+            m_impl->socket->waitForBytesWritten(0);
+    }
+}
+
+/*!
+    \reimp
+*/
+void QCtmLogSocketSink::close()
+{
+    if (m_impl->socket)
+    {
+        if (m_impl->socket->state() == QLocalSocket::ConnectedState)
+        {
+            m_impl->socket->flush();
+            m_impl->socket->waitForBytesWritten(WriteTimeoutMsecs);
+            m_impl->socket->disconnectFromServer();
+        }
+        m_impl->socket.reset();
+    }
+    m_impl->connected = false;
+}
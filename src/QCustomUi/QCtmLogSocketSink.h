@@ -0,0 +1,46 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include "QCtmAbstractLogSink.h"
+
+#include <QString>
+
+class QCUSTOMUI_EXPORT QCtmLogSocketSink : public QCtmAbstractLogSink
+{
+public:
+    explicit QCtmLogSocketSink(const QString& serverName);
+    ~QCtmLogSocketSink();
+
+    QString serverName() const;
+    void setSourceName(const QString& name);
+    QString sourceName() const;
+    void setReconnectInterval(int msec);
+    int reconnectInterval() const;
+    bool isConnected() const;
+
+    void write(const QVector<QCtmLogDataPtr>& logs) override;
+    void flush() override;
+    void close() override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
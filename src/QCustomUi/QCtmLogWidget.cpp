@@ -18,15 +18,22 @@
 **********************************************************************************/
 
 #include "QCtmLogWidget.h"
+#include "Private/QCtmLogExporter_p.h"
 #include "Private/QCtmLogFilterModel.h"
 #include "Private/QCtmToolButton_p.h"
 #include "QCtmComboBox.h"
+#include "QCtmLogFileModel.h"
+#include "QCtmLogManager.h"
 #include "QCtmLogModel.h"
 #include "QCtmTableView.h"
 
 #include <QApplication>
+#include <QCheckBox>
 #include <QClipboard>
 #include <QComboBox>
+#include <QDateTimeEdit>
+#include <QFileDialog>
+#include <QFileInfo>
 #include <QHBoxLayout>
 #include <QHeaderView>
 #include <QLineEdit>
@@ -38,9 +45,13 @@ struct QCtmLogWidget::Impl
 {
     QCtmLogFilterModel* proxyModel { nullptr };
     QCtmLogModel* model { nullptr };
+    QCtmLogFileModel* fileModel { nullptr };
     QWidgetAction* searchAction { nullptr };
     QCtmToolButton* searchButton { nullptr };
     QCtmComboBox* searchEdit { nullptr };
+    QCheckBox* timeRangeCheck { nullptr };
+    QDateTimeEdit* fromTimeEdit { nullptr };
+    QDateTimeEdit* toTimeEdit { nullptr };
 
     QCtmTableView* logView { nullptr };
     QAction* infoAction { nullptr };
@@ -48,6 +59,10 @@ struct QCtmLogWidget::Impl
     QAction* errorAction { nullptr };
     QAction* clearAction { nullptr };
     QAction* copyAction { nullptr };
+    QAction* exportAction { nullptr };
+    QCtmLogExporter* exporter { nullptr };
+    qint64 exportWritten { 0 };
+    qint64 exportTotal { 0 };
 };
 
 /*!
@@ -85,6 +100,27 @@ struct QCtmLogWidget::Impl
                 日志描述.
 */
 
+/*!
+    \enum       QCtmLogWidget::ExportFormat
+                日志导出格式.
+    \value      Csv
+                逗号分隔值, 包含时间、等级与描述三列.
+    \value      LogLine
+                与 QCtmLogManager 日志文件相同的行格式, 代码位置字段为空, 可由 openLogFiles 重新打开.
+*/
+
+/*!
+    \fn         void QCtmLogWidget::exportProgress(qint64 written, qint64 total)
+    \brief      导出进度, 已写出 \a written 条, 共 \a total 条.
+    \sa         exportLogs
+*/
+
+/*!
+    \fn         void QCtmLogWidget::exportFinished(bool success)
+    \brief      导出结束, \a success 为 false 表示导出被取消或写入失败.
+    \sa         exportLogs, cancelExport
+*/
+
 /*!
     \brief      构造函数 \a objectName, \a parent.
 */
@@ -166,6 +202,9 @@ void QCtmLogWidget::init()
     m_impl->copyAction->setObjectName("copyAction");
     m_impl->copyAction->setShortcut(QKeySequence::Copy);
     m_impl->copyAction->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+    m_impl->exportAction = new QAction(this);
+    m_impl->exportAction->setObjectName("exportAction");
+    m_impl->exporter = new QCtmLogExporter(this);
     m_impl->searchEdit = new QCtmComboBox(this);
     m_impl->searchEdit->setObjectName("searchEdit");
     m_impl->searchEdit->setEditable(true);
@@ -189,11 +228,35 @@ void QCtmLogWidget::init()
     addAction(sep);
     addAction(m_impl->clearAction);
     addAction(m_impl->copyAction);
+    addAction(m_impl->exportAction);
 
     auto wa = new QWidgetAction(this);
     wa->setDefaultWidget(m_impl->searchEdit);
     addAction(wa);
 
+    auto timeRange = new QWidget(this);
+    timeRange->setObjectName("timeRange");
+    auto timeLayout = new QHBoxLayout(timeRange);
+    timeLayout->setContentsMargins(0, 0, 0, 0);
+    m_impl->timeRangeCheck = new QCheckBox(tr("Time"), timeRange);
+    m_impl->timeRangeCheck->setObjectName("timeRangeCheck");
+    m_impl->fromTimeEdit = new QDateTimeEdit(QDateTime::currentDateTime().addSecs(-3600), timeRange);
+    m_impl->fromTimeEdit->setObjectName("fromTimeEdit");
+    m_impl->toTimeEdit = new QDateTimeEdit(QDateTime::currentDateTime(), timeRange);
+    m_impl->toTimeEdit->setObjectName("toTimeEdit");
+    for (auto edit : { m_impl->fromTimeEdit, m_impl->toTimeEdit })
+    {
+        edit->setDisplayFormat("yyyy-MM-dd hh:mm:ss");
+        edit->setCalendarPopup(true);
+        edit->setEnabled(false);
+    }
+    timeLayout->addWidget(m_impl->timeRangeCheck);
+    timeLayout->addWidget(m_impl->fromTimeEdit);
+    timeLayout->addWidget(m_impl->toTimeEdit);
+    auto ta = new QWidgetAction(this);
+    ta->setDefaultWidget(timeRange);
+    addAction(ta);
+
     m_impl->proxyModel = new QCtmLogFilterModel(this);
     m_impl->proxyModel->showLog(QtMsgType::QtInfoMsg, true);
     m_impl->proxyModel->showLog(QtMsgType::QtWarningMsg, true);
@@ -258,8 +321,59 @@ void QCtmLogWidget::init()
                 const auto& text = m_impl->searchEdit->currentText();
                 search(text);
             });
+    auto applyTimeRange = [this]()
+    {
+        const bool enable = m_impl->timeRangeCheck->isChecked();
+        m_impl->fromTimeEdit->setEnabled(enable);
+        m_impl->toTimeEdit->setEnabled(enable);
+        if (enable)
+            m_impl->proxyModel->setTimeRange(m_impl->fromTimeEdit->dateTime(), m_impl->toTimeEdit->dateTime());
+        else
+            m_impl->proxyModel->clearTimeRange();
+        m_impl->logView->horizontalHeader()->reset();
+    };
+    connect(m_impl->timeRangeCheck, &QCheckBox::toggled, this, applyTimeRange);
+    connect(m_impl->fromTimeEdit, &QDateTimeEdit::dateTimeChanged, this, applyTimeRange);
+    connect(m_impl->toTimeEdit, &QDateTimeEdit::dateTimeChanged, this, applyTimeRange);
     connect(m_impl->clearAction, &QAction::triggered, this, &QCtmLogWidget::clear);
     connect(m_impl->copyAction, &QAction::triggered, this, &QCtmLogWidget::copy);
+    connect(m_impl->exportAction,
+            &QAction::triggered,
+            this,
+            [this]()
+            {
+                if (isExporting())
+                {
+                    cancelExport();
+                    return;
+                }
+                QString filter;
+                const auto fileName =
+                    QFileDialog::getSaveFileName(this, tr("Export Logs"), QString(), tr("Log files (*.log);;CSV files (*.csv)"), &filter);
+                if (fileName.isEmpty())
+                    return;
+                const bool csv = QFileInfo(fileName).suffix().compare("csv", Qt::CaseInsensitive) == 0 || filter.contains("*.csv");
+                exportLogs(fileName, csv ? ExportFormat::Csv : ExportFormat::LogLine);
+            });
+    connect(m_impl->exporter,
+            &QCtmLogExporter::progress,
+            this,
+            [this](qint64 written, qint64 total)
+            {
+                m_impl->exportWritten = written;
+                m_impl->exportTotal   = total;
+                updateExportText();
+                emit exportProgress(written, total);
+            });
+    connect(m_impl->exporter,
+            &QCtmLogExporter::finished,
+            this,
+            [this](bool success)
+            {
+                updateExportText();
+                emit exportFinished(success);
+            });
+    updateExportText();
     connect(m_impl->model, &QAbstractItemModel::rowsInserted, this, &QCtmLogWidget::updateLogCount);
     connect(m_impl->model, &QAbstractItemModel::rowsRemoved, this, &QCtmLogWidget::updateLogCount);
     connect(m_impl->model, &QAbstractItemModel::modelReset, this, &QCtmLogWidget::updateLogCount);
@@ -286,7 +400,25 @@ void QCtmLogWidget::changeEvent(QEvent* e)
     if (e->type() == QEvent::LanguageChange)
     {
         updateLogCount();
+        m_impl->timeRangeCheck->setText(tr("Time"));
+        updateExportText();
+    }
+}
+
+/*!
+    \brief      更新导出按钮的文字与进度.
+*/
+void QCtmLogWidget::updateExportText()
+{
+    if (!isExporting())
+    {
+        m_impl->exportAction->setText(tr("Export"));
+        m_impl->exportAction->setToolTip(tr("Export the displayed logs to file"));
+        return;
     }
+    const int percent = m_impl->exportTotal > 0 ? int(m_impl->exportWritten * 100 / m_impl->exportTotal) : 0;
+    m_impl->exportAction->setText(tr("Exporting %1%").arg(percent));
+    m_impl->exportAction->setToolTip(tr("Click to cancel the export"));
 }
 
 /*!
@@ -294,6 +426,13 @@ void QCtmLogWidget::changeEvent(QEvent* e)
 */
 void QCtmLogWidget::updateLogCount()
 {
+    if (m_impl->proxyModel->sourceModel() == m_impl->fileModel)
+    {
+        m_impl->errorAction->setText(tr("Error %1").arg(m_impl->fileModel->errorCount()));
+        m_impl->warningAction->setText(tr("Warn %1").arg(m_impl->fileModel->warningCount()));
+        m_impl->infoAction->setText(tr("Info %1").arg(m_impl->fileModel->infoCount()));
+        return;
+    }
     m_impl->errorAction->setText(tr("Error %1").arg(m_impl->model->errorCount()));
     m_impl->warningAction->setText(tr("Warn %1").arg(m_impl->model->warningCount()));
     m_impl->infoAction->setText(tr("Info %1").arg(m_impl->model->infoCount()));
@@ -306,6 +445,8 @@ void QCtmLogWidget::updateLogCount()
 void QCtmLogWidget::setInfoIcon(const QIcon& icon)
 {
     m_impl->model->setInfoIcon(icon);
+    if (m_impl->fileModel)
+        m_impl->fileModel->setInfoIcon(icon);
     m_impl->infoAction->setIcon(icon);
 }
 
@@ -325,6 +466,8 @@ const QIcon& QCtmLogWidget::infoIcon() const
 void QCtmLogWidget::setWarningIcon(const QIcon& icon)
 {
     m_impl->model->setWarningIcon(icon);
+    if (m_impl->fileModel)
+        m_impl->fileModel->setWarningIcon(icon);
     m_impl->warningAction->setIcon(icon);
 }
 
@@ -344,6 +487,8 @@ const QIcon& QCtmLogWidget::warningIcon() const
 void QCtmLogWidget::setErrorIcon(const QIcon& icon)
 {
     m_impl->model->setErrorIcon(icon);
+    if (m_impl->fileModel)
+        m_impl->fileModel->setErrorIcon(icon);
     m_impl->errorAction->setIcon(icon);
 }
 
@@ -374,6 +519,24 @@ int QCtmLogWidget::maximumCount() const
     return m_impl->model->maximumCount();
 }
 
+/*!
+    \brief      设置是否为日志建立全文索引 \a enable, 开启后查询使用索引.
+    \sa         fullTextIndexEnabled, QCtmLogModel::setFullTextIndexEnabled
+*/
+void QCtmLogWidget::setFullTextIndexEnabled(bool enable)
+{
+    m_impl->model->setFullTextIndexEnabled(enable);
+}
+
+/*!
+    \brief      返回是否为日志建立全文索引.
+    \sa         setFullTextIndexEnabled
+*/
+bool QCtmLogWidget::fullTextIndexEnabled() const
+{
+    return m_impl->model->fullTextIndexEnabled();
+}
+
 /*!
     \brief      复制当前选中日志到剪贴板.
 */
@@ -382,9 +545,11 @@ void QCtmLogWidget::copy()
     const auto& index = m_impl->logView->currentIndex();
     if (index.isValid())
     {
-        auto cb   = qApp->clipboard();
-        auto text = m_impl->model->data(m_impl->model->index(index.row(), 1), QCtmLogModel::CopyMessageRole).toString() + " " +
-                    m_impl->model->data(m_impl->model->index(index.row(), 2), QCtmLogModel::CopyMessageRole).toString();
+        const auto source = m_impl->proxyModel->mapToSource(index);
+        auto model        = source.model();
+        auto cb           = qApp->clipboard();
+        auto text         = model->index(source.row(), 1).data(QCtmAbstractLogModel::CopyMessageRole).toString() + " " +
+                            model->index(source.row(), 2).data(QCtmAbstractLogModel::CopyMessageRole).toString();
         cb->setText(text);
     }
 }
@@ -416,6 +581,106 @@ void QCtmLogWidget::search(const QString& keywords)
     }
 }
 
+/*!
+    \brief      打开日志文件 \a files 并显示其内容, 代替实时日志.
+                文件以内存映射的方式打开并在后台建立索引, 筛选与查询同样适用于文件内容.
+    \return     所有文件均打开成功返回 true.
+    \sa         closeLogFiles, QCtmLogFileModel
+*/
+bool QCtmLogWidget::openLogFiles(const QStringList& files)
+{
+    cancelExport();
+    if (!m_impl->fileModel)
+    {
+        m_impl->fileModel = new QCtmLogFileModel(this);
+        m_impl->fileModel->setInfoIcon(m_impl->model->infoIcon());
+        m_impl->fileModel->setWarningIcon(m_impl->model->warningIcon());
+        m_impl->fileModel->setErrorIcon(m_impl->model->errorIcon());
+        connect(m_impl->fileModel, &QAbstractItemModel::rowsInserted, this, &QCtmLogWidget::updateLogCount);
+        connect(m_impl->fileModel, &QAbstractItemModel::modelReset, this, &QCtmLogWidget::updateLogCount);
+    }
+    m_impl->fileModel->setLogPattern(QCtmLogManager::instance().logPattern());
+    const auto ok = m_impl->fileModel->setFiles(files);
+    if (m_impl->proxyModel->sourceModel() != m_impl->fileModel)
+    {
+        m_impl->proxyModel->setSourceModel(m_impl->fileModel);
+        m_impl->logView->horizontalHeader()->reset();
+    }
+    updateLogCount();
+    return ok;
+}
+
+/*!
+    \brief      关闭打开的日志文件, 恢复显示实时日志.
+    \sa         openLogFiles
+*/
+void QCtmLogWidget::closeLogFiles()
+{
+    if (!m_impl->fileModel)
+        return;
+    cancelExport();
+    m_impl->proxyModel->setSourceModel(m_impl->model);
+    m_impl->logView->horizontalHeader()->reset();
+    delete m_impl->fileModel;
+    m_impl->fileModel = nullptr;
+    updateLogCount();
+}
+
+/*!
+    \brief      只显示时间在 \a from 与 \a to 之间的日志.
+    \sa         clearTimeRange
+*/
+void QCtmLogWidget::setTimeRange(const QDateTime& from, const QDateTime& to)
+{
+    QSignalBlocker fromBlocker(m_impl->fromTimeEdit);
+    QSignalBlocker toBlocker(m_impl->toTimeEdit);
+    m_impl->fromTimeEdit->setDateTime(from);
+    m_impl->toTimeEdit->setDateTime(to);
+    if (m_impl->timeRangeCheck->isChecked())
+    {
+        m_impl->proxyModel->setTimeRange(from, to);
+        m_impl->logView->horizontalHeader()->reset();
+    }
+    else
+    {
+        m_impl->timeRangeCheck->setChecked(true);
+    }
+}
+
+/*!
+    \brief      取消时间范围筛选.
+    \sa         setTimeRange
+*/
+void QCtmLogWidget::clearTimeRange()
+{
+    m_impl->timeRangeCheck->setChecked(false);
+}
+
+/*!
+    \brief      滚动到时间不早于 \a time 的第一条可见日志.
+    \sa         QCtmLogModel::rowForTime
+*/
+void QCtmLogWidget::scrollToTime(const QDateTime& time)
+{
+    if (m_impl->proxyModel->sourceModel() != m_impl->model)
+        return;
+    int row = m_impl->model->rowForTime(time);
+    if (row < 0)
+        return;
+    // 目标行被筛选时沿时间增长的方向查找可见的行
+    const int step = m_impl->model->logInsertPolicy() == QCtmLogData::LogInsertPolicy::ASC ? 1 : -1;
+    for (; row >= 0 && row < m_impl->model->rowCount(); row += step)
+    {
+        const auto index = m_impl->proxyModel->mapFromSource(m_impl->model->index(row, 0));
+        if (index.isValid())
+        {
+            m_impl->logView->setCurrentIndex(index);
+            m_impl->logView->scrollTo(index, QAbstractItemView::PositionAtTop);
+            return;
+        }
+    }
+}
+
 /*!
     \brief      清除所有日志.
 */
@@ -433,3 +698,41 @@ void QCtmLogWidget::showLog(QtMsgType type, bool show)
     m_impl->proxyModel->invalidate();
     m_impl->logView->horizontalHeader()->reset();
 }
+
+/*!
+    \brief      将当前筛选后显示的日志以 \a format 格式导出到文件 \a fileName.
+                导出在后台进行, GUI 线程每次只读取一小块日志交给工作线程格式化和写入, 导出百万条日志时内存占用保持不变.
+                导出过程中新增的日志不会被导出, 被淘汰的日志将被跳过.
+    \return     导出成功开始返回 true, 已有导出在进行或文件无法打开时返回 false.
+    \sa         cancelExport, isExporting, exportProgress, exportFinished
+*/
+bool QCtmLogWidget::exportLogs(const QString& fileName, ExportFormat format /* = ExportFormat::LogLine */)
+{
+    m_impl->exporter->setLinePattern(QCtmLogManager::instance().logPattern());
+    if (!m_impl->exporter->start(m_impl->proxyModel,
+                                 fileName,
+                                 format == ExportFormat::Csv ? QCtmLogExporter::Csv : QCtmLogExporter::LogLine))
+        return false;
+    m_impl->exportWritten = 0;
+    m_impl->exportTotal   = m_impl->proxyModel->rowCount();
+    updateExportText();
+    return true;
+}
+
+/*!
+    \brief      返回是否正在导出日志.
+    \sa         exportLogs
+*/
+bool QCtmLogWidget::isExporting() const
+{
+    return m_impl->exporter->isRunning();
+}
+
+/*!
+    \brief      取消正在进行的导出, 不完整的文件将被删除.
+    \sa         exportLogs
+*/
+void QCtmLogWidget::cancelExport()
+{
+    m_impl->exporter->cancel();
+}
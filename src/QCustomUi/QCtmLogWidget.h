@@ -41,6 +41,12 @@ public:
         Description
     };
 
+    enum class ExportFormat
+    {
+        Csv,
+        LogLine
+    };
+
     explicit QCtmLogWidget(const QString& objectName, QWidget* parent = nullptr);
     ~QCtmLogWidget();
 
@@ -56,17 +62,31 @@ public:
     const QIcon& errorIcon() const;
     void setMaximumCount(int count);
     int maximumCount() const;
+    void setFullTextIndexEnabled(bool enable);
+    bool fullTextIndexEnabled() const;
+    bool openLogFiles(const QStringList& files);
+    void closeLogFiles();
+    void setTimeRange(const QDateTime& from, const QDateTime& to);
+    void clearTimeRange();
+    void scrollToTime(const QDateTime& time);
+    bool exportLogs(const QString& fileName, ExportFormat format = ExportFormat::LogLine);
+    bool isExporting() const;
 public slots:
     void copy();
     void search(const QString& keywords);
     void clear();
     void showLog(QtMsgType type, bool show);
+    void cancelExport();
+signals:
+    void exportProgress(qint64 written, qint64 total);
+    void exportFinished(bool success);
 
 private:
     void init();
     void changeEvent(QEvent* e) override;
 private slots:
     void updateLogCount();
+    void updateExportText();
 
 private:
     struct Impl;
@@ -35,6 +35,8 @@ struct QCtmMultiPageButtonBox::Impl
     QPushButton* prev { nullptr };
     QPushButton* next { nullptr };
     QHBoxLayout* pageButtonLayout { nullptr };
+    QLabel* more { nullptr };
+    QLabel* separator { nullptr };
     QLabel* total { nullptr };
     QSpinBox* currentPage { nullptr };
     QButtonGroup* pageButtonGroup { nullptr };
@@ -129,10 +131,12 @@ void QCtmMultiPageButtonBox::init()
     layout->addStretch(1);
     layout->addWidget(m_impl->prev = new QPushButton("<", this));
     layout->addLayout(m_impl->pageButtonLayout = new QHBoxLayout);
+    layout->addWidget(m_impl->more = new QLabel(QString(QChar(0x2026)), this)); // 页面总数未知时表示后续页面
+    m_impl->more->hide();
     layout->addWidget(m_impl->next = new QPushButton(">", this));
     layout->addWidget(m_impl->currentPage = new QSpinBox(this));
     m_impl->currentPage->setRange(0, 0);
-    layout->addWidget(new QLabel("/"));
+    layout->addWidget(m_impl->separator = new QLabel("/"));
     layout->addWidget(m_impl->total = new QLabel("0"));
     m_impl->pageButtonGroup = new QButtonGroup(this);
     m_impl->pageButtonGroup->setExclusive(true);
@@ -180,6 +184,9 @@ void QCtmMultiPageButtonBox::onPageCountChanged()
     {
         m_impl->currentPage->setRange(0, 0);
         m_impl->total->setText("0");
+        m_impl->more->hide();
+        m_impl->separator->show();
+        m_impl->total->show();
         auto btns = m_impl->pageButtonGroup->buttons();
         for (auto btn : btns)
         {
@@ -218,6 +225,11 @@ void QCtmMultiPageButtonBox::onPageCountChanged()
 
     m_impl->currentPage->setRange(m_impl->model->pageCount() ? 1 : 0, m_impl->model->pageCount());
     m_impl->total->setText(QString::number(m_impl->model->pageCount()));
+    // 总数未知时只显示已发现的页面, 不显示总数
+    const bool known = m_impl->model->isPageCountKnown();
+    m_impl->more->setVisible(!known);
+    m_impl->separator->setVisible(known);
+    m_impl->total->setVisible(known);
 }
 
 void QCtmMultiPageButtonBox::onCurrentPageChanged()
@@ -0,0 +1,421 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#include "QCtmMultiPageFileLineModel.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+// 每隔 Stride 行记录一次起始位置, 定位任意行最多向后查找 Stride - 1 个换行
+constexpr int Stride            = 64;
+constexpr int PostIntervalMsecs = 100;
+
+// 由检查点 checkpoints 定位第 line 行的起始位置, end 为已索引的位置
+qint64 findLineStart(const char* data, qint64 end, const std::vector<qint64>& checkpoints, int line)
+{
+    auto pos = checkpoints[line / Stride];
+    for (int i = line % Stride; i > 0; i--)
+    {
+        auto next = static_cast<const char*>(std::memchr(data + pos, '\n', static_cast<size_t>(end - pos)));
+        pos       = next - data + 1;
+    }
+    return pos;
+}
+
+// 从 pos 开始解码 count 行, 去掉行尾的 "\r\n" 或 "\n", 返回下一行的起始位置
+template<typename Output>
+qint64 decodeLines(const char* data, qint64 end, qint64 pos, int count, Output&& output)
+{
+    for (int i = 0; i < count && pos < end; i++)
+    {
+        auto next       = static_cast<const char*>(std::memchr(data + pos, '\n', static_cast<size_t>(end - pos)));
+        const auto stop = next ? next - data : end;
+        auto length     = stop - pos;
+        if (length > 0 && data[pos + length - 1] == '\r')
+            length--;
+        output(QString::fromUtf8(data + pos, static_cast<int>(length)));
+        pos = stop + 1;
+    }
+    return pos;
+}
+} // namespace
+
+struct QCtmMultiPageFileLineModel::Impl
+{
+    std::shared_ptr<QFile> file; // 后台排序期间由读取函数共同持有映射
+    const char* data { nullptr };
+    qint64 size { 0 };
+    qint64 indexedEnd { 0 };
+    std::vector<qint64> checkpoints; // 第 i * Stride 行的起始位置
+    int lines { 0 };
+
+    QThread* indexer { nullptr };
+    std::atomic_bool cancel { false };
+    quint64 generation { 0 };
+    bool indexing { false };
+
+    // 仅解码当前页
+    mutable int decodedPage { -1 };
+    mutable int decodedRows { 0 };
+    mutable QStringList decoded;
+
+    inline qint64 lineStart(int line) const { return findLineStart(data, indexedEnd, checkpoints, line); }
+
+    inline void decode(qint64 pos, int count, QStringList& out) const
+    {
+        decodeLines(data, indexedEnd, pos, count, [&out](QString&& line) { out << std::move(line); });
+    }
+};
+
+/*!
+    \class      QCtmMultiPageFileLineModel
+    \brief      分页文本文件 Model, 每行作为一条数据, 可以代替 QCtmMultiPageStringListModel 与 QCtmMultiPageButtonBox 配合使用.
+                文件以内存映射的方式打开, 后台线程建立稀疏的行索引 (每 64 行记录一次位置), 只解码当前页的行,
+                内存占用与文件大小基本无关, 适用于数 GB 的 CSV 导出或设备日志. 文件按 UTF-8 解码.
+    \inherits   QCtmAbstractMultiPageTableModel
+    \ingroup    QCustomUi
+    \inmodule   QCustomUi
+    \inheaderfile QCtmMultiPageFileLineModel.h
+    \sa         QCtmMultiPageStringListModel
+*/
+
+/*!
+    \fn         void QCtmMultiPageFileLineModel::indexingProgress(qint64 indexed, qint64 total)
+    \brief      索引进度变化时发送该信号, \a indexed 为已索引的字节数, \a total 为文件总字节数.
+*/
+
+/*!
+    \fn         void QCtmMultiPageFileLineModel::indexingFinished()
+    \brief      索引完成时发送该信号.
+*/
+
+/*!
+    \brief      构造函数 \a parent.
+*/
+QCtmMultiPageFileLineModel::QCtmMultiPageFileLineModel(QObject* parent /* = nullptr */)
+    : QCtmAbstractMultiPageTableModel(parent), m_impl(std::make_unique<Impl>())
+{
+    connect(this, &QCtmMultiPageFileLineModel::modelReset, this, [this] { m_impl->decodedPage = -1; }); // 排序、筛选结果改变
+}
+
+/*!
+    \brief      构造函数, 打开文件 \a fileName, \a parent.
+*/
+QCtmMultiPageFileLineModel::QCtmMultiPageFileLineModel(const QString& fileName, QObject* parent /* = nullptr */)
+    : QCtmMultiPageFileLineModel(parent)
+{
+    setFileName(fileName);
+}
+
+/*!
+    \brief      析构函数.
+*/
+QCtmMultiPageFileLineModel::~QCtmMultiPageFileLineModel()
+{
+    stopIndexing();
+}
+
+/*!
+    \brief      打开文件 \a fileName, 空字符串表示关闭当前文件. 行数随后台索引逐步增加.
+    \return     文件打开并映射成功返回 true.
+    \sa         fileName, indexingFinished
+*/
+bool QCtmMultiPageFileLineModel::setFileName(const QString& fileName)
+{
+    stopIndexing();
+    beginResetModel();
+    m_impl->file.reset();
+    m_impl->data       = nullptr;
+    m_impl->size       = 0;
+    m_impl->indexedEnd = 0;
+    m_impl->lines      = 0;
+    m_impl->checkpoints.clear();
+    m_impl->decodedPage = -1;
+    m_impl->decoded.clear();
+    bool ok = fileName.isEmpty();
+    if (!ok)
+    {
+        auto file = std::make_unique<QFile>(fileName);
+        if (file->open(QFile::ReadOnly))
+        {
+            m_impl->size = file->size();
+            m_impl->data = m_impl->size > 0 ? reinterpret_cast<const char*>(file->map(0, m_impl->size)) : nullptr;
+            ok           = m_impl->size == 0 || m_impl->data;
+            if (ok)
+                m_impl->file = std::move(file);
+            else
+                m_impl->size = 0;
+        }
+    }
+    endResetModel();
+    startIndexing();
+    return ok;
+}
+
+/*!
+    \brief      返回打开的文件名.
+    \sa         setFileName
+*/
+QString QCtmMultiPageFileLineModel::fileName() const
+{
+    return m_impl->file ? m_impl->file->fileName() : QString();
+}
+
+/*!
+    \brief      返回是否正在建立索引.
+    \sa         indexingProgress, indexingFinished
+*/
+bool QCtmMultiPageFileLineModel::isIndexing() const
+{
+    return m_impl->indexing;
+}
+
+/*!
+    \brief      返回已索引的行数.
+*/
+int QCtmMultiPageFileLineModel::lineCount() const
+{
+    return m_impl->lines;
+}
+
+/*!
+    \brief      返回第 \a index 行的内容, 超出已索引的范围时返回空字符串.
+*/
+QString QCtmMultiPageFileLineModel::line(int index) const
+{
+    if (index < 0 || index >= m_impl->lines)
+        return {};
+    QStringList out;
+    m_impl->decode(m_impl->lineStart(index), 1, out);
+    return out.value(0);
+}
+
+/*!
+    \reimp
+*/
+int QCtmMultiPageFileLineModel::rowCount(const QModelIndex& parent /* = QModelIndex() */) const
+{
+    if (parent.isValid())
+        return 0;
+    return std::clamp(visibleRowCount() - offset(), 0, pageRowCount());
+}
+
+/*!
+    \reimp
+*/
+int QCtmMultiPageFileLineModel::columnCount(const QModelIndex& parent /* = QModelIndex() */) const
+{
+    return parent.isValid() ? 0 : 1;
+}
+
+/*!
+    \reimp
+*/
+QVariant QCtmMultiPageFileLineModel::data(const QModelIndex& index, int role /* = Qt::DisplayRole */) const
+{
+    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::EditRole))
+        return {};
+    const auto rows = rowCount();
+    if (index.row() >= rows)
+        return {};
+    if (m_impl->decodedPage != currentPage() || m_impl->decodedRows != rows)
+    {
+        m_impl->decoded.clear();
+        m_impl->decoded.reserve(rows);
+        if (isSortFiltered())
+        {
+            for (int i = 0; i < rows; i++)
+                m_impl->decoded.push_back(line(mapToDataRow(i)));
+        }
+        else
+        {
+            m_impl->decode(m_impl->lineStart(offset()), rows, m_impl->decoded);
+        }
+        m_impl->decodedPage = currentPage();
+        m_impl->decodedRows = rows;
+    }
+    return m_impl->decoded.value(index.row());
+}
+
+/*!
+    \reimp
+*/
+int QCtmMultiPageFileLineModel::pageCount() const
+{
+    const auto rows = visibleRowCount();
+    return rows / pageRowCount() + static_cast<bool>(rows % pageRowCount());
+}
+
+/*!
+    \reimp
+*/
+void QCtmMultiPageFileLineModel::setCurrentPage(int page)
+{
+    m_impl->decodedPage = -1;
+    QCtmAbstractMultiPageTableModel::setCurrentPage(page);
+}
+
+/*!
+    \reimp
+*/
+void QCtmMultiPageFileLineModel::setPageRowCount(int rowCount)
+{
+    m_impl->decodedPage = -1;
+    QCtmAbstractMultiPageTableModel::setPageRowCount(rowCount);
+}
+
+/*!
+    \brief      在后台线程中查找换行符建立稀疏行索引, 按时间间隔分批追加到 model 中.
+*/
+void QCtmMultiPageFileLineModel::startIndexing()
+{
+    if (!m_impl->data)
+        return;
+    const auto generation = ++m_impl->generation;
+    m_impl->indexing      = true;
+    m_impl->indexer       = QThread::create(
+        [this, generation, data = m_impl->data, size = m_impl->size]
+        {
+            std::vector<qint64> checkpoints;
+            int lines      = 0; // 本批新增的行数
+            int totalLines = 0;
+            qint64 pos     = 0;
+            QElapsedTimer timer;
+            timer.start();
+            auto post = [&]
+            {
+                QMetaObject::invokeMethod(
+                    this,
+                    [this, generation, checkpoints = std::move(checkpoints), lines, pos]
+                    { appendIndex(generation, checkpoints, lines, pos); },
+                    Qt::QueuedConnection);
+                checkpoints = {};
+                lines       = 0;
+                timer.restart();
+            };
+            while (pos < size)
+            {
+                if (m_impl->cancel.load(std::memory_order_relaxed))
+                    return;
+                if (totalLines % Stride == 0)
+                    checkpoints.push_back(pos);
+                auto next = static_cast<const char*>(std::memchr(data + pos, '\n', static_cast<size_t>(size - pos)));
+                pos       = next ? next - data + 1 : size; // 文件末尾没有换行的行同样计入
+                lines++;
+                totalLines++;
+                if (totalLines % Stride == 0 && timer.hasExpired(PostIntervalMsecs))
+                    post();
+            }
+            post();
+            QMetaObject::invokeMethod(
+                this,
+                [this, generation]
+                {
+                    if (generation != m_impl->generation)
+                        return;
+                    m_impl->indexing = false;
+                    invalidateSortFilter(); // 排序、筛选时新索引的行需要重新计算后才显示
+                    emit indexingFinished();
+                },
+                Qt::QueuedConnection);
+        });
+    m_impl->indexer->setObjectName("QCtmFileLineIndexer");
+    m_impl->indexer->start(QThread::LowPriority);
+}
+
+/*!
+    \brief      停止后台索引.
+*/
+void QCtmMultiPageFileLineModel::stopIndexing()
+{
+    if (!m_impl->indexer)
+        return;
+    m_impl->cancel = true;
+    m_impl->indexer->wait();
+    delete m_impl->indexer;
+    m_impl->indexer  = nullptr;
+    m_impl->cancel   = false;
+    m_impl->indexing = false;
+    ++m_impl->generation; // 丢弃已投递但尚未处理的索引
+}
+
+/*!
+    \brief      追加新索引的 \a lines 行及其检查点 \a checkpoints, \a end 为已索引的位置.
+                当前页的行数增加时插入行, 页面数量改变时发送 pageCountChanged. \a generation 与当前索引不一致时忽略.
+*/
+void QCtmMultiPageFileLineModel::appendIndex(quint64 generation, const std::vector<qint64>& checkpoints, int lines, qint64 end)
+{
+    if (generation != m_impl->generation)
+        return;
+    const auto beforeRows  = rowCount();
+    const auto beforePages = pageCount();
+    const auto afterRows   = isSortFiltered() ? beforeRows : std::clamp(m_impl->lines + lines - offset(), 0, pageRowCount());
+    if (afterRows > beforeRows)
+        beginInsertRows(QModelIndex(), beforeRows, afterRows - 1);
+    m_impl->checkpoints.insert(m_impl->checkpoints.end(), checkpoints.begin(), checkpoints.end());
+    m_impl->lines += lines;
+    m_impl->indexedEnd = end;
+    if (afterRows > beforeRows)
+        endInsertRows();
+    if (pageCount() != beforePages)
+        emit pageCountChanged(pageCount());
+    emit indexingProgress(end, m_impl->size);
+}
+
+/*!
+    \reimp
+*/
+int QCtmMultiPageFileLineModel::dataRowCount() const
+{
+    return m_impl->lines;
+}
+
+/*!
+    \reimp
+*/
+QVariant QCtmMultiPageFileLineModel::dataRowValue(int dataRow, int column) const
+{
+    return column == 0 ? line(dataRow) : QVariant();
+}
+
+/*!
+    \reimp
+                返回的函数持有文件映射与当前行索引的快照, 在工作线程中直接从映射的文件中顺序解码.
+*/
+QCtmAbstractMultiPageTableModel::DataRowReader QCtmMultiPageFileLineModel::dataRowReader(int column) const
+{
+    if (column != 0)
+        return [](int, int count, QVector<QVariant>& values) { values.resize(values.size() + count); };
+    return [file = m_impl->file, data = m_impl->data, end = m_impl->indexedEnd, checkpoints = m_impl->checkpoints, lines = m_impl->lines](
+               int first, int count, QVector<QVariant>& values)
+    {
+        count = std::min(count, lines - first);
+        if (count <= 0)
+            return;
+        decodeLines(data, end, findLineStart(data, end, checkpoints, first), count, [&values](QString&& line) { values.push_back(std::move(line)); });
+    };
+}
@@ -0,0 +1,62 @@
+﻿/*********************************************************************************
+**                                                                              **
+**  Copyright (C) 2019-2025 LiLong                                              **
+**  This file is part of QCustomUi.                                             **
+**                                                                              **
+**  QCustomUi is free software: you can redistribute it and/or modify           **
+**  it under the terms of the GNU Lesser General Public License as published by **
+**  the Free Software Foundation, either version 3 of the License, or           **
+**  (at your option) any later version.                                         **
+**                                                                              **
+**  QCustomUi is distributed in the hope that it will be useful,                **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of              **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               **
+**  GNU Lesser General Public License for more details.                         **
+**                                                                              **
+**  You should have received a copy of the GNU Lesser General Public License    **
+**  along with QCustomUi.  If not, see <https://www.gnu.org/licenses/>.         **
+**********************************************************************************/
+
+#pragma once
+
+#include "QCtmAbstractMultiPageTableModel.h"
+
+#include <vector>
+
+class QCUSTOMUI_EXPORT QCtmMultiPageFileLineModel : public QCtmAbstractMultiPageTableModel
+{
+    Q_OBJECT
+public:
+    explicit QCtmMultiPageFileLineModel(QObject* parent = nullptr);
+    explicit QCtmMultiPageFileLineModel(const QString& fileName, QObject* parent = nullptr);
+    ~QCtmMultiPageFileLineModel();
+    bool setFileName(const QString& fileName);
+    QString fileName() const;
+    bool isIndexing() const;
+    int lineCount() const;
+    QString line(int index) const;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    int pageCount() const override;
+public slots:
+    void setCurrentPage(int page) override;
+    void setPageRowCount(int rowCount) override;
+signals:
+    void indexingProgress(qint64 indexed, qint64 total);
+    void indexingFinished();
+
+protected:
+    int dataRowCount() const override;
+    QVariant dataRowValue(int dataRow, int column) const override;
+    DataRowReader dataRowReader(int column) const override;
+
+private:
+    void startIndexing();
+    void stopIndexing();
+    void appendIndex(quint64 generation, const std::vector<qint64>& checkpoints, int lines, qint64 end);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
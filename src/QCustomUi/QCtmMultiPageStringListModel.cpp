@@ -72,6 +72,7 @@ void QCtmMultiPageStringListModel::setStringList(const QStringList& strings)
     beginResetModel();
     m_impl->strings = strings;
     endResetModel();
+    invalidateSortFilter();
 }
 
 /*!
@@ -84,6 +85,7 @@ void QCtmMultiPageStringListModel::setStringList(QStringList&& strings)
     beginResetModel();
     m_impl->strings = std::move(strings);
     endResetModel();
+    invalidateSortFilter();
 }
 
 /*!
@@ -97,8 +99,7 @@ const QStringList& QCtmMultiPageStringListModel::stringList() const { return m_i
 */
 int QCtmMultiPageStringListModel::rowCount(const QModelIndex& parent /* = QModelIndex() */) const
 {
-    return static_cast<int>(
-        std::min<size_t>(std::max<size_t>(m_impl->strings.size() - currentPage() * pageRowCount(), 0LL), pageRowCount()));
+    return std::clamp(visibleRowCount() - offset(), 0, pageRowCount());
 }
 
 /*!
@@ -111,7 +112,7 @@ int QCtmMultiPageStringListModel::columnCount(const QModelIndex& parent /* = QMo
 */
 QVariant QCtmMultiPageStringListModel::data(const QModelIndex& index, int role /* = Qt::DisplayRole */) const
 {
-    auto row = offset() + index.row();
+    auto row = mapToDataRow(index.row());
     if (row < 0 || row >= m_impl->strings.size())
         return {};
     if (role == Qt::DisplayRole || role == Qt::EditRole)
@@ -126,7 +127,9 @@ QVariant QCtmMultiPageStringListModel::data(const QModelIndex& index, int role /
 */
 bool QCtmMultiPageStringListModel::setData(const QModelIndex& index, const QVariant& value, int role /* = Qt::EditRole */)
 {
-    auto row = offset() + index.row();
+    auto row = mapToDataRow(index.row());
+    if (row < 0 || row >= m_impl->strings.size())
+        return false;
     if (role == Qt::EditRole)
     {
         auto string = value.toString();
@@ -144,5 +147,36 @@ bool QCtmMultiPageStringListModel::setData(const QModelIndex& index, const QVari
 */
 int QCtmMultiPageStringListModel::pageCount() const
 {
-    return m_impl->strings.size() / pageRowCount() + static_cast<bool>(m_impl->strings.size() % pageRowCount());
+    const auto rows = visibleRowCount();
+    return rows / pageRowCount() + static_cast<bool>(rows % pageRowCount());
+}
+
+/*!
+    \reimp
+*/
+int QCtmMultiPageStringListModel::dataRowCount() const { return static_cast<int>(m_impl->strings.size()); }
+
+/*!
+    \reimp
+*/
+QVariant QCtmMultiPageStringListModel::dataRowValue(int dataRow, int column) const
+{
+    if (column != 0 || dataRow < 0 || dataRow >= m_impl->strings.size())
+        return {};
+    return m_impl->strings[dataRow];
+}
+
+/*!
+    \reimp
+                返回的函数持有字符串列表的隐式共享副本.
+*/
+QCtmAbstractMultiPageTableModel::DataRowReader QCtmMultiPageStringListModel::dataRowReader(int column) const
+{
+    if (column != 0)
+        return [](int, int count, QVector<QVariant>& values) { values.resize(values.size() + count); };
+    return [strings = m_impl->strings](int first, int count, QVector<QVariant>& values)
+    {
+        for (int i = first; i < first + count && i < strings.size(); i++)
+            values.push_back(strings[i]);
+    };
 }
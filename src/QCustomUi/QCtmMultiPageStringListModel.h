@@ -37,6 +37,11 @@ public:
     bool setData(const QModelIndex& index, const QVariant& value, int role /* = Qt::EditRole */) override;
     int pageCount() const override;
 
+protected:
+    int dataRowCount() const override;
+    QVariant dataRowValue(int dataRow, int column) const override;
+    DataRowReader dataRowReader(int column) const override;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> m_impl;
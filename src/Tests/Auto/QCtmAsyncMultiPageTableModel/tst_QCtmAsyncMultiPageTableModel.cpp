@@ -0,0 +1,120 @@
+﻿#include <QCustomUi/QCtmAsyncMultiPageTableModel.h>
+#include <QCustomUi/QCtmCursorMultiPageTableModel.h>
+
+#include <QTest>
+
+#include <atomic>
+
+class tst_QCtmAsyncMultiPageTableModel : public QObject
+{
+    Q_OBJECT
+private slots:
+    void taskPlaceholderAndLoad();
+    void taskPrefetch();
+    void taskCursorDiscovery();
+};
+
+class CountingProvider : public QCtmAbstractPageProvider
+{
+public:
+    explicit CountingProvider(int rows) : m_rows(rows) {}
+    int columnCount() const override { return 2; }
+    int rowCount() override { return m_rows; }
+    QVector<Row> fetch(int offset, int count) override
+    {
+        fetches++;
+        QVector<Row> rows;
+        for (int i = offset; i < std::min(offset + count, m_rows); i++)
+            rows.push_back({ i, QString("row %1").arg(i) });
+        return rows;
+    }
+
+    std::atomic_int fetches { 0 };
+
+private:
+    int m_rows;
+};
+
+// 测试页面读取完成前显示占位行, 完成后显示数据
+void tst_QCtmAsyncMultiPageTableModel::taskPlaceholderAndLoad()
+{
+    QCtmAsyncMultiPageTableModel model;
+    model.setPrefetchEnabled(false);
+    model.setPageRowCount(10);
+    model.setProvider(std::make_shared<CountingProvider>(95));
+    QTRY_COMPARE(model.pageCount(), 10);
+    QCOMPARE(model.totalRowCount(), 95);
+    QTRY_VERIFY(model.isPageLoaded(0));
+    QCOMPARE(model.index(3, 1).data().toString(), QString("row 3"));
+
+    model.setCurrentPage(9);
+    QCOMPARE(model.rowCount(), 5);
+    if (!model.isPageLoaded(9))
+        QCOMPARE(model.index(0, 0).data().toString(), model.placeholderText());
+    QTRY_VERIFY(model.isPageLoaded(9));
+    QCOMPARE(model.index(4, 0).data().toInt(), 94);
+}
+
+// 测试切换页面时预取前后两页, 缓存的页面不再读取
+void tst_QCtmAsyncMultiPageTableModel::taskPrefetch()
+{
+    auto provider = std::make_shared<CountingProvider>(1000);
+    QCtmAsyncMultiPageTableModel model;
+    model.setPageRowCount(20);
+    model.setProvider(provider);
+    QTRY_VERIFY(model.isPageLoaded(0) && model.isPageLoaded(1));
+
+    model.setCurrentPage(1);
+    QVERIFY(model.isPageLoaded(1));
+    QCOMPARE(model.index(0, 0).data().toInt(), 20);
+    QTRY_VERIFY(model.isPageLoaded(2));
+    QCOMPARE(provider->fetches.load(), 3);
+}
+
+class KeysetProvider : public QCtmAbstractCursorPageProvider
+{
+public:
+    explicit KeysetProvider(int rows) : m_rows(rows) {}
+    int columnCount() const override { return 1; }
+    Page fetch(const QVariant& cursor, int count) override
+    {
+        Page page;
+        const int from = cursor.isValid() ? cursor.toInt() : 0;
+        for (int i = from; i < std::min(from + count, m_rows); i++)
+            page.rows.push_back({ i });
+        if (from + count < m_rows)
+            page.next = from + count;
+        return page;
+    }
+
+private:
+    int m_rows;
+};
+
+// 测试游标分页逐步发现页面数量, 读到最后一页后总数确定
+void tst_QCtmAsyncMultiPageTableModel::taskCursorDiscovery()
+{
+    QCtmCursorMultiPageTableModel model;
+    model.setPrefetchEnabled(false);
+    model.setPageRowCount(10);
+    model.setProvider(std::make_shared<KeysetProvider>(25));
+    QCOMPARE(model.pageCount(), 1);
+    QVERIFY(!model.isPageCountKnown());
+
+    QTRY_COMPARE(model.pageCount(), 2);
+    QCOMPARE(model.rowCount(), 10);
+    QVERIFY(!model.isPageCountKnown());
+
+    model.next();
+    QTRY_COMPARE(model.pageCount(), 3);
+    QCOMPARE(model.index(0, 0).data().toInt(), 10);
+    model.next();
+    QTRY_VERIFY(model.isPageCountKnown());
+    QCOMPARE(model.pageCount(), 3);
+    QCOMPARE(model.rowCount(), 5);
+    QCOMPARE(model.index(4, 0).data().toInt(), 24);
+}
+
+QTEST_MAIN(tst_QCtmAsyncMultiPageTableModel)
+
+#include "tst_QCtmAsyncMultiPageTableModel.moc"
@@ -0,0 +1,169 @@
+﻿#include <QCustomUi/Private/QCtmLogArchiver_p.h>
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTest>
+
+class tst_QCtmLogArchiver : public QObject
+{
+    Q_OBJECT
+private slots:
+    void taskRoundTrip();
+    void taskRejectCorrupt();
+    void taskFileName();
+    void taskCompress();
+    void taskRetentionCount();
+    void taskRetentionSize();
+    void taskRetentionDays();
+};
+
+static QString writeFile(const QTemporaryDir& dir, const QString& name, const QByteArray& content)
+{
+    const auto fileName = QFileInfo(dir.filePath(name)).absoluteFilePath();
+    QFile file(fileName);
+    file.open(QFile::WriteOnly);
+    file.write(content);
+    return fileName;
+}
+
+static QByteArray readFile(const QString& fileName)
+{
+    QFile file(fileName);
+    file.open(QFile::ReadOnly);
+    return file.readAll();
+}
+
+// 测试压缩后解压得到原始内容, 超过单块大小的文件分块写入
+void tst_QCtmLogArchiver::taskRoundTrip()
+{
+    QTemporaryDir dir;
+    QByteArray content;
+    for (int i = 0; content.size() < 3 * 1024 * 1024; ++i)
+        content += "[2024-01-02 03:04:05:006] [Info] line " + QByteArray::number(i) + "\n";
+    const auto source = writeFile(dir, "a.log", content);
+    const auto target = dir.filePath("a.log.qz");
+    QVERIFY(QCtmLogArchiver::compressFile(source, target));
+    QVERIFY(readFile(target).startsWith("QCLZ"));
+    QVERIFY(QFileInfo(target).size() < content.size());
+    QVERIFY(QCtmLogArchiver::decompressFile(target, dir.filePath("b.log")));
+    QCOMPARE(readFile(dir.filePath("b.log")), content);
+
+    std::atomic_bool cancel { true };
+    QVERIFY(!QCtmLogArchiver::compressFile(source, dir.filePath("c.log.qz"), &cancel));
+}
+
+// 测试非压缩文件或截断的压缩文件解压失败
+void tst_QCtmLogArchiver::taskRejectCorrupt()
+{
+    QTemporaryDir dir;
+    const auto plain = writeFile(dir, "a.log", "hello\n");
+    QVERIFY(!QCtmLogArchiver::decompressFile(plain, dir.filePath("b.log")));
+
+    const auto target = dir.filePath("a.log.qz");
+    QVERIFY(QCtmLogArchiver::compressFile(plain, target));
+    const auto data = readFile(target);
+    const auto truncated = writeFile(dir, "c.log.qz", data.left(data.size() - 1));
+    QVERIFY(!QCtmLogArchiver::decompressFile(truncated, dir.filePath("c.log")));
+}
+
+static QString logName(int second) { return QString("2024-01-01 00.00.%1.log").arg(second, 2, 10, QLatin1Char('0')); }
+
+// 测试日志管理器的命名规则
+void tst_QCtmLogArchiver::taskFileName()
+{
+    QVERIFY(QCtmLogArchiver::isLogFileName("2024-01-02 03.04.05.log"));
+    QVERIFY(QCtmLogArchiver::isLogFileName("2024-01-02 03.04.05.006.log"));
+    QVERIFY(QCtmLogArchiver::isLogFileName("2024-01-02 03.04.05.006.log.qz"));
+    QVERIFY(!QCtmLogArchiver::isLogFileName("other.log"));
+    QVERIFY(!QCtmLogArchiver::isLogFileName("2024-01-02 03.04.05.log.part"));
+    QVERIFY(!QCtmLogArchiver::isLogFileName("x2024-01-02 03.04.05.log"));
+}
+
+// 测试压缩目录中之前运行时留下的日志文件, 当前写入的文件与不符合命名规则的文件保持不变
+void tst_QCtmLogArchiver::taskCompress()
+{
+    QTemporaryDir dir;
+    const auto other    = writeFile(dir, "other.log", "other\n");
+    const auto previous = writeFile(dir, logName(1), "previous\n");
+    const auto active   = writeFile(dir, logName(2), "active\n");
+
+    QCtmLogArchiver archiver;
+    archiver.setCompressionEnabled(true);
+    archiver.schedule(active);
+    QTRY_VERIFY(QFile::exists(previous + QCtmLogArchiver::Suffix) && !QFile::exists(previous));
+    archiver.stop();
+
+    QCOMPARE(readFile(active), QByteArray("active\n"));
+    QCOMPARE(readFile(other), QByteArray("other\n"));
+    QVERIFY(!QFile::exists(active + QCtmLogArchiver::Suffix));
+    QVERIFY(!QFile::exists(other + QCtmLogArchiver::Suffix));
+    QVERIFY(QCtmLogArchiver::decompressFile(previous + QCtmLogArchiver::Suffix, dir.filePath("1.out")));
+    QCOMPARE(readFile(dir.filePath("1.out")), QByteArray("previous\n"));
+}
+
+// 测试按文件数量清理, 压缩文件与未压缩文件一同计数, 当前写入的文件计入数量但不会被删除
+void tst_QCtmLogArchiver::taskRetentionCount()
+{
+    QTemporaryDir dir;
+    const auto other = writeFile(dir, "other.log", "other\n");
+    QStringList files;
+    for (int i = 0; i < 3; ++i)
+        files << writeFile(dir, logName(i), "data\n");
+    QVERIFY(QCtmLogArchiver::compressFile(files[2], files[2] + QCtmLogArchiver::Suffix));
+    QVERIFY(QFile::remove(files[2]));
+    files[2] += QCtmLogArchiver::Suffix;
+    files << writeFile(dir, logName(3), "data\n");
+
+    QCtmLogArchiver archiver;
+    archiver.setRetention({ 2, 0, 0 });
+    archiver.schedule(files[3]);
+    QTRY_VERIFY(!QFile::exists(files[0]) && !QFile::exists(files[1]));
+    archiver.stop();
+    QVERIFY(QFile::exists(files[2]));
+    QVERIFY(QFile::exists(files[3]));
+    QVERIFY(QFile::exists(other));
+}
+
+// 测试按总大小清理, 由新到旧累计
+void tst_QCtmLogArchiver::taskRetentionSize()
+{
+    QTemporaryDir dir;
+    QStringList files;
+    for (int i = 0; i < 4; ++i)
+        files << writeFile(dir, logName(i), QByteArray(100, 'x'));
+
+    QCtmLogArchiver archiver;
+    archiver.setRetention({ 0, 250, 0 });
+    archiver.schedule(files[3]);
+    QTRY_VERIFY(!QFile::exists(files[0]) && !QFile::exists(files[1]));
+    archiver.stop();
+    QVERIFY(QFile::exists(files[2]));
+    QVERIFY(QFile::exists(files[3]));
+}
+
+// 测试按修改时间清理过期文件
+void tst_QCtmLogArchiver::taskRetentionDays()
+{
+    QTemporaryDir dir;
+    const auto old    = writeFile(dir, logName(1), "old\n");
+    const auto recent = writeFile(dir, logName(2), "recent\n");
+    const auto active = writeFile(dir, logName(3), "active\n");
+    {
+        QFile file(old);
+        QVERIFY(file.open(QFile::Append));
+        QVERIFY(file.setFileTime(QDateTime::currentDateTime().addDays(-5), QFileDevice::FileModificationTime));
+    }
+
+    QCtmLogArchiver archiver;
+    archiver.setRetention({ 0, 0, 2 });
+    archiver.schedule(active);
+    QTRY_VERIFY(!QFile::exists(old));
+    archiver.stop();
+    QVERIFY(QFile::exists(recent));
+    QVERIFY(QFile::exists(active));
+}
+
+QTEST_MAIN(tst_QCtmLogArchiver)
+
+#include "tst_QCtmLogArchiver.moc"
@@ -0,0 +1,165 @@
+﻿#include <QCustomUi/Private/QCtmLogExporter_p.h>
+#include <QCustomUi/QCtmLogData.h>
+#include <QCustomUi/QCtmLogFileModel.h>
+#include <QCustomUi/QCtmLogModel.h>
+
+#include <QDateTime>
+#include <QSignalSpy>
+#include <QSortFilterProxyModel>
+#include <QTemporaryDir>
+#include <QTest>
+
+class tst_QCtmLogExporter : public QObject
+{
+    Q_OBJECT
+private slots:
+    void taskCsv();
+    void taskLogLine();
+    void taskCancel();
+    void taskCancelOnReset();
+};
+
+static const qint64 BaseMsecs = QDateTime(QDate(2024, 1, 2), QTime(3, 4, 5, 6)).toMSecsSinceEpoch();
+
+static QVector<QCtmLogDataPtr> makeLogs(const QStringList& messages)
+{
+    QVector<QCtmLogDataPtr> logs;
+    for (int i = 0; i < messages.size(); ++i)
+    {
+        logs.push_back(std::make_shared<QCtmLogData>(QtMsgType::QtWarningMsg, 0, messages[i], BaseMsecs + i));
+    }
+    return logs;
+}
+
+static QByteArray timeText(int i)
+{
+    return QDateTime::fromMSecsSinceEpoch(BaseMsecs + i).toString("yyyy-MM-dd hh:mm:ss.zzz").toUtf8();
+}
+
+static QByteArray readFile(const QString& fileName)
+{
+    QFile file(fileName);
+    file.open(QFile::ReadOnly);
+    return file.readAll();
+}
+
+// 测试 CSV 只导出筛选结果, 包含分隔符、引号或换行的字段加引号并转义引号
+void tst_QCtmLogExporter::taskCsv()
+{
+    QCtmLogModel model("tst_QCtmLogExporter");
+    model.onLogBatch(makeLogs({ "plain", "skip", "a,b", "say \"hi\"", "two\nlines", QString::fromUtf8("\xe4\xb8\xad\xe6\x96\x87") }));
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    proxy.setFilterKeyColumn(2);
+    proxy.setFilterRegularExpression(QRegularExpression("^(?!skip)"));
+    QCOMPARE(proxy.rowCount(), 5);
+
+    QTemporaryDir dir;
+    const auto fileName = dir.filePath("a.csv");
+    QCtmLogExporter exporter;
+    QSignalSpy finished(&exporter, &QCtmLogExporter::finished);
+    QVERIFY(exporter.start(&proxy, fileName, QCtmLogExporter::Csv));
+    QVERIFY(exporter.isRunning());
+    QVERIFY(!exporter.start(&proxy, dir.filePath("b.csv"), QCtmLogExporter::Csv));
+    QVERIFY(finished.wait(5000));
+    QCOMPARE(finished.first().first().toBool(), true);
+    QVERIFY(!exporter.isRunning());
+
+    const QByteArray expected = "Time,Level,Message\n" + timeText(0) + ",Warn,plain\n" + timeText(2) + ",Warn,\"a,b\"\n" + timeText(3) +
+                                ",Warn,\"say \"\"hi\"\"\"\n" + timeText(4) + ",Warn,\"two\nlines\"\n" + timeText(5) +
+                                ",Warn,\xe4\xb8\xad\xe6\x96\x87\n";
+    QCOMPARE(readFile(fileName), expected);
+}
+
+// 测试按日志行格式导出, 导出的文件可由 QCtmLogFileModel 重新打开
+void tst_QCtmLogExporter::taskLogLine()
+{
+    QCtmLogModel model("tst_QCtmLogExporter");
+    model.onLogBatch(makeLogs({ "[first]", "second" }));
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+
+    QTemporaryDir dir;
+    const auto fileName = dir.filePath("a.log");
+    QCtmLogExporter exporter;
+    QSignalSpy finished(&exporter, &QCtmLogExporter::finished);
+    QSignalSpy progress(&exporter, &QCtmLogExporter::progress);
+    QVERIFY(exporter.start(&proxy, fileName, QCtmLogExporter::LogLine));
+    QVERIFY(finished.wait(5000));
+    QCOMPARE(finished.first().first().toBool(), true);
+    QVERIFY(!progress.isEmpty());
+    QCOMPARE(progress.last().at(0).toLongLong(), 2ll);
+    QCOMPARE(progress.last().at(1).toLongLong(), 2ll);
+
+    QByteArray expected;
+    expected += "[" + timeText(0).replace('.', ':') + "] [Warn] [:0] [first]\n";
+    expected += "[" + timeText(1).replace('.', ':') + "] [Warn] [:0] second\n";
+    QCOMPARE(readFile(fileName), expected);
+
+    QCtmLogFileModel fileModel;
+    QSignalSpy indexed(&fileModel, &QCtmLogFileModel::indexingFinished);
+    QVERIFY(fileModel.setFiles({ fileName }));
+    QVERIFY(indexed.wait());
+    QCOMPARE(fileModel.rowCount(), 2);
+    QCOMPARE(fileModel.messageAt(0), QString("[first]"));
+    QCOMPARE(fileModel.messageAt(1), QString("second"));
+
+    QVERIFY(!exporter.setLinePattern("{msg"));
+    QVERIFY(exporter.setLinePattern("{level}|{msg}"));
+    QVERIFY(exporter.start(&proxy, fileName, QCtmLogExporter::LogLine));
+    QVERIFY(finished.wait(5000));
+    QCOMPARE(readFile(fileName), QByteArray("Warn|[first]\nWarn|second\n"));
+}
+
+// 测试取消导出时报告失败并删除不完整的文件
+void tst_QCtmLogExporter::taskCancel()
+{
+    QCtmLogModel model("tst_QCtmLogExporter");
+    model.setMaximumCount(50000);
+    QStringList messages;
+    for (int i = 0; i < 50000; ++i)
+        messages << QString::number(i);
+    model.onLogBatch(makeLogs(messages));
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+
+    QTemporaryDir dir;
+    const auto fileName = dir.filePath("a.log");
+    QCtmLogExporter exporter;
+    QSignalSpy finished(&exporter, &QCtmLogExporter::finished);
+    QVERIFY(exporter.start(&proxy, fileName, QCtmLogExporter::LogLine));
+    exporter.cancel();
+    QVERIFY(finished.wait(5000));
+    QCOMPARE(finished.first().first().toBool(), false);
+    QVERIFY(!exporter.isRunning());
+    QVERIFY(!QFile::exists(fileName));
+
+    // 取消后可以重新开始
+    QVERIFY(exporter.start(&proxy, fileName, QCtmLogExporter::LogLine));
+    QVERIFY(finished.wait(10000));
+    QCOMPARE(finished.last().first().toBool(), true);
+    QVERIFY(QFile::exists(fileName));
+}
+
+// 测试源 model 重置时取消导出
+void tst_QCtmLogExporter::taskCancelOnReset()
+{
+    QCtmLogModel model("tst_QCtmLogExporter");
+    model.onLogBatch(makeLogs({ "first", "second" }));
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+
+    QTemporaryDir dir;
+    const auto fileName = dir.filePath("a.log");
+    QCtmLogExporter exporter;
+    QSignalSpy finished(&exporter, &QCtmLogExporter::finished);
+    QVERIFY(exporter.start(&proxy, fileName, QCtmLogExporter::LogLine));
+    model.clear();
+    QVERIFY(finished.wait(5000));
+    QCOMPARE(finished.first().first().toBool(), false);
+    QVERIFY(!QFile::exists(fileName));
+}
+
+QTEST_MAIN(tst_QCtmLogExporter)
+
+#include "tst_QCtmLogExporter.moc"
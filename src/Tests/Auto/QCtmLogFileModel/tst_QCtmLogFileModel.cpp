@@ -0,0 +1,125 @@
+﻿#include <QCustomUi/Private/QCtmLogArchiver_p.h>
+#include <QCustomUi/QCtmLogFileModel.h>
+
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+class tst_QCtmLogFileModel : public QObject
+{
+    Q_OBJECT
+private slots:
+    void taskIndexRecords();
+    void taskMultipleFiles();
+    void taskLogPattern();
+    void taskCompressedFile();
+};
+
+static QString writeFile(const QTemporaryDir& dir, const QString& name, const QByteArray& content)
+{
+    const auto fileName = dir.filePath(name);
+    QFile file(fileName);
+    file.open(QFile::WriteOnly);
+    file.write(content);
+    return fileName;
+}
+
+static QString message(const QCtmLogFileModel& model, int row)
+{
+    return model.data(model.index(row, 2), QCtmLogFileModel::CopyMessageRole).toString();
+}
+
+// 测试按记录建立索引, 多行消息属于同一条记录
+void tst_QCtmLogFileModel::taskIndexRecords()
+{
+    QTemporaryDir dir;
+    const auto file = writeFile(dir,
+                                "a.log",
+                                "[2024-01-02 03:04:05:006] [Info] [main.cpp:10] hello\n"
+                                "[2024-01-02 03:04:06:007] [Warn] [main.cpp:11] first line\n"
+                                "second line\n"
+                                "[2024-01-02 03:04:07:008] [Error] [src/a]b.cpp:12] \xe4\xb8\xad\xe6\x96\x87\n");
+    QCtmLogFileModel model;
+    QSignalSpy finished(&model, &QCtmLogFileModel::indexingFinished);
+    QVERIFY(model.setFiles({ file }));
+    QVERIFY(finished.wait());
+    QCOMPARE(model.rowCount(), 3);
+    QCOMPARE(model.infoCount(), 1);
+    QCOMPARE(model.warningCount(), 1);
+    QCOMPARE(model.errorCount(), 1);
+    QCOMPARE(model.data(model.index(1, 0), QCtmLogFileModel::TypeRole).toInt(), int(QtMsgType::QtWarningMsg));
+    QCOMPARE(model.data(model.index(0, 1)).toString(), QString("2024-01-02 03:04:05"));
+    QCOMPARE(message(model, 0), QString("hello"));
+    QCOMPARE(message(model, 1), QString("first line\nsecond line"));
+    QCOMPARE(message(model, 2), QString::fromUtf8("\xe4\xb8\xad\xe6\x96\x87"));
+}
+
+// 测试多个文件按顺序连续显示
+void tst_QCtmLogFileModel::taskMultipleFiles()
+{
+    QTemporaryDir dir;
+    QByteArray first, second;
+    for (int i = 0; i < 100; ++i)
+    {
+        first += "[2024-01-01 00:00:00:000] [Info] [a.cpp:1] " + QByteArray::number(i) + "\n";
+        second += "[2024-01-02 00:00:00:000] [Error] [b.cpp:2] " + QByteArray::number(100 + i) + "\n";
+    }
+    QCtmLogFileModel model;
+    QSignalSpy finished(&model, &QCtmLogFileModel::indexingFinished);
+    QVERIFY(model.setFiles({ writeFile(dir, "a.log", first), writeFile(dir, "b.log", second) }));
+    QVERIFY(finished.wait());
+    QCOMPARE(model.rowCount(), 200);
+    QCOMPARE(message(model, 99), QString("99"));
+    QCOMPARE(message(model, 100), QString("100"));
+    QCOMPARE(message(model, 199), QString("199"));
+    QCOMPARE(model.errorCount(), 100);
+
+    model.clear();
+    QCOMPARE(model.rowCount(), 0);
+}
+
+// 测试按自定义的行格式识别记录
+void tst_QCtmLogFileModel::taskLogPattern()
+{
+    QTemporaryDir dir;
+    const auto file = writeFile(dir,
+                                "a.log",
+                                "03:04:05.006 Warn f(a|b)| hello\n"
+                                "continued\n"
+                                "03:04:06.007 Error g| [bracket]\n");
+    QCtmLogFileModel model;
+    QVERIFY(!model.setLogPattern("{file} {msg}"));
+    QVERIFY(!model.setLogPattern("{msg} [{level}]"));
+    QVERIFY(!model.setLogPattern("[{level}] {file}{line} {msg}"));
+    QVERIFY(model.setLogPattern("{time:%T.%e} {level} {function}| {msg}"));
+    QCOMPARE(model.logPattern(), QString("{time:%T.%e} {level} {function}| {msg}"));
+
+    QSignalSpy finished(&model, &QCtmLogFileModel::indexingFinished);
+    QVERIFY(model.setFiles({ file }));
+    QVERIFY(finished.wait());
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(model.warningCount(), 1);
+    QCOMPARE(model.errorCount(), 1);
+    QCOMPARE(model.data(model.index(0, 1)).toString(), QString("03:04:05"));
+    QCOMPARE(message(model, 0), QString("hello\ncontinued"));
+    QCOMPARE(message(model, 1), QString("[bracket]"));
+}
+
+// 测试压缩的日志文件在后台解压后显示
+void tst_QCtmLogFileModel::taskCompressedFile()
+{
+    QTemporaryDir dir;
+    const auto file = writeFile(dir, "a.log", "[2024-01-02 03:04:05:006] [Info] [main.cpp:10] hello\n");
+    QVERIFY(QCtmLogArchiver::compressFile(file, file + QCtmLogArchiver::Suffix));
+
+    QCtmLogFileModel model;
+    QSignalSpy finished(&model, &QCtmLogFileModel::indexingFinished);
+    QVERIFY(model.setFiles({ file + QCtmLogArchiver::Suffix }));
+    QVERIFY(finished.wait());
+    QCOMPARE(model.rowCount(), 1);
+    QCOMPARE(message(model, 0), QString("hello"));
+}
+
+QTEST_MAIN(tst_QCtmLogFileModel)
+
+#include "tst_QCtmLogFileModel.moc"
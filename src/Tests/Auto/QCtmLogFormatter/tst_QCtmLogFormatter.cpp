@@ -0,0 +1,91 @@
+﻿#include <QCustomUi/QCtmLogData.h>
+#include <QCustomUi/Private/QCtmLogFormatter_p.h>
+
+#include <QDateTime>
+#include <QTest>
+
+class tst_QCtmLogFormatter : public QObject
+{
+    Q_OBJECT
+private slots:
+    void taskFields();
+    void taskEscape();
+    void taskInvalidPattern();
+    void taskRepeat();
+    void taskMillisecondPatch();
+};
+
+static QByteArray format(QCtmLogFormatter& formatter, const QCtmLogData& data)
+{
+    QByteArray out;
+    formatter.format(data, out);
+    return out;
+}
+
+// 测试各字段输出, 模式末尾自动追加换行
+void tst_QCtmLogFormatter::taskFields()
+{
+    QMessageLogContext context("a.cpp", 12, "void f()", "net");
+    const auto location = QCtmLogData::internLocation(context);
+    QCtmLogData data(QtWarningMsg, location, QString::fromUtf8("\xe4\xb8\xad\xe6\x96\x87"), 0);
+
+    QCtmLogFormatter formatter;
+    QVERIFY(formatter.setPattern("{level}|{file}|{line}|{function}|{category}|{msg}"));
+    QCOMPARE(format(formatter, data), QByteArray("Warn|a.cpp|12|void f()|net|\xe4\xb8\xad\xe6\x96\x87\n"));
+
+    const QtMsgType types[] = { QtDebugMsg, QtInfoMsg, QtWarningMsg, QtCriticalMsg, QtFatalMsg };
+    const char* names[]     = { "Debug\n", "Info\n", "Warn\n", "Error\n", "Abort\n" };
+    QVERIFY(formatter.setPattern("{level}"));
+    for (int i = 0; i < 5; ++i)
+        QCOMPARE(format(formatter, QCtmLogData(types[i], location, QString(), 0)), QByteArray(names[i]));
+}
+
+// 测试 {{ 与 }} 转义为花括号字面量
+void tst_QCtmLogFormatter::taskEscape()
+{
+    QCtmLogData data(QtInfoMsg, 0, "x", 0);
+    QCtmLogFormatter formatter;
+    QVERIFY(formatter.setPattern("{{{msg}}} {{level}}"));
+    QCOMPARE(format(formatter, data), QByteArray("{x} {level}\n"));
+}
+
+// 测试非法模式返回 false 且保留原模式
+void tst_QCtmLogFormatter::taskInvalidPattern()
+{
+    QCtmLogData data(QtInfoMsg, 0, "x", 0);
+    QCtmLogFormatter formatter;
+    QVERIFY(formatter.setPattern("<{msg}>"));
+    QVERIFY(!formatter.setPattern("{msg"));
+    QVERIFY(!formatter.setPattern("{unknown}"));
+    QCOMPARE(formatter.pattern(), QString("<{msg}>"));
+    QCOMPARE(format(formatter, data), QByteArray("<x>\n"));
+}
+
+// 测试 {repeat} 仅在重复次数大于 1 时输出
+void tst_QCtmLogFormatter::taskRepeat()
+{
+    QCtmLogData data(QtInfoMsg, 0, "x", 0);
+    QCtmLogFormatter formatter;
+    QVERIFY(formatter.setPattern("{msg}{repeat}"));
+    QCOMPARE(format(formatter, data), QByteArray("x\n"));
+    data.setRepeatCount(3);
+    QCOMPARE(format(formatter, data), QByteArray("x \xc3\x97" "3\n"));
+}
+
+// 测试按秒缓存的时间文本在跨秒时刷新, 毫秒按条修补
+void tst_QCtmLogFormatter::taskMillisecondPatch()
+{
+    QCtmLogFormatter formatter;
+    QVERIFY(formatter.setPattern("{time:%F %T.%e}"));
+    const auto base = QDateTime(QDate(2024, 1, 2), QTime(3, 4, 5)).toMSecsSinceEpoch();
+    for (auto msecs : { base + 1, base + 999, base + 1000, base + 1005, base + 7, base + 61000 })
+    {
+        QCtmLogData data(QtInfoMsg, 0, QString(), msecs);
+        const auto expected = QDateTime::fromMSecsSinceEpoch(msecs).toString("yyyy-MM-dd hh:mm:ss.zzz").toUtf8() + '\n';
+        QCOMPARE(format(formatter, data), expected);
+    }
+}
+
+QTEST_MAIN(tst_QCtmLogFormatter)
+
+#include "tst_QCtmLogFormatter.moc"
@@ -0,0 +1,418 @@
+﻿#include <QCustomUi/QCtmLogData.h>
+#include <QCustomUi/QCtmLogManager.h>
+#include <QCustomUi/QCtmLogMemorySink.h>
+
+#include <QDir>
+#include <QLoggingCategory>
+#include <QProcess>
+#include <QSemaphore>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QThread>
+
+#include <csignal>
+
+class tst_QCtmLogManager : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void taskMessageTypeGate();
+    void taskCategoryGate();
+    void taskGateSnapshot();
+    void taskDropNewest();
+    void taskDropLowestLevel();
+    void taskBlock();
+    void taskFlushThreshold();
+    void taskFlushInterval();
+    void taskFlushAsync();
+    void taskFatalDrain();
+    void taskCrashHandler();
+
+private:
+    QStringList messages() const;
+    QByteArray logText() const;
+    static bool runChild(const QString& function, const QString& logPath);
+
+private:
+    QTemporaryDir m_dir;
+    std::shared_ptr<QCtmLogMemorySink> m_sink;
+};
+
+namespace
+{
+std::atomic_bool stallArmed { false };
+std::atomic_bool stalling { false };
+QSemaphore stalled;
+QSemaphore resumed;
+} // namespace
+
+// 日志管理器转发的日志不再输出到测试日志, 写线程分发到 "stall" 时阻塞, 使之后的日志停留在异步队列中
+static void testMessageHandler(QtMsgType, const QMessageLogContext&, const QString& msg)
+{
+    if (msg == QLatin1String("stall") && stallArmed.exchange(false))
+    {
+        stalling = true;
+        stalled.release();
+        resumed.acquire();
+        stalling = false;
+    }
+}
+
+void tst_QCtmLogManager::initTestCase()
+{
+    qInstallMessageHandler(&testMessageHandler);
+    QCtmLogManager::initBeforeApp();
+    auto& manager = QCtmLogManager::instance();
+    manager.setLogFilePath(m_dir.path());
+    manager.setAsyncQueueCapacity(64);
+}
+
+void tst_QCtmLogManager::init()
+{
+    m_sink = std::make_shared<QCtmLogMemorySink>();
+    QCtmLogManager::instance().addSink(m_sink);
+}
+
+void tst_QCtmLogManager::cleanup()
+{
+    if (stalling)
+        resumed.release();
+    QCtmLogManager::instance().setAsyncEnabled(false);
+    QCtmLogManager::instance().removeSink(m_sink);
+    m_sink.reset();
+}
+
+QStringList tst_QCtmLogManager::messages() const
+{
+    QStringList list;
+    for (const auto& log : m_sink->logs())
+        list << log->msg();
+    return list;
+}
+
+static QByteArray readLogs(const QString& path)
+{
+    QByteArray text;
+    for (const auto& info : QDir(path).entryInfoList({ "*.log" }, QDir::Files, QDir::Name))
+    {
+        QFile file(info.absoluteFilePath());
+        if (file.open(QFile::ReadOnly))
+            text += file.readAll();
+    }
+    return text;
+}
+
+QByteArray tst_QCtmLogManager::logText() const { return readLogs(m_dir.path()); }
+
+// 以子进程运行测试函数, 子进程将日志写入 logPath 后异常退出
+bool tst_QCtmLogManager::runChild(const QString& function, const QString& logPath)
+{
+    auto env = QProcessEnvironment::systemEnvironment();
+    env.insert("TST_QCTMLOGMANAGER_CHILD", logPath);
+    env.insert("QTEST_DISABLE_STACK_DUMP", "1");
+    env.insert("QTEST_DISABLE_CORE_DUMP", "1");
+    QProcess process;
+    process.setProcessEnvironment(env);
+    process.start(QCoreApplication::applicationFilePath(), { function });
+    if (!process.waitForFinished(30000))
+        return false;
+    return process.exitStatus() == QProcess::CrashExit || process.exitCode() != 0;
+}
+
+// 测试关闭的日志类型在入口处丢弃, Fatal 不能关闭
+void tst_QCtmLogManager::taskMessageTypeGate()
+{
+    auto& manager = QCtmLogManager::instance();
+    manager.setMessageTypeEnabled(QtDebugMsg, false);
+    manager.setMessageTypeEnabled(QtFatalMsg, false);
+    QVERIFY(!manager.messageTypeEnabled(QtDebugMsg));
+    QVERIFY(manager.messageTypeEnabled(QtInfoMsg));
+    QVERIFY(manager.messageTypeEnabled(QtFatalMsg));
+
+    qDebug("gate-debug");
+    qInfo("gate-info");
+    qWarning("gate-end");
+    QTRY_VERIFY(messages().contains("gate-end"));
+    QCOMPARE(messages(), QStringList({ "gate-info", "gate-end" }));
+
+    manager.setMessageTypeEnabled(QtDebugMsg, true);
+    QVERIFY(manager.messageTypeEnabled(QtDebugMsg));
+    qDebug("gate-debug");
+    QTRY_VERIFY(messages().contains("gate-debug"));
+}
+
+// 测试按分类关闭指定类型, 其他分类与类型不受影响
+void tst_QCtmLogManager::taskCategoryGate()
+{
+    auto& manager = QCtmLogManager::instance();
+    QLoggingCategory category("tst.gate");
+    manager.setCategoryEnabled("tst.gate", QtWarningMsg, false);
+    QVERIFY(!manager.categoryEnabled("tst.gate", QtWarningMsg));
+    QVERIFY(manager.categoryEnabled("tst.gate", QtCriticalMsg));
+    QVERIFY(manager.categoryEnabled("default", QtWarningMsg));
+
+    qCWarning(category, "category-warning");
+    qCCritical(category, "category-critical");
+    qWarning("category-end");
+    QTRY_VERIFY(messages().contains("category-end"));
+    QCOMPARE(messages(), QStringList({ "category-critical", "category-end" }));
+
+    // 类型开关先于分类开关生效
+    manager.setCategoryEnabled("tst.gate", QtWarningMsg, true);
+    manager.setMessageTypeEnabled(QtWarningMsg, false);
+    QVERIFY(!manager.categoryEnabled("tst.gate", QtWarningMsg));
+    manager.setMessageTypeEnabled(QtWarningMsg, true);
+    QVERIFY(manager.categoryEnabled("tst.gate", QtWarningMsg));
+}
+
+// 测试其他线程写日志时切换开关, 读取中的旧快照保持有效
+void tst_QCtmLogManager::taskGateSnapshot()
+{
+    auto& manager = QCtmLogManager::instance();
+    std::atomic_bool stop { false };
+    auto producer = QThread::create(
+        [&]
+        {
+            while (!stop.load())
+                qDebug("snapshot");
+        });
+    producer->start();
+    for (int i = 0; i < 200; ++i)
+    {
+        manager.setMessageTypeEnabled(QtDebugMsg, i % 2 == 0);
+        manager.setCategoryEnabled("tst.snapshot", QtDebugMsg, i % 3 == 0);
+    }
+    stop = true;
+    producer->wait();
+    delete producer;
+
+    manager.setMessageTypeEnabled(QtDebugMsg, true);
+    manager.setCategoryEnabled("tst.snapshot", QtDebugMsg, true);
+    QVERIFY(manager.messageTypeEnabled(QtDebugMsg));
+    qDebug("snapshot-end");
+    QTRY_VERIFY(messages().contains("snapshot-end"));
+}
+
+// 测试队列已满时丢弃新到达的日志
+void tst_QCtmLogManager::taskDropNewest()
+{
+    auto& manager = QCtmLogManager::instance();
+    manager.setAsyncOverflowPolicy(QCtmLogManager::DropNewest);
+    manager.setAsyncEnabled(true);
+    const auto dropped = manager.droppedCount(QtDebugMsg);
+    stallArmed = true;
+    qDebug("stall");
+    QVERIFY(stalled.tryAcquire(1, 5000));
+
+    for (int i = 0; i < 100; ++i)
+        qDebug("%d", i);
+    QCOMPARE(manager.asyncQueueDepth(), 64);
+    QCOMPARE(manager.droppedCount(QtDebugMsg) - dropped, quint64(36));
+
+    resumed.release();
+    manager.flush();
+    QTRY_COMPARE(m_sink->size(), 65);
+    const auto list = messages();
+    QCOMPARE(list.first(), QString("stall"));
+    QCOMPARE(list.last(), QString("63"));
+}
+
+// 测试按等级分配队列比例: Debug 1/2, Info 5/8, Warning 3/4, Critical 全部
+void tst_QCtmLogManager::taskDropLowestLevel()
+{
+    auto& manager = QCtmLogManager::instance();
+    manager.setAsyncOverflowPolicy(QCtmLogManager::DropLowestLevel);
+    manager.setAsyncEnabled(true);
+    const QtMsgType types[] = { QtDebugMsg, QtInfoMsg, QtWarningMsg, QtCriticalMsg };
+    quint64 dropped[4];
+    for (int i = 0; i < 4; ++i)
+        dropped[i] = manager.droppedCount(types[i]);
+    stallArmed = true;
+    qDebug("stall");
+    QVERIFY(stalled.tryAcquire(1, 5000));
+
+    for (int i = 0; i < 64; ++i)
+        qDebug("debug");
+    for (int i = 0; i < 64; ++i)
+        qInfo("info");
+    for (int i = 0; i < 64; ++i)
+        qWarning("warning");
+    for (int i = 0; i < 64; ++i)
+        qCritical("critical");
+    QCOMPARE(manager.asyncQueueDepth(), 64);
+    QCOMPARE(manager.droppedCount(QtDebugMsg) - dropped[0], quint64(32));
+    QCOMPARE(manager.droppedCount(QtInfoMsg) - dropped[1], quint64(56));
+    QCOMPARE(manager.droppedCount(QtWarningMsg) - dropped[2], quint64(56));
+    QCOMPARE(manager.droppedCount(QtCriticalMsg) - dropped[3], quint64(48));
+
+    resumed.release();
+    manager.flush();
+    QTRY_COMPARE(m_sink->size(), 65);
+    const auto list = messages();
+    QCOMPARE(int(list.count(QString("debug"))), 32);
+    QCOMPARE(int(list.count(QString("info"))), 8);
+    QCOMPARE(int(list.count(QString("warning"))), 8);
+    QCOMPARE(int(list.count(QString("critical"))), 16);
+}
+
+// 测试队列已满时阻塞生产线程, 不丢失日志
+void tst_QCtmLogManager::taskBlock()
+{
+    auto& manager = QCtmLogManager::instance();
+    manager.setAsyncOverflowPolicy(QCtmLogManager::Block);
+    manager.setAsyncEnabled(true);
+    const auto dropped = manager.droppedCount();
+    stallArmed = true;
+    qDebug("stall");
+    QVERIFY(stalled.tryAcquire(1, 5000));
+
+    for (int i = 0; i < 64; ++i)
+        qDebug("%d", i);
+    QCOMPARE(manager.asyncQueueDepth(), 64);
+    auto producer = QThread::create([] { qDebug("blocked"); });
+    producer->start();
+    QVERIFY(!producer->wait(200));
+
+    resumed.release();
+    QVERIFY(producer->wait(5000));
+    delete producer;
+    manager.flush();
+    QTRY_COMPARE(m_sink->size(), 66);
+    QCOMPARE(messages().last(), QString("blocked"));
+    QCOMPARE(manager.droppedCount(), dropped);
+}
+
+// 测试日志缓冲到阈值后写入文件, Critical 日志立即写入
+void tst_QCtmLogManager::taskFlushThreshold()
+{
+    auto& manager = QCtmLogManager::instance();
+    manager.setFlushInterval(60000);
+    manager.setFlushThreshold(1024 * 1024);
+    manager.flush();
+
+    qInfo("flush-buffered");
+    QVERIFY(!logText().contains("flush-buffered"));
+    manager.flush();
+    QVERIFY(logText().contains("flush-buffered"));
+
+    manager.setFlushThreshold(256);
+    qInfo("flush-threshold %s", QByteArray(300, 'x').constData());
+    QVERIFY(logText().contains("flush-threshold"));
+
+    manager.setFlushThreshold(1024 * 1024);
+    qCritical("flush-critical");
+    QVERIFY(logText().contains("flush-critical"));
+
+    manager.setFlushThreshold(64 * 1024);
+    manager.setFlushInterval(1000);
+}
+
+// 测试同步模式下超过刷新间隔后的下一条日志写出缓冲区
+void tst_QCtmLogManager::taskFlushInterval()
+{
+    auto& manager = QCtmLogManager::instance();
+    manager.setFlushThreshold(1024 * 1024);
+    manager.setFlushInterval(60000);
+    manager.flush();
+
+    qInfo("interval-first");
+    QVERIFY(!logText().contains("interval-first"));
+    manager.setFlushInterval(50);
+    QTest::qWait(100);
+    qInfo("interval-second");
+    const auto text = logText();
+    QVERIFY(text.contains("interval-first"));
+    QVERIFY(text.contains("interval-second"));
+
+    // 异步模式下写线程空闲时按间隔刷新
+    manager.setAsyncEnabled(true);
+    qInfo("interval-async");
+    QTRY_VERIFY(logText().contains("interval-async"));
+
+    manager.setFlushThreshold(64 * 1024);
+    manager.setFlushInterval(1000);
+}
+
+// 测试异步模式下 flush 等待写线程处理完队列中已有的日志
+void tst_QCtmLogManager::taskFlushAsync()
+{
+    auto& manager = QCtmLogManager::instance();
+    manager.setAsyncOverflowPolicy(QCtmLogManager::Block);
+    manager.setFlushThreshold(1024 * 1024);
+    manager.setFlushInterval(60000);
+    manager.setAsyncEnabled(true);
+
+    for (int i = 0; i < 200; ++i)
+        qInfo("async-%d", i);
+    manager.flush();
+    const auto text = logText();
+    QVERIFY(text.contains("async-0\n"));
+    QVERIFY(text.contains("async-199\n"));
+    QCOMPARE(manager.asyncQueueDepth(), 0);
+
+    manager.setFlushThreshold(64 * 1024);
+    manager.setFlushInterval(1000);
+}
+
+// 测试 Fatal 日志同步写出异步队列与缓冲区中的全部日志
+void tst_QCtmLogManager::taskFatalDrain()
+{
+#ifdef Q_OS_UNIX
+    if (qEnvironmentVariableIsSet("TST_QCTMLOGMANAGER_CHILD"))
+    {
+        auto& manager = QCtmLogManager::instance();
+        manager.setLogFilePath(qEnvironmentVariable("TST_QCTMLOGMANAGER_CHILD"));
+        manager.setFlushThreshold(1024 * 1024);
+        manager.setFlushInterval(60000);
+        manager.setAsyncOverflowPolicy(QCtmLogManager::Block);
+        manager.setAsyncEnabled(true);
+        for (int i = 0; i < 200; ++i)
+            qInfo("fatal-%d", i);
+        qFatal("fatal-end");
+        return;
+    }
+    QTemporaryDir dir;
+    QVERIFY(runChild("taskFatalDrain", dir.path()));
+    const auto text = readLogs(dir.path());
+    QVERIFY(text.contains("fatal-0\n"));
+    QVERIFY(text.contains("fatal-199\n"));
+    QVERIFY(text.contains("[Abort]"));
+    QVERIFY(text.indexOf("fatal-199\n") < text.indexOf("fatal-end"));
+#else
+    QSKIP("Requires a Unix platform");
+#endif
+}
+
+// 测试崩溃信号处理函数写出已格式化但尚未写入文件的日志
+void tst_QCtmLogManager::taskCrashHandler()
+{
+#ifdef Q_OS_UNIX
+    if (qEnvironmentVariableIsSet("TST_QCTMLOGMANAGER_CHILD"))
+    {
+        auto& manager = QCtmLogManager::instance();
+        manager.setLogFilePath(qEnvironmentVariable("TST_QCTMLOGMANAGER_CHILD"));
+        manager.setFlushThreshold(1024 * 1024);
+        manager.setFlushInterval(60000);
+        manager.setCrashHandlerEnabled(true);
+        qInfo("crash-first");
+        qInfo("crash-second");
+        std::raise(SIGSEGV);
+        return;
+    }
+    QTemporaryDir dir;
+    QVERIFY(runChild("taskCrashHandler", dir.path()));
+    const auto text = readLogs(dir.path());
+    QVERIFY(text.contains("crash-first\n"));
+    QVERIFY(text.contains("crash-second\n"));
+    QVERIFY(text.contains("[crash] signal " + QByteArray::number(SIGSEGV) + "\n"));
+#else
+    QSKIP("Requires a Unix platform");
+#endif
+}
+
+QTEST_MAIN(tst_QCtmLogManager)
+
+#include "tst_QCtmLogManager.moc"
@@ -0,0 +1,166 @@
+﻿#include <QCustomUi/QCtmLogData.h>
+#include <QCustomUi/QCtmLogModel.h>
+
+#include <QSignalSpy>
+#include <QTest>
+
+class tst_QCtmLogModel : public QObject
+{
+    Q_OBJECT
+private slots:
+    void taskBatchInsert();
+    void taskBatchEvict();
+    void taskDescInsert();
+    void taskSetMaximumCount();
+    void taskSwitchInsertPolicy();
+    void taskFullTextIndex();
+    void taskRowForTime();
+};
+
+static QVector<QCtmLogDataPtr> makeLogs(int count, int start = 0, QtMsgType type = QtMsgType::QtInfoMsg)
+{
+    QVector<QCtmLogDataPtr> logs;
+    QMessageLogContext context;
+    for (int i = 0; i < count; ++i)
+    {
+        logs.push_back(std::make_shared<QCtmLogData>(type, context, QString::number(start + i)));
+    }
+    return logs;
+}
+
+static QString message(const QCtmLogModel& model, int row) { return model.data(model.index(row, 2), Qt::DisplayRole).toString(); }
+
+// 测试整批插入只发送一次插入信号
+void tst_QCtmLogModel::taskBatchInsert()
+{
+    QCtmLogModel model("tst_QCtmLogModel");
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+    model.onLogBatch(makeLogs(100));
+    QCOMPARE(inserted.count(), 1);
+    QCOMPARE(model.rowCount(), 100);
+    QCOMPARE(model.infoCount(), 100);
+    QCOMPARE(message(model, 0), QString("0"));
+    QCOMPARE(message(model, 99), QString("99"));
+}
+
+// 测试超出最大数量时整批移除最旧的日志
+void tst_QCtmLogModel::taskBatchEvict()
+{
+    QCtmLogModel model("tst_QCtmLogModel");
+    model.setMaximumCount(10);
+    model.onLogBatch(makeLogs(8));
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+    model.onLogBatch(makeLogs(5, 8, QtMsgType::QtWarningMsg));
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(model.rowCount(), 10);
+    QCOMPARE(message(model, 0), QString("3"));
+    QCOMPARE(message(model, 9), QString("12"));
+    QCOMPARE(model.infoCount(), 5);
+    QCOMPARE(model.warningCount(), 5);
+
+    model.onLogBatch(makeLogs(25, 100));
+    QCOMPARE(model.rowCount(), 10);
+    QCOMPARE(message(model, 0), QString("115"));
+    QCOMPARE(model.infoCount(), 10);
+    QCOMPARE(model.warningCount(), 0);
+}
+
+// 测试逆序插入时最新日志位于首行
+void tst_QCtmLogModel::taskDescInsert()
+{
+    QCtmLogModel model("tst_QCtmLogModel");
+    model.setMaximumCount(4);
+    model.setLogInsertPolicy(QCtmLogData::LogInsertPolicy::DESC);
+    model.onLogBatch(makeLogs(3));
+    QCOMPARE(message(model, 0), QString("2"));
+    QCOMPARE(message(model, 2), QString("0"));
+    model.onLogBatch(makeLogs(2, 3));
+    QCOMPARE(model.rowCount(), 4);
+    QCOMPARE(message(model, 0), QString("4"));
+    QCOMPARE(message(model, 3), QString("1"));
+}
+
+// 测试缩小最大数量时整体移除最旧的日志
+void tst_QCtmLogModel::taskSetMaximumCount()
+{
+    QCtmLogModel model("tst_QCtmLogModel");
+    model.onLogBatch(makeLogs(10));
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+    model.setMaximumCount(4);
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(model.rowCount(), 4);
+    QCOMPARE(model.infoCount(), 4);
+    QCOMPARE(message(model, 0), QString("6"));
+    model.onLogBatch(makeLogs(3, 10));
+    QCOMPARE(model.rowCount(), 4);
+    QCOMPARE(message(model, 0), QString("9"));
+    QCOMPARE(message(model, 3), QString("12"));
+}
+
+// 测试切换插入策略后行顺序反转
+void tst_QCtmLogModel::taskSwitchInsertPolicy()
+{
+    QCtmLogModel model("tst_QCtmLogModel");
+    model.onLogBatch(makeLogs(5));
+    model.setLogInsertPolicy(QCtmLogData::LogInsertPolicy::DESC);
+    QCOMPARE(message(model, 0), QString("4"));
+    QCOMPARE(message(model, 4), QString("0"));
+}
+
+// 测试全文索引随插入与移除维护, 并与逐行比较的结果一致
+void tst_QCtmLogModel::taskFullTextIndex()
+{
+    QCtmLogModel model("tst_QCtmLogModel");
+    model.setMaximumCount(100);
+    model.onLogBatch(makeLogs(50));
+    model.setFullTextIndexEnabled(true);
+    QVERIFY(model.fullTextIndexMemoryUsage() > 0);
+    model.onLogBatch(makeLogs(80, 50));
+    QCOMPARE(model.rowCount(), 100);
+    QCOMPARE(model.findRows("12").size(), 11);             // 关键字过短, 逐行比较
+    QCOMPARE(model.findRows("112"), QVector<int>({ 82 })); // 使用索引
+    QCOMPARE(model.findRows("11 12"), QVector<int>({ 82 }));
+    QCOMPARE(model.findRows("105 7"), QVector<int>({}));
+    QCOMPARE(model.findRows("129"), QVector<int>({ 99 }));
+    QCOMPARE(model.findRows("10").size(), 11);
+
+    model.setLogInsertPolicy(QCtmLogData::LogInsertPolicy::DESC);
+    QCOMPARE(model.findRows("112"), QVector<int>({ 17 }));
+    model.setMaximumCount(10);
+    QCOMPARE(model.findRows("112"), QVector<int>({}));
+    QCOMPARE(model.findRows("125"), QVector<int>({ 4 }));
+
+    model.setFullTextIndexEnabled(false);
+    QCOMPARE(model.fullTextIndexMemoryUsage(), 0);
+    QCOMPARE(model.findRows("125"), QVector<int>({ 4 }));
+}
+
+// 测试按时间定位行, 逆序插入时行号反转
+void tst_QCtmLogModel::taskRowForTime()
+{
+    QCtmLogModel model("tst_QCtmLogModel");
+    const qint64 base = QDateTime(QDate(2024, 1, 1), QTime(12, 0)).toMSecsSinceEpoch();
+    QVector<QCtmLogDataPtr> logs;
+    for (int i = 0; i < 10; ++i)
+    {
+        logs.push_back(QCtmLogData::create(QtMsgType::QtInfoMsg, 0, QString::number(i), base + i * 1000));
+    }
+    QCOMPARE(model.rowForTime(QDateTime::fromMSecsSinceEpoch(base)), -1);
+    model.onLogBatch(logs);
+    auto time = [&](qint64 msecs) { return QDateTime::fromMSecsSinceEpoch(base + msecs); };
+    QCOMPARE(model.rowForTime(time(-5000)), 0);
+    QCOMPARE(model.rowForTime(time(3000)), 3);
+    QCOMPARE(model.rowForTime(time(3500)), 4);
+    QCOMPARE(model.rowForTime(time(60000)), 9);
+    QCOMPARE(model.rowsForTimeRange(time(2000), time(4500)), qMakePair(2, 4));
+    QCOMPARE(model.rowsForTimeRange(time(20000), time(30000)), qMakePair(-1, -1));
+
+    model.setLogInsertPolicy(QCtmLogData::LogInsertPolicy::DESC);
+    QCOMPARE(model.rowForTime(time(3000)), 6);
+    QCOMPARE(message(model, 6), QString("3"));
+    QCOMPARE(model.rowsForTimeRange(time(2000), time(4500)), qMakePair(5, 7));
+}
+
+QTEST_MAIN(tst_QCtmLogModel)
+
+#include "tst_QCtmLogModel.moc"
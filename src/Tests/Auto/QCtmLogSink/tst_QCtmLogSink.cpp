@@ -0,0 +1,65 @@
+﻿#include <QCustomUi/QCtmLogData.h>
+#include <QCustomUi/QCtmLogMemorySink.h>
+#include <QCustomUi/QCtmLogModel.h>
+#include <QCustomUi/QCtmLogSocketReceiver.h>
+#include <QCustomUi/QCtmLogSocketSink.h>
+
+#include <QTest>
+
+class tst_QCtmLogSink : public QObject
+{
+    Q_OBJECT
+private slots:
+    void taskMemorySink();
+    void taskSocketRoundTrip();
+};
+
+static QVector<QCtmLogDataPtr> makeLogs(int count, int start = 0)
+{
+    QVector<QCtmLogDataPtr> logs;
+    QMessageLogContext context("tst_QCtmLogSink.cpp", 10, "makeLogs", "default");
+    for (int i = 0; i < count; ++i)
+    {
+        logs.push_back(std::make_shared<QCtmLogData>(QtMsgType::QtWarningMsg, context, QString::number(start + i)));
+    }
+    return logs;
+}
+
+// 测试内存输出目标只保留最近的日志
+void tst_QCtmLogSink::taskMemorySink()
+{
+    QCtmLogMemorySink sink(10);
+    sink.write(makeLogs(8));
+    sink.write(makeLogs(5, 8));
+    const auto logs = sink.logs();
+    QCOMPARE(logs.size(), 10);
+    QCOMPARE(logs.first()->msg(), QString("3"));
+    QCOMPARE(logs.last()->msg(), QString("12"));
+}
+
+// 测试日志经本地套接字传输后插入 model, 并保留等级、上下文与来源
+void tst_QCtmLogSink::taskSocketRoundTrip()
+{
+    const auto serverName = QString("tst_QCtmLogSink_%1").arg(QCoreApplication::applicationPid());
+    QCtmLogModel model("tst_QCtmLogSink");
+    QCtmLogSocketReceiver receiver;
+    receiver.setModel(&model);
+    QVERIFY2(receiver.listen(serverName), qPrintable(receiver.errorString()));
+    QString source;
+    connect(&receiver, &QCtmLogSocketReceiver::logsReceived, this, [&](const QString& s) { source = s; });
+
+    QCtmLogSocketSink sink(serverName);
+    sink.setSourceName("station1");
+    sink.write(makeLogs(3));
+    QVERIFY(sink.isConnected());
+    QTRY_COMPARE(model.rowCount(), 3);
+    QCOMPARE(source, QString("station1"));
+    QCOMPARE(model.data(model.index(2, 2), Qt::DisplayRole).toString(), QString("[station1] 2"));
+    QCOMPARE(model.data(model.index(2, 0), QCtmAbstractLogModel::TypeRole).toInt(), int(QtMsgType::QtWarningMsg));
+    QCOMPARE(sink.droppedCount(), 0ull);
+    sink.close();
+}
+
+QTEST_MAIN(tst_QCtmLogSink)
+
+#include "tst_QCtmLogSink.moc"
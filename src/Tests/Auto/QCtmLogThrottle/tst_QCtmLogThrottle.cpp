@@ -0,0 +1,136 @@
+﻿#include <QCustomUi/Private/QCtmLogThrottle_p.h>
+
+#include <QTest>
+
+class tst_QCtmLogThrottle : public QObject
+{
+    Q_OBJECT
+private slots:
+    void taskDisabled();
+    void taskDeduplicate();
+    void taskDeduplicateKey();
+    void taskCollectAll();
+    void taskRateLimit();
+    void taskFatal();
+};
+
+// 测试未设置窗口与速率时不启用
+void tst_QCtmLogThrottle::taskDisabled()
+{
+    QCtmLogThrottle throttle;
+    QVERIFY(!throttle.enabled());
+    throttle.setWindow(100);
+    QVERIFY(throttle.enabled());
+    throttle.setWindow(0);
+    QVERIFY(!throttle.enabled());
+    throttle.setRate(10);
+    QVERIFY(throttle.enabled());
+}
+
+// 测试窗口内重复日志被抑制, 窗口结束后输出带重复次数与最后时间的摘要
+void tst_QCtmLogThrottle::taskDeduplicate()
+{
+    QCtmLogThrottle throttle;
+    throttle.setWindow(100);
+    std::vector<QCtmLogThrottle::Summary> summaries;
+    QVERIFY(throttle.admit(QtWarningMsg, 1, "a", 1000, summaries));
+    QVERIFY(!throttle.admit(QtWarningMsg, 1, "a", 1010, summaries));
+    QVERIFY(!throttle.admit(QtWarningMsg, 1, "a", 1050, summaries));
+    QCOMPARE(throttle.suppressedCount(), 2ull);
+
+    throttle.collect(1099, summaries);
+    QVERIFY(summaries.empty());
+    throttle.collect(1100, summaries);
+    QCOMPARE(summaries.size(), size_t(1));
+    QCOMPARE(summaries[0].type, QtWarningMsg);
+    QCOMPARE(summaries[0].location, 1u);
+    QCOMPARE(summaries[0].msg, QString("a"));
+    QCOMPARE(summaries[0].msecs, 1050ll);
+    QCOMPARE(summaries[0].repeat, 2u);
+
+    // 收集后状态已清理, 同一日志再次放行
+    summaries.clear();
+    QVERIFY(throttle.admit(QtWarningMsg, 1, "a", 1200, summaries));
+    QVERIFY(summaries.empty());
+
+    // 窗口过期后的同一日志放行, 并输出上一窗口的摘要
+    QVERIFY(!throttle.admit(QtWarningMsg, 1, "a", 1210, summaries));
+    QVERIFY(throttle.admit(QtWarningMsg, 1, "a", 1300, summaries));
+    QCOMPARE(summaries.size(), size_t(1));
+    QCOMPARE(summaries[0].msecs, 1210ll);
+    QCOMPARE(summaries[0].repeat, 1u);
+}
+
+// 测试等级, 位置或内容不同的日志分别计数
+void tst_QCtmLogThrottle::taskDeduplicateKey()
+{
+    QCtmLogThrottle throttle;
+    throttle.setWindow(100);
+    std::vector<QCtmLogThrottle::Summary> summaries;
+    QVERIFY(throttle.admit(QtWarningMsg, 1, "a", 0, summaries));
+    QVERIFY(throttle.admit(QtCriticalMsg, 1, "a", 0, summaries));
+    QVERIFY(throttle.admit(QtWarningMsg, 2, "a", 0, summaries));
+    QVERIFY(throttle.admit(QtWarningMsg, 1, "b", 0, summaries));
+    QVERIFY(!throttle.admit(QtWarningMsg, 1, "b", 1, summaries));
+    QCOMPARE(throttle.suppressedCount(), 1ull);
+}
+
+// 测试 all 为 true 时窗口未结束的摘要也输出
+void tst_QCtmLogThrottle::taskCollectAll()
+{
+    QCtmLogThrottle throttle;
+    throttle.setWindow(1000);
+    std::vector<QCtmLogThrottle::Summary> summaries;
+    QVERIFY(throttle.admit(QtInfoMsg, 3, "a", 0, summaries));
+    QVERIFY(!throttle.admit(QtInfoMsg, 3, "a", 1, summaries));
+    throttle.collect(2, summaries);
+    QVERIFY(summaries.empty());
+    throttle.collect(2, summaries, true);
+    QCOMPARE(summaries.size(), size_t(1));
+    QCOMPARE(summaries[0].repeat, 1u);
+}
+
+// 测试令牌桶: 初始为突发数量, 按速率回填且不超过突发数量
+void tst_QCtmLogThrottle::taskRateLimit()
+{
+    QCtmLogThrottle throttle;
+    throttle.setRate(10);
+    throttle.setBurst(3);
+    std::vector<QCtmLogThrottle::Summary> summaries;
+    for (int i = 0; i < 3; ++i)
+        QVERIFY(throttle.admit(QtInfoMsg, 1, QString::number(i), 0, summaries));
+    QVERIFY(!throttle.admit(QtInfoMsg, 1, "x", 0, summaries));
+    QCOMPARE(throttle.rateLimitedCount(), 1ull);
+
+    // 其他位置使用独立的令牌桶
+    QVERIFY(throttle.admit(QtInfoMsg, 2, "x", 0, summaries));
+
+    // 每 100ms 回填一个令牌
+    QVERIFY(!throttle.admit(QtInfoMsg, 1, "x", 50, summaries));
+    QVERIFY(throttle.admit(QtInfoMsg, 1, "x", 100, summaries));
+    QVERIFY(!throttle.admit(QtInfoMsg, 1, "x", 100, summaries));
+
+    // 长时间空闲后最多回填到突发数量
+    for (int i = 0; i < 3; ++i)
+        QVERIFY(throttle.admit(QtInfoMsg, 1, "x", 10000, summaries));
+    QVERIFY(!throttle.admit(QtInfoMsg, 1, "x", 10000, summaries));
+    QCOMPARE(throttle.rateLimitedCount(), 4ull);
+    QVERIFY(summaries.empty());
+}
+
+// 测试 Fatal 日志不受去重与限流影响
+void tst_QCtmLogThrottle::taskFatal()
+{
+    QCtmLogThrottle throttle;
+    throttle.setWindow(1000);
+    throttle.setRate(1);
+    std::vector<QCtmLogThrottle::Summary> summaries;
+    for (int i = 0; i < 5; ++i)
+        QVERIFY(throttle.admit(QtFatalMsg, 1, "a", 0, summaries));
+    QCOMPARE(throttle.suppressedCount(), 0ull);
+    QCOMPARE(throttle.rateLimitedCount(), 0ull);
+}
+
+QTEST_MAIN(tst_QCtmLogThrottle)
+
+#include "tst_QCtmLogThrottle.moc"
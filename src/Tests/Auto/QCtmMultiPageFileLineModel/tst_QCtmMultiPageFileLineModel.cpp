@@ -0,0 +1,57 @@
+﻿#include <QCustomUi/QCtmMultiPageButtonBox.h>
+#include <QCustomUi/QCtmMultiPageFileLineModel.h>
+
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+class tst_QCtmMultiPageFileLineModel : public QObject
+{
+    Q_OBJECT
+private slots:
+    void taskPaging();
+};
+
+// 测试按页解码行内容, 覆盖 "\r\n" 换行、跨越索引检查点的页面与末尾没有换行的行
+void tst_QCtmMultiPageFileLineModel::taskPaging()
+{
+    QTemporaryDir dir;
+    const auto fileName = dir.filePath("lines.csv");
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QFile::WriteOnly));
+        for (int i = 0; i < 1000; i++)
+        {
+            file.write(QString("%1,值%1").arg(i).toUtf8());
+            file.write(i % 2 ? "\r\n" : "\n");
+        }
+        file.write("tail");
+    }
+
+    QCtmMultiPageFileLineModel model;
+    QSignalSpy finished(&model, &QCtmMultiPageFileLineModel::indexingFinished);
+    model.setPageRowCount(30);
+    QVERIFY(model.setFileName(fileName));
+    QCtmMultiPageButtonBox box;
+    box.setModel(&model);
+    QVERIFY(finished.wait());
+
+    QCOMPARE(model.lineCount(), 1001);
+    QCOMPARE(model.pageCount(), 34);
+    QCOMPARE(model.index(0, 0).data().toString(), QString("0,值0"));
+
+    model.setCurrentPage(2); // 第 60..89 行, 跨越第 64 行的检查点
+    QCOMPARE(model.rowCount(), 30);
+    QCOMPARE(model.index(5, 0).data().toString(), QString("65,值65"));
+    QCOMPARE(model.index(29, 0).data().toString(), QString("89,值89"));
+
+    model.setCurrentPage(33);
+    QCOMPARE(model.rowCount(), 11);
+    QCOMPARE(model.index(9, 0).data().toString(), QString("999,值999"));
+    QCOMPARE(model.index(10, 0).data().toString(), QString("tail"));
+    QCOMPARE(model.line(777), QString("777,值777"));
+}
+
+QTEST_MAIN(tst_QCtmMultiPageFileLineModel)
+
+#include "tst_QCtmMultiPageFileLineModel.moc"
@@ -0,0 +1,109 @@
+﻿#include <QCustomUi/QCtmMultiPageStringListModel.h>
+
+#include <QSignalSpy>
+#include <QTest>
+
+class tst_QCtmMultiPageSortFilter : public QObject
+{
+    Q_OBJECT
+private slots:
+    void taskSortFilter();
+    void taskParallelSort();
+    void taskEmptyFilter();
+};
+
+// 测试排序与筛选作用于全部页面, 而不只是当前页
+void tst_QCtmMultiPageSortFilter::taskSortFilter()
+{
+    QStringList strings;
+    for (int i = 0; i < 100; i++)
+    {
+        strings.push_back(QString("Item %1").arg(i, 3, 10, QChar('0')));
+    }
+    QCtmMultiPageStringListModel model(strings);
+    model.setPageRowCount(10);
+    QSignalSpy finished(&model, &QCtmMultiPageStringListModel::sortFinished);
+
+    model.sort(0, Qt::DescendingOrder);
+    QCOMPARE(finished.count(), 1);
+    QCOMPARE(model.currentPage(), 0);
+    QCOMPARE(model.index(0, 0).data().toString(), QString("Item 099"));
+    model.setCurrentPage(9);
+    QCOMPARE(model.index(9, 0).data().toString(), QString("Item 000"));
+
+    model.setFilterRegularExpression(QRegularExpression("5$"));
+    QCOMPARE(model.pageCount(), 1);
+    QCOMPARE(model.rowCount(QModelIndex()), 10);
+    QCOMPARE(model.index(0, 0).data().toString(), QString("Item 095"));
+    QCOMPARE(model.mapToDataRow(9), 5);
+
+    model.sort(-1);
+    QCOMPARE(model.index(0, 0).data().toString(), QString("Item 005"));
+    model.setFilterRegularExpression(QRegularExpression());
+    QCOMPARE(model.pageCount(), 10);
+    QCOMPARE(model.mapToDataRow(3), 3);
+    QVERIFY(!model.isSorting());
+}
+
+// 测试较大数据量时在线程池中并行排序并最终生效
+void tst_QCtmMultiPageSortFilter::taskParallelSort()
+{
+    constexpr int rows = 200000;
+    QStringList strings;
+    strings.reserve(rows);
+    for (int i = 0; i < rows; i++)
+    {
+        strings.push_back(QString::number((i * 7919) % rows).rightJustified(6, QChar('0')));
+    }
+    QCtmMultiPageStringListModel model(std::move(strings));
+    model.setPageRowCount(1000);
+    QSignalSpy finished(&model, &QCtmMultiPageStringListModel::sortFinished);
+
+    model.sort(0);
+    QVERIFY(model.isSorting());
+    QVERIFY(finished.wait(30000));
+    QVERIFY(!model.isSorting());
+    QCOMPARE(model.pageCount(), rows / 1000);
+    for (int page : { 0, 57, 199 })
+    {
+        model.setCurrentPage(page);
+        for (int row = 0; row < 1000; row++)
+        {
+            QCOMPARE(model.index(row, 0).data().toString().toInt(), page * 1000 + row);
+        }
+    }
+
+    model.setFilterRegularExpression(QRegularExpression("^0000"));
+    QVERIFY(finished.wait(30000));
+    QCOMPARE(model.pageCount(), 1);
+    QCOMPARE(model.rowCount(QModelIndex()), 100);
+    QCOMPARE(model.index(99, 0).data().toString(), QString("000099"));
+}
+
+// 测试筛选结果为空时回到第一页, 而不是停留在原来的页面
+void tst_QCtmMultiPageSortFilter::taskEmptyFilter()
+{
+    QStringList strings;
+    for (int i = 0; i < 100; i++)
+    {
+        strings.push_back(QString("Item %1").arg(i));
+    }
+    QCtmMultiPageStringListModel model(strings);
+    model.setPageRowCount(10);
+    model.setCurrentPage(5);
+    QSignalSpy pageChanged(&model, &QCtmMultiPageStringListModel::currentPageChanged);
+
+    model.setFilterRegularExpression(QRegularExpression("nothing"));
+    QCOMPARE(model.pageCount(), 0);
+    QCOMPARE(model.currentPage(), 0);
+    QCOMPARE(model.rowCount(QModelIndex()), 0);
+    QCOMPARE(pageChanged.count(), 1);
+
+    model.setFilterRegularExpression(QRegularExpression());
+    QCOMPARE(model.pageCount(), 10);
+    QCOMPARE(model.index(0, 0).data().toString(), QString("Item 0"));
+}
+
+QTEST_MAIN(tst_QCtmMultiPageSortFilter)
+
+#include "tst_QCtmMultiPageSortFilter.moc"
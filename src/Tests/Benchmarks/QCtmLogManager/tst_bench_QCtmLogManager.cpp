@@ -0,0 +1,100 @@
+﻿#include <QCustomUi/QCtmLogManager.h>
+
+#include <QRegularExpression>
+#include <QTest>
+
+// 仅用于访问受保护的静态解析函数
+struct QCtmLogManagerProbe : public QCtmLogManager
+{
+    using QCtmLogManager::parseObjectNames;
+};
+
+// 旧实现, 作为对比基准
+static QList<QString> parseObjectNamesRegex(QString& msg)
+{
+    QRegularExpression rx("#\\w+\\b");
+    QRegularExpressionMatchIterator i = rx.globalMatch(msg);
+    QStringList list;
+    while (i.hasNext())
+    {
+        auto match      = i.next();
+        const auto& str = match.captured();
+        list << str.right(str.size() - 1);
+    }
+    for (const auto& objName : list)
+    {
+        msg.replace("#" + objName, "");
+    }
+    return list;
+}
+
+class tst_bench_QCtmLogManager : public QObject
+{
+    Q_OBJECT
+private slots:
+    void taskParseResult();
+    void benchParseUntagged();
+    void benchParseUntaggedRegex();
+    void benchParseTagged();
+    void benchParseTaggedRegex();
+};
+
+static const QString untagged = "Device 3 connected on port 5, firmware 1.2.7, status ok, latency 12 ms";
+static const QString tagged   = "#MyLog Device 3 connected on port 5, firmware 1.2.7, status ok #Station_2";
+
+// 测试解析结果与旧实现一致
+void tst_bench_QCtmLogManager::taskParseResult()
+{
+    QString msg      = tagged;
+    QString expected = tagged;
+    QCOMPARE(QCtmLogManagerProbe::parseObjectNames(msg), parseObjectNamesRegex(expected));
+    QCOMPARE(msg, expected);
+
+    msg = untagged;
+    QVERIFY(QCtmLogManagerProbe::parseObjectNames(msg).isEmpty());
+    QVERIFY(msg.isSharedWith(untagged));
+
+    msg = "#a#b # c #";
+    QCOMPARE(QCtmLogManagerProbe::parseObjectNames(msg), (QList<QString> { "a", "b" }));
+    QCOMPARE(msg, QString(" # c #"));
+}
+
+void tst_bench_QCtmLogManager::benchParseUntagged()
+{
+    QBENCHMARK
+    {
+        QString msg = untagged;
+        QCtmLogManagerProbe::parseObjectNames(msg);
+    }
+}
+
+void tst_bench_QCtmLogManager::benchParseUntaggedRegex()
+{
+    QBENCHMARK
+    {
+        QString msg = untagged;
+        parseObjectNamesRegex(msg);
+    }
+}
+
+void tst_bench_QCtmLogManager::benchParseTagged()
+{
+    QBENCHMARK
+    {
+        QString msg = tagged;
+        QCtmLogManagerProbe::parseObjectNames(msg);
+    }
+}
+
+void tst_bench_QCtmLogManager::benchParseTaggedRegex()
+{
+    QBENCHMARK
+    {
+        QString msg = tagged;
+        parseObjectNamesRegex(msg);
+    }
+}
+
+QTEST_MAIN(tst_bench_QCtmLogManager)
+
+#include "tst_bench_QCtmLogManager.moc"
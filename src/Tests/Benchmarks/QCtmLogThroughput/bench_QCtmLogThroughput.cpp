@@ -0,0 +1,289 @@
+﻿#include <QCustomUi/QCtmLogManager.h>
+#include <QCustomUi/QCtmLogModel.h>
+#include <QCustomUi/QCtmLogWidget.h>
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QTimer>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/*
+    日志吞吐量基准.
+    从 1..N 个线程通过 qDebug/qWarning 写日志, 分别测试文件输出开关与 0..M 个 model,
+    第一个 model 由离屏渲染的 QCtmLogWidget 提供. 结果以 JSON 输出, 便于跨版本对比.
+
+    bench_QCtmLogThroughput [--threads N] [--models M] [--messages K] [--async] [--no-widget] [--output file]
+*/
+
+// 统计 GUI 线程处理事件的耗时
+class BenchApplication : public QApplication
+{
+public:
+    using QApplication::QApplication;
+
+    bool notify(QObject* receiver, QEvent* event) override
+    {
+        if (QThread::currentThread() != thread() || m_depth > 0)
+            return QApplication::notify(receiver, event);
+        ++m_depth;
+        QElapsedTimer timer;
+        timer.start();
+        const bool result = QApplication::notify(receiver, event);
+        m_busy += timer.nsecsElapsed();
+        --m_depth;
+        return result;
+    }
+
+    qint64 takeBusy() { return std::exchange(m_busy, 0); }
+
+private:
+    int m_depth { 0 };
+    qint64 m_busy { 0 };
+};
+
+struct Config
+{
+    int threads { 1 };
+    bool file { false };
+    int models { 0 };
+    bool widget { true };
+    bool async { false };
+    int messages { 20000 };
+};
+
+// 控制台输出会掩盖日志系统本身的开销, 基准中丢弃
+static void discardMessage(QtMsgType, const QMessageLogContext&, const QString&) {}
+
+static qint64 directorySize(const QString& path)
+{
+    qint64 size = 0;
+    QDirIterator it(path, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        it.next();
+        size += it.fileInfo().size();
+    }
+    return size;
+}
+
+static qint64 percentile(std::vector<qint64>& samples, double p)
+{
+    if (samples.empty())
+        return 0;
+    const auto n = static_cast<size_t>(p * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + n, samples.end());
+    return samples[n];
+}
+
+static void settle(int msec)
+{
+    QEventLoop loop;
+    QTimer::singleShot(msec, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+static QJsonObject run(BenchApplication& app, const Config& config, const QString& logDir)
+{
+    auto& manager = QCtmLogManager::instance();
+    for (auto type : { QtDebugMsg, QtWarningMsg, QtCriticalMsg, QtInfoMsg })
+    {
+        manager.setLogTypeEnable(type, config.file);
+    }
+
+    // 消息携带所有 model 的标签, 每条消息投递到全部 model
+    std::unique_ptr<QCtmLogWidget> widget;
+    std::vector<std::unique_ptr<QCtmLogModel>> models;
+    QString tags;
+    for (int i = 0; i < config.models; ++i)
+    {
+        const auto name = QString("Bench%1").arg(i);
+        if (i == 0 && config.widget)
+        {
+            widget = std::make_unique<QCtmLogWidget>(name);
+            widget->resize(800, 600);
+            widget->show();
+        }
+        else
+            models.push_back(std::make_unique<QCtmLogModel>(name));
+        tags += '#' + name + ' ';
+    }
+    settle(50);
+
+    const auto droppedBefore = manager.droppedCount();
+    const auto bytesBefore   = directorySize(logDir);
+    std::vector<std::vector<qint64>> latencies(config.threads);
+    std::vector<QThread*> producers;
+    QEventLoop loop;
+    int running = config.threads;
+    for (int t = 0; t < config.threads; ++t)
+    {
+        auto producer = QThread::create(
+            [&, t]()
+            {
+                auto& samples = latencies[t];
+                samples.reserve(config.messages);
+                QElapsedTimer timer;
+                for (int i = 0; i < config.messages; ++i)
+                {
+                    timer.start();
+                    if (i % 10 == 0)
+                        qWarning().noquote() << tags << "producer" << t << "message" << i << "status warning";
+                    else
+                        qDebug().noquote() << tags << "producer" << t << "message" << i << "status ok";
+                    samples.push_back(timer.nsecsElapsed());
+                }
+            });
+        QObject::connect(producer,
+                         &QThread::finished,
+                         &loop,
+                         [&]()
+                         {
+                             if (--running == 0)
+                                 loop.quit();
+                         });
+        producers.push_back(producer);
+    }
+
+    app.takeBusy();
+    QElapsedTimer wall;
+    wall.start();
+    for (auto producer : producers)
+    {
+        producer->start();
+    }
+    loop.exec();
+    const auto produceNs = wall.nsecsElapsed();
+
+    // 等待异步队列、文件缓冲与 model 批量投递完成
+    while (manager.asyncQueueDepth() > 0)
+    {
+        app.processEvents();
+        QThread::msleep(1);
+    }
+    manager.flush();
+    settle(100);
+    const auto totalNs = wall.nsecsElapsed();
+    const auto busyNs  = app.takeBusy();
+
+    std::vector<qint64> samples;
+    for (auto& s : latencies)
+    {
+        samples.insert(samples.end(), s.begin(), s.end());
+    }
+    for (auto producer : producers)
+    {
+        producer->wait();
+        delete producer;
+    }
+
+    const auto total = static_cast<double>(config.threads) * config.messages;
+    QJsonObject result;
+    result["threads"]           = config.threads;
+    result["fileOutput"]        = config.file;
+    result["models"]            = config.models;
+    result["widget"]            = widget != nullptr;
+    result["messages"]          = total;
+    result["produceMs"]         = produceNs / 1e6;
+    result["totalMs"]           = totalNs / 1e6;
+    result["messagesPerSecond"] = total * 1e9 / static_cast<double>(produceNs);
+    result["latencyP50Ns"]      = static_cast<double>(percentile(samples, 0.5));
+    result["latencyP99Ns"]      = static_cast<double>(percentile(samples, 0.99));
+    result["guiMsPerSecond"]    = static_cast<double>(busyNs) * 1e3 / static_cast<double>(totalNs);
+    result["bytesWritten"]      = static_cast<double>(directorySize(logDir) - bytesBefore);
+    result["dropped"]           = static_cast<double>(manager.droppedCount() - droppedBefore);
+    return result;
+}
+
+static QVector<int> steps(int from, int to)
+{
+    QVector<int> list;
+    for (int i = from; i < to; i = i ? i * 2 : 1)
+    {
+        list << i;
+    }
+    list << to;
+    return list;
+}
+
+int main(int argc, char* argv[])
+{
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    qInstallMessageHandler(&discardMessage);
+    QCtmLogManager::initBeforeApp();
+    BenchApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption threadsOption("threads", "Maximum producer threads.", "N", "4");
+    QCommandLineOption modelsOption("models", "Maximum registered models.", "M", "2");
+    QCommandLineOption messagesOption("messages", "Messages per producer thread.", "K", "20000");
+    QCommandLineOption asyncOption("async", "Enable the asynchronous log pipeline.");
+    QCommandLineOption noWidgetOption("no-widget", "Do not attach a QCtmLogWidget to the first model.");
+    QCommandLineOption outputOption("output", "Write the JSON report to file instead of stdout.", "file");
+    parser.addOptions({ threadsOption, modelsOption, messagesOption, asyncOption, noWidgetOption, outputOption });
+    parser.process(app);
+
+    QTemporaryDir logDir;
+    auto& manager = QCtmLogManager::instance();
+    manager.setLogFilePath(logDir.path());
+    manager.setLogCompressionEnabled(false);
+    manager.setAsyncEnabled(parser.isSet(asyncOption));
+
+    Config config;
+    config.async    = parser.isSet(asyncOption);
+    config.widget   = !parser.isSet(noWidgetOption);
+    config.messages = std::max(1, parser.value(messagesOption).toInt());
+
+    QJsonArray results;
+    for (auto threads : steps(1, std::max(1, parser.value(threadsOption).toInt())))
+    {
+        for (auto file : { false, true })
+        {
+            for (auto models : steps(0, std::max(0, parser.value(modelsOption).toInt())))
+            {
+                config.threads = threads;
+                config.file    = file;
+                config.models  = models;
+                results.append(run(app, config, logDir.path()));
+            }
+        }
+    }
+    manager.setAsyncEnabled(false);
+
+    QJsonObject report;
+    report["benchmark"]         = "QCtmLogThroughput";
+    report["qtVersion"]         = qVersion();
+    report["async"]             = config.async;
+    report["messagesPerThread"] = config.messages;
+    report["results"]           = results;
+    const auto json             = QJsonDocument(report).toJson();
+
+    if (parser.isSet(outputOption))
+    {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QFile::WriteOnly | QFile::Truncate))
+            return 1;
+        file.write(json);
+    }
+    else
+    {
+        QFile out;
+        out.open(stdout, QFile::WriteOnly);
+        out.write(json);
+    }
+    return 0;
+}
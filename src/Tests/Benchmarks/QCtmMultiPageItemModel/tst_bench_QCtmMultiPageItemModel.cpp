@@ -0,0 +1,109 @@
+﻿#include <QCustomUi/QCtmAbstractMultiPageTableModel.h>
+#include <QCustomUi/QCtmHeaderView.h>
+
+#include <QSortFilterProxyModel>
+#include <QTableView>
+#include <QTest>
+
+using PageChangeMode = QCtmAbstractMultiPageItemModel::PageChangeMode;
+
+// 统计 data() 调用次数的分页 model, 最后一页不满以覆盖行数变化
+class CountingModel : public QCtmAbstractMultiPageTableModel
+{
+public:
+    explicit CountingModel(int rows) : m_rows(rows) {}
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : std::clamp(m_rows - offset(), 0, pageRowCount());
+    }
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override { return parent.isValid() ? 0 : 8; }
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override
+    {
+        m_calls++;
+        if (role == Qt::DisplayRole || role == Qt::EditRole)
+            return QString("%1:%2").arg(offset() + index.row()).arg(index.column());
+        if (role == Qt::TextAlignmentRole)
+            return int(Qt::AlignCenter);
+        return {};
+    }
+    int pageCount() const override { return m_rows / pageRowCount() + static_cast<bool>(m_rows % pageRowCount()); }
+
+    mutable qint64 m_calls { 0 };
+
+private:
+    int m_rows;
+};
+
+class tst_bench_QCtmMultiPageItemModel : public QObject
+{
+    Q_OBJECT
+private slots:
+    void taskPageContent_data();
+    void taskPageContent();
+    void benchPageSwitch_data();
+    void benchPageSwitch();
+};
+
+static void addModes()
+{
+    QTest::addColumn<PageChangeMode>("mode");
+    QTest::newRow("FullUpdate") << PageChangeMode::FullUpdate;
+    QTest::newRow("BoundedRoles") << PageChangeMode::BoundedRoles;
+    QTest::newRow("Reset") << PageChangeMode::Reset;
+}
+
+void tst_bench_QCtmMultiPageItemModel::taskPageContent_data() { addModes(); }
+
+// 测试各模式下代理 model 在切换页面后得到正确的行数与内容
+void tst_bench_QCtmMultiPageItemModel::taskPageContent()
+{
+    QFETCH(PageChangeMode, mode);
+    CountingModel model(250);
+    model.setPageRowCount(100);
+    model.setPageChangeMode(mode);
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+
+    model.setCurrentPage(2);
+    QCOMPARE(proxy.rowCount(), 50);
+    QCOMPARE(proxy.index(49, 7).data().toString(), QString("249:7"));
+    model.setCurrentPage(1);
+    QCOMPARE(proxy.rowCount(), 100);
+    QCOMPARE(proxy.index(99, 0).data().toString(), QString("199:0"));
+}
+
+void tst_bench_QCtmMultiPageItemModel::benchPageSwitch_data() { addModes(); }
+
+// 代理 model + QCtmHeaderView + 表格视图, 在整页与不满的末页之间来回切换
+void tst_bench_QCtmMultiPageItemModel::benchPageSwitch()
+{
+    QFETCH(PageChangeMode, mode);
+    CountingModel model(100 * 50 + 30);
+    model.setPageRowCount(100);
+    model.setPageChangeMode(mode);
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    QTableView view;
+    view.setHorizontalHeader(new QCtmHeaderView(Qt::Horizontal, &view));
+    view.setModel(&proxy);
+    view.resize(800, 600);
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+    int switches = 0;
+    model.m_calls = 0;
+    QBENCHMARK
+    {
+        for (int page : { 1, 2, 50, 3, 0 })
+        {
+            model.setCurrentPage(page);
+            view.viewport()->repaint();
+            switches++;
+        }
+    }
+    qInfo("%s: %.1f data() calls per page switch", QTest::currentDataTag(), double(model.m_calls) / switches);
+}
+
+QTEST_MAIN(tst_bench_QCtmMultiPageItemModel)
+
+#include "tst_bench_QCtmMultiPageItemModel.moc"